@@ -0,0 +1,144 @@
+#include "tecan_integration/gwlgenerator.h"
+#include "tecan_integration/gwljob.h"
+#include "tecan_integration/gwlwatchservice.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+
+/*
+ * invenesis-gwl — generate the robot worklists for one experiment JSON
+ * (as saved by TecanWindow / Audit/experiment.json) without the GUI.
+ *
+ *   invenesis-gwl experiment.json -o out/ --instrument fluent --batching
+ *   invenesis-gwl --watch inbox/ [-o outbox/] --instrument fluent
+ *
+ * Exit codes: 0 ok, 1 usage / input / generator error (including a run
+ *             that produces no worklist),
+ *             2 validation failed with --strict.
+ */
+
+static bool readExperiment(const QString &path, QJsonObject &out, QString *err)
+{
+    QFile f;
+    bool opened = false;
+    if (path == QLatin1String("-")) opened = f.open(stdin, QIODevice::ReadOnly);
+    else { f.setFileName(path); opened = f.open(QIODevice::ReadOnly); }
+    if (!opened) { *err = QString("Cannot open %1: %2").arg(path, f.errorString()); return false; }
+
+    QJsonParseError pe{};
+    const QJsonDocument doc = QJsonDocument::fromJson(f.readAll(), &pe);
+    if (pe.error != QJsonParseError::NoError || !doc.isObject()) {
+        *err = QString("%1: invalid JSON (%2)").arg(path, pe.errorString());
+        return false;
+    }
+    out = doc.object();
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("invenesis-gwl");
+    QCoreApplication::setOrganizationName("Invenesis");
+    QCoreApplication::setApplicationVersion(APP_VERSION);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generate Tecan GWL worklists from an experiment JSON.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("experiment", "Experiment JSON file ('-' for stdin).");
+
+    const QCommandLineOption outOpt({"o", "output"}, "Output folder.", "dir");
+    const QCommandLineOption instrOpt({"i", "instrument"},
+                                      "fluent | evo (default: _instrument from the JSON, else fluent).", "name");
+    const QCommandLineOption batchOpt("batching", "Parallel 8-channel LiHa pipetting.");
+    const QCommandLineOption mcaOpt("mca", "Stamp whole-plate/column steps with MCA96 or MCA384.", "head");
+    const QCommandLineOption travelOpt("optimise-travel", "Order transfers to minimise arm travel.");
+    const QCommandLineOption strictOpt("strict", "Do not write anything if the simulated run finds problems.");
+    const QCommandLineOption watchOpt("watch", "Service mode: generate every JSON dropped into <inbox>.", "inbox");
+    const QCommandLineOption threadsOpt("threads", "Worker threads in service mode (default: all cores).", "n");
+    parser.addOptions({ outOpt, instrOpt, batchOpt, mcaOpt, travelOpt, strictOpt, watchOpt, threadsOpt });
+
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream errOut(stderr);
+
+    // Command-line flags override what the JSON carries
+    QJsonObject overrides;
+    if (parser.isSet(instrOpt)) {
+        const QString v = parser.value(instrOpt).toLower();
+        overrides["_instrument"] = GWLGenerator::instrumentName(
+            v.startsWith("evo") ? GWLGenerator::Instrument::EVO150
+                                : GWLGenerator::Instrument::FLUENT1080);
+    }
+    if (parser.isSet(batchOpt))  overrides["_channel_batching"] = true;
+    if (parser.isSet(travelOpt)) overrides["_optimise_travel"]  = true;
+    if (parser.isSet(mcaOpt)) {
+        const auto head = GWLGenerator::mcaHeadFromName(parser.value(mcaOpt));
+        if (head == GWLGenerator::McaHead::None) {
+            errOut << "Unknown MCA head: " << parser.value(mcaOpt) << '\n';
+            return 1;
+        }
+        overrides["_mca_head"] = GWLGenerator::mcaHeadName(head);
+    }
+
+    QString err;
+
+    // ---- service mode ----
+    if (parser.isSet(watchOpt)) {
+        GwlWatchService::Config cfg;
+        cfg.inbox      = parser.value(watchOpt);
+        cfg.outbox     = parser.value(outOpt);
+        cfg.maxThreads = parser.value(threadsOpt).toInt();
+        cfg.strict     = parser.isSet(strictOpt);
+        cfg.overrides  = overrides;
+
+        GwlWatchService service(cfg);
+        if (!service.start(&err)) {
+            errOut << err << '\n';
+            return 1;
+        }
+        return app.exec();
+    }
+
+    // ---- single experiment ----
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 1 || !parser.isSet(outOpt)) {
+        errOut << parser.helpText();
+        return 1;
+    }
+
+    QJsonObject exp;
+    if (!readExperiment(args.first(), exp, &err)) {
+        errOut << err << '\n';
+        return 1;
+    }
+    for (auto o = overrides.constBegin(); o != overrides.constEnd(); ++o)
+        exp.insert(o.key(), o.value());
+
+    GwlJob::Result job;
+    if (!GwlJob::run(exp, job, &err)) {
+        errOut << "Generator error: " << err << '\n';
+        return 1;
+    }
+
+    out << job.validation.summary() << '\n'
+        << job.runTime.summary() << '\n';
+    if (!job.validation.ok() && parser.isSet(strictOpt)) {
+        errOut << "Validation failed; nothing written.\n";
+        return 2;
+    }
+
+    const QString outDir = parser.value(outOpt);
+    if (!GWLGenerator::saveMany(outDir, job.outs, &err)) {
+        errOut << "Failed to write files: " << err << '\n';
+        return 1;
+    }
+    out << job.outs.size() << " files written to " << outDir << '\n';
+    return 0;
+}
@@ -0,0 +1,75 @@
+-- 001 — experiments.data as JSONB with generated, indexed metadata columns
+--
+-- Listing and searching experiments only reads the columns below; the
+-- payload (data) is fetched when an experiment is opened.
+-- Safe to run more than once.
+
+BEGIN;
+
+CREATE EXTENSION IF NOT EXISTS pg_trgm;
+
+-- text -> jsonb (no-op when already converted)
+DO $$
+BEGIN
+    IF (SELECT data_type FROM information_schema.columns
+         WHERE table_name = 'experiments' AND column_name = 'data') <> 'jsonb' THEN
+        ALTER TABLE experiments ALTER COLUMN data TYPE jsonb USING data::jsonb;
+    END IF;
+END $$;
+
+-- metadata derived from the payload
+ALTER TABLE experiments
+    ADD COLUMN IF NOT EXISTS created_by text
+        GENERATED ALWAYS AS (data ->> 'user') STORED,
+    ADD COLUMN IF NOT EXISTS compound_names jsonb
+        GENERATED ALWAYS AS (jsonb_path_query_array(data, '$.compounds[*].product_name')) STORED,
+    ADD COLUMN IF NOT EXISTS compound_search text
+        GENERATED ALWAYS AS (lower(jsonb_path_query_array(data, '$.compounds[*].product_name')::text)) STORED;
+
+-- added by an earlier revision of this script, never used
+ALTER TABLE experiments DROP COLUMN IF EXISTS payload_bytes;
+
+-- listing / filtering
+CREATE INDEX IF NOT EXISTS experiments_date_idx
+    ON experiments (date_created DESC, experiment_id DESC);
+CREATE INDEX IF NOT EXISTS experiments_project_idx
+    ON experiments (project_code);
+CREATE INDEX IF NOT EXISTS experiments_created_by_idx
+    ON experiments (created_by);
+CREATE INDEX IF NOT EXISTS experiments_code_trgm_idx
+    ON experiments USING gin (experiment_code gin_trgm_ops);
+CREATE INDEX IF NOT EXISTS experiments_compounds_idx
+    ON experiments USING gin (compound_names jsonb_path_ops);
+CREATE INDEX IF NOT EXISTS experiments_compound_search_idx
+    ON experiments USING gin (compound_search gin_trgm_ops);
+
+-- ON CONFLICT (experiment_code) in the save path relies on this. Older
+-- databases may hold the same code more than once: the newest row keeps it,
+-- the others are renamed to <code>-dup-<experiment_id> and reported.
+DO $$
+DECLARE
+    d record;
+BEGIN
+    FOR d IN
+        SELECT experiment_id, experiment_code
+          FROM (SELECT experiment_id, experiment_code,
+                       row_number() OVER (PARTITION BY experiment_code
+                                          ORDER BY date_created DESC NULLS LAST,
+                                                   experiment_id DESC) AS n
+                  FROM experiments
+                 WHERE experiment_code IS NOT NULL) ranked
+         WHERE n > 1
+    LOOP
+        UPDATE experiments
+           SET experiment_code = d.experiment_code || '-dup-' || d.experiment_id
+         WHERE experiment_id = d.experiment_id;
+        RAISE NOTICE 'duplicate experiment_code %: experiment % renamed to %',
+                     d.experiment_code, d.experiment_id,
+                     d.experiment_code || '-dup-' || d.experiment_id;
+    END LOOP;
+END $$;
+
+CREATE UNIQUE INDEX IF NOT EXISTS experiments_code_key
+    ON experiments (experiment_code);
+
+COMMIT;
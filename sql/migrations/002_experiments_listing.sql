@@ -0,0 +1,18 @@
+-- 002 — indexes for the paged, filtered experiment picker
+--
+-- LoadExperimentDialog pages with a keyset on (date_created, experiment_id)
+-- DESC (index from 001) and filters project / user with ILIKE '%…%', which
+-- needs trigram indexes to avoid a sequential scan.
+-- Safe to run more than once.
+
+BEGIN;
+
+CREATE EXTENSION IF NOT EXISTS pg_trgm;
+
+CREATE INDEX IF NOT EXISTS experiments_project_trgm_idx
+    ON experiments USING gin (project_code gin_trgm_ops);
+
+CREATE INDEX IF NOT EXISTS experiments_created_by_trgm_idx
+    ON experiments USING gin (created_by gin_trgm_ops);
+
+COMMIT;
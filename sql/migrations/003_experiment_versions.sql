@@ -0,0 +1,78 @@
+-- 003 — experiment version history (base snapshots + structural deltas)
+--
+-- experiments.data keeps the latest payload, so opening an experiment is
+-- still one fetch. Every save that changes the content adds a row here:
+-- a full `base` every few versions, otherwise only the `delta` from the
+-- previous version (op list written by JsonDelta, see jsondelta.h).
+-- experiment_version_data() rebuilds any version on the server.
+-- Safe to run more than once.
+
+BEGIN;
+
+CREATE TABLE IF NOT EXISTS experiment_versions (
+    experiment_id integer     NOT NULL REFERENCES experiments (experiment_id) ON DELETE CASCADE,
+    version       integer     NOT NULL,
+    created_at    timestamptz NOT NULL DEFAULT now(),
+    created_by    text,
+    content_hash  text        NOT NULL,     -- JsonHash (ordered arrays), hex
+    since_base    integer     NOT NULL DEFAULT 0,
+    base          jsonb,
+    delta         jsonb,
+    PRIMARY KEY (experiment_id, version),
+    CHECK ((base IS NULL) <> (delta IS NULL))
+);
+
+-- one delta: [{"op":"set"|"del","p":[text,…],"v":…}, …]
+CREATE OR REPLACE FUNCTION experiment_apply_delta(doc jsonb, delta jsonb)
+RETURNS jsonb
+LANGUAGE plpgsql IMMUTABLE AS $$
+DECLARE
+    op jsonb;
+    p  text[];
+BEGIN
+    FOR op IN SELECT value FROM jsonb_array_elements(delta) LOOP
+        p := ARRAY(SELECT jsonb_array_elements_text(op -> 'p'));
+        IF op ->> 'op' = 'del' THEN
+            doc := doc #- p;
+        ELSIF cardinality(p) = 0 THEN
+            doc := op -> 'v';
+        ELSE
+            doc := jsonb_set(doc, p, op -> 'v', true);
+        END IF;
+    END LOOP;
+    RETURN doc;
+END $$;
+
+-- payload of one version: nearest base at or before it, then its deltas
+CREATE OR REPLACE FUNCTION experiment_version_data(eid integer, ver integer)
+RETURNS jsonb
+LANGUAGE plpgsql STABLE AS $$
+DECLARE
+    base_ver integer;
+    doc      jsonb;
+    d        jsonb;
+BEGIN
+    SELECT version, base INTO base_ver, doc
+      FROM experiment_versions
+     WHERE experiment_id = eid AND version <= ver AND base IS NOT NULL
+     ORDER BY version DESC
+     LIMIT 1;
+    IF NOT FOUND THEN
+        RETURN NULL;
+    END IF;
+
+    FOR d IN SELECT delta FROM experiment_versions
+              WHERE experiment_id = eid AND version > base_ver AND version <= ver
+              ORDER BY version LOOP
+        doc := experiment_apply_delta(doc, d);
+    END LOOP;
+    RETURN doc;
+END $$;
+
+-- existing experiments start their history with their current payload
+INSERT INTO experiment_versions (experiment_id, version, created_at, created_by, content_hash, base)
+SELECT e.experiment_id, 1, e.date_created, e.created_by, '', e.data   -- hash unknown: next save stores a base
+  FROM experiments e
+ WHERE NOT EXISTS (SELECT 1 FROM experiment_versions v WHERE v.experiment_id = e.experiment_id);
+
+COMMIT;
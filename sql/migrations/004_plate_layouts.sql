@@ -0,0 +1,42 @@
+-- 004 — plate layout library
+--
+-- Layouts from the plate map dialogs, stored once per content: the key is
+-- a SHA-256 of the canonical packed wells (see platelayoutlibrary.h), so
+-- saving the same layout again under another name finds the existing row.
+-- `data` is the qCompress'd packed form (4 bytes per well before
+-- compression), `thumbnail` a small PNG rendered at save time; the picker
+-- lists metadata and thumbnails only and never decodes `data`.
+-- Safe to run more than once.
+
+BEGIN;
+
+CREATE EXTENSION IF NOT EXISTS pg_trgm;
+
+CREATE TABLE IF NOT EXISTS plate_layouts (
+    layout_id      serial      PRIMARY KEY,
+    content_hash   text        NOT NULL UNIQUE,
+    name           text        NOT NULL,
+    created_by     text,
+    created_at     timestamptz NOT NULL DEFAULT now(),
+    plate_rows     integer     NOT NULL,
+    plate_cols     integer     NOT NULL,
+    sample_count   integer     NOT NULL,    -- distinct sample ids
+    dilution_depth integer     NOT NULL,    -- highest dilution step of any sample well
+    standard_wells integer     NOT NULL,
+    dmso_wells     integer     NOT NULL,
+    used_wells     integer     NOT NULL,
+    data           bytea       NOT NULL,
+    thumbnail      bytea
+);
+
+-- picker: one format, newest first, optional minimum sample count / depth
+CREATE INDEX IF NOT EXISTS plate_layouts_format_idx
+    ON plate_layouts (plate_rows, plate_cols, created_at DESC, layout_id DESC);
+
+CREATE INDEX IF NOT EXISTS plate_layouts_metadata_idx
+    ON plate_layouts (plate_rows, plate_cols, sample_count, dilution_depth);
+
+CREATE INDEX IF NOT EXISTS plate_layouts_name_trgm_idx
+    ON plate_layouts USING gin (name gin_trgm_ops);
+
+COMMIT;
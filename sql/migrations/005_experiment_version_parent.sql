@@ -0,0 +1,62 @@
+-- 005 — deltas name the version they were computed against
+--
+-- A delta is only valid on top of the exact version it was diffed from.
+-- parent_version records that version; ExperimentStore::save only writes a
+-- delta when the caller's version is still the latest, and
+-- experiment_version_data() refuses a chain whose links do not match.
+-- Safe to run more than once.
+
+BEGIN;
+
+ALTER TABLE experiment_versions
+    ADD COLUMN IF NOT EXISTS parent_version integer;
+
+-- deltas written before this column always followed the previous version
+UPDATE experiment_versions
+   SET parent_version = version - 1
+ WHERE delta IS NOT NULL AND parent_version IS NULL;
+
+DO $$
+BEGIN
+    IF NOT EXISTS (SELECT 1 FROM pg_constraint
+                    WHERE conname = 'experiment_versions_delta_parent_check') THEN
+        ALTER TABLE experiment_versions
+            ADD CONSTRAINT experiment_versions_delta_parent_check
+            CHECK (delta IS NULL OR parent_version IS NOT NULL);
+    END IF;
+END $$;
+
+-- as in 003, but every delta must follow the version it names
+CREATE OR REPLACE FUNCTION experiment_version_data(eid integer, ver integer)
+RETURNS jsonb
+LANGUAGE plpgsql STABLE AS $$
+DECLARE
+    base_ver integer;
+    prev     integer;
+    doc      jsonb;
+    d        record;
+BEGIN
+    SELECT version, base INTO base_ver, doc
+      FROM experiment_versions
+     WHERE experiment_id = eid AND version <= ver AND base IS NOT NULL
+     ORDER BY version DESC
+     LIMIT 1;
+    IF NOT FOUND THEN
+        RETURN NULL;
+    END IF;
+
+    prev := base_ver;
+    FOR d IN SELECT version, parent_version, delta FROM experiment_versions
+              WHERE experiment_id = eid AND version > base_ver AND version <= ver
+              ORDER BY version LOOP
+        IF d.parent_version IS DISTINCT FROM prev THEN
+            RAISE EXCEPTION 'experiment % version %: delta is against version %, not %',
+                            eid, d.version, d.parent_version, prev;
+        END IF;
+        doc  := experiment_apply_delta(doc, d.delta);
+        prev := d.version;
+    END LOOP;
+    RETURN doc;
+END $$;
+
+COMMIT;
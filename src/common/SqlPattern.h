@@ -0,0 +1,15 @@
+#ifndef SQLPATTERN_H
+#define SQLPATTERN_H
+
+#include <QString>
+
+// Substring pattern for LIKE/ILIKE: % _ and backslash in `text` are escaped,
+// so user input only ever matches literally
+inline QString likePattern(const QString& text)
+{
+    QString t = text.trimmed();
+    t.replace('\\', "\\\\").replace('%', "\\%").replace('_', "\\_");
+    return '%' + t + '%';
+}
+
+#endif // SQLPATTERN_H
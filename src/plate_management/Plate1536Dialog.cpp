@@ -1,11 +1,10 @@
 #include "Plate1536Dialog.h"
+#include "platelayoutcodec.h"
+#include "PlateMapDialog.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QFileDialog>
 #include <QMessageBox>
-#include <QFile>
-#include <QTextStream>
-#include <QFileInfo>
 #include <QLabel>
 #include <QRadioButton>
 #include <QScrollArea>
@@ -72,16 +71,30 @@ Plate1536Dialog::Plate1536Dialog(QWidget* parent)
     loadBtn   = new QPushButton("Load CSV", this);
     clearBtn  = new QPushButton("Clear", this);
     undoBtn   = new QPushButton("Undo", this);
+    redoBtn   = new QPushButton("Redo", this);
     connect(exportBtn, &QPushButton::clicked, this, &Plate1536Dialog::export1536);
     connect(loadBtn,   &QPushButton::clicked, this, &Plate1536Dialog::load1536);
     connect(clearBtn,  &QPushButton::clicked, plate1536, &PlateWidget::clearLayout);
     connect(undoBtn,   &QPushButton::clicked, plate1536, &PlateWidget::undo);
+    connect(redoBtn,   &QPushButton::clicked, plate1536, &PlateWidget::redo);
+
+    saveLibBtn = new QPushButton("Save to Library", this);
+    openLibBtn = new QPushButton("Library…", this);
+    connect(saveLibBtn, &QPushButton::clicked, this, [this] {
+        PlateMapDialog::saveToLibrary(this, plate1536);
+    });
+    connect(openLibBtn, &QPushButton::clicked, this, [this] {
+        PlateMapDialog::openFromLibrary(this, plate1536);
+    });
 
     auto btnLayout = new QHBoxLayout;
     btnLayout->addWidget(exportBtn);
     btnLayout->addWidget(loadBtn);
     btnLayout->addWidget(clearBtn);
     btnLayout->addWidget(undoBtn);
+    btnLayout->addWidget(redoBtn);
+    btnLayout->addWidget(saveLibBtn);
+    btnLayout->addWidget(openLibBtn);
 
     // --- Assemble main layout ---
     auto mainLayout = new QVBoxLayout;
@@ -108,104 +121,40 @@ void Plate1536Dialog::onDilutionChanged(int step)
     plate1536->setCurrentDilutionStep(step);
 }
 
-void Plate1536Dialog::writeCSV(const QString& defaultName,
-                               PlateWidget* widget,
-                               int totalWells)
+void Plate1536Dialog::writeCSV(const QString& defaultName, PlateWidget* widget)
 {
     QString filePath = QFileDialog::getSaveFileName(
-        this, "Save CSV", defaultName, "CSV Files (*.csv>"
+        this, "Save CSV", defaultName, "CSV Files (*.csv)"
         );
     if (filePath.isEmpty()) return;
 
-    QFile out(filePath);
-    if (!out.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QMessageBox::warning(this, "Error", "Cannot write file");
-        return;
-    }
+    // 1536 layouts keep the legacy two-letter-row format (AA01, SAMPLE,...)
+    PlateLayoutCodec::Layout layout;
+    layout.rows   = widget->rows();
+    layout.cols   = widget->cols();
+    layout.schema = PlateLayoutCodec::Legacy;
+    layout.wells  = widget->layout();
 
-    QTextStream ts(&out);
-    ts << QFileInfo(filePath).fileName()
-       << "," << totalWells
-       << ",user_layout\n";
-
-    const auto layout = widget->layout();
-    int cols = widget->cols();
-    for (int i = 0; i < layout.size(); ++i) {
-        const auto& wd = layout[i];
-        if (wd.type == PlateWidget::None) continue;
-
-        int row = i / cols;
-        int col = i % cols;
-        ts << QString("%1%2")
-                  .arg(QChar('A' + (row / 26)))
-                  .arg(QChar('A' + (row % 26)))
-           << QString("%1").arg(col + 1, 2, 10, QChar('0'))
-           << ",";
-
-        switch (wd.type) {
-        case PlateWidget::Sample:
-            ts << "SAMPLE," << wd.sampleId << "," << wd.dilutionStep;
-            break;
-        case PlateWidget::DMSO:
-            ts << "DMSO";
-            break;
-        case PlateWidget::Standard:
-            ts << "STANDARD";
-            break;
-        default:
-            break;
-        }
-        ts << "\n";
-    }
+    QString err;
+    if (!PlateLayoutCodec::write(filePath, layout, &err))
+        QMessageBox::warning(this, "Error", err);
 }
 
-void Plate1536Dialog::export1536() { writeCSV("layout_1536.csv", plate1536, 1536); }
+void Plate1536Dialog::export1536() { writeCSV("layout_1536.csv", plate1536); }
 
 void Plate1536Dialog::load1536()
 {
     QString file = QFileDialog::getOpenFileName(
-        this, "Open CSV", {}, "CSV Files (*.csv>"
+        this, "Open CSV", {}, "CSV Files (*.csv)"
         );
     if (file.isEmpty()) return;
 
-    QFile in(file);
-    if (!in.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QMessageBox::warning(this, "Error", "Cannot open file");
+    PlateLayoutCodec::Layout layout;
+    QString err;
+    if (!PlateLayoutCodec::read(file, plate1536->rows(), plate1536->cols(), layout, &err)) {
+        QMessageBox::warning(this, "Error", err);
         return;
     }
-
-    QTextStream tsIn(&in);
-    tsIn.readLine();
-
-    int cols = plate1536->cols();
-    int rows = plate1536->rows();
-    QVector<PlateWidget::WellData> data(rows * cols);
-
-    while (!tsIn.atEnd()) {
-        QStringList parts = tsIn.readLine().split(',');
-        if (parts.size() < 2) continue;
-
-        QString rowStr = parts[0].left(2);
-        int first  = rowStr[0].toLatin1() - 'A';
-        int second = rowStr[1].toLatin1() - 'A';
-        int r = first * 26 + second;
-        int c = parts[0].mid(2).toInt() - 1;
-        int idx = r * cols + c;
-        if (idx < 0 || idx >= data.size()) continue;
-
-        PlateWidget::WellData wd;
-        QString t = parts[1].toUpper();
-        if (t == "SAMPLE" && parts.size() >= 4) {
-            wd.type         = PlateWidget::Sample;
-            wd.sampleId     = parts[2].toInt();
-            wd.dilutionStep = parts[3].toInt();
-        } else if (t == "DMSO") {
-            wd.type = PlateWidget::DMSO;
-        } else if (t == "STANDARD") {
-            wd.type = PlateWidget::Standard;
-        }
-        data[idx] = wd;
-    }
-    plate1536->loadLayout(data);
+    plate1536->loadLayout(layout.wells);
 }
 
@@ -25,9 +25,7 @@ private slots:
     void load1536();
 
 private:
-    void writeCSV(const QString& defaultName,
-                  PlateWidget* widget,
-                  int totalWells);
+    void writeCSV(const QString& defaultName, PlateWidget* widget);
 
     PlateWidget*  plate1536;
     QButtonGroup* modeGroup;
@@ -37,6 +35,9 @@ private:
     QPushButton*  loadBtn;
     QPushButton*  clearBtn;
     QPushButton*  undoBtn;
+    QPushButton*  redoBtn;
+    QPushButton*  saveLibBtn;
+    QPushButton*  openLibBtn;
 };
 
 #endif // PLATE1536DIALOG_H
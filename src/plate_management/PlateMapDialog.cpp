@@ -1,25 +1,25 @@
 #include "PlateMapDialog.h"
 #include "Plate1536Dialog.h"
+#include "platelayoutcodec.h"
+#include "platelayoutlibrary.h"
+#include "platelayoutpickerdialog.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QFileDialog>
 #include <QMessageBox>
-#include <QFile>
-#include <QTextStream>
 #include <QFileInfo>
 #include <QLabel>
 #include <QRadioButton>
-#include <QMap>
+#include <QElapsedTimer>
+#include <QDir>
+#include <QInputDialog>
+#include <QSettings>
+#include <QProgressDialog>
+#include <memory>
 
 // ============================ Helpers =====================================
 
-QString PlateMapDialog::toA01(int row1, int col1)
-{
-    const QChar rowCh = QChar('A' + (row1 - 1));
-    return QString("%1%2").arg(rowCh).arg(col1, 2, 10, QChar('0'));
-}
-
 bool PlateMapDialog::parseA01(const QString& a01, int& row1, int& col1)
 {
     if (a01.isEmpty()) return false;
@@ -36,17 +36,6 @@ bool PlateMapDialog::parseA01(const QString& a01, int& row1, int& col1)
     return (row1 >= 1 && col1 >= 1);
 }
 
-QString PlateMapDialog::roleToString(PlateWidget::WellType t)
-{
-    switch (t) {
-    case PlateWidget::Sample:   return "sample";
-    case PlateWidget::Standard: return "standard";
-    case PlateWidget::DMSO:     return "placebo";
-    case PlateWidget::None:
-    default:                    return "Void";
-    }
-}
-
 PlateWidget::WellType PlateMapDialog::roleFromString(const QString& s)
 {
     const QString t = s.trimmed().toLower();
@@ -119,39 +108,63 @@ PlateMapDialog::PlateMapDialog(QWidget* parent)
     load384Btn   = new QPushButton("Load 384 CSV", this);
     clear384Btn  = new QPushButton("Clear 384", this);
     undo384Btn   = new QPushButton("Undo 384", this);
+    redo384Btn   = new QPushButton("Redo 384", this);
     connect(export384Btn, &QPushButton::clicked, this, &PlateMapDialog::export384);
     connect(load384Btn,   &QPushButton::clicked, this, &PlateMapDialog::load384);
     connect(clear384Btn,  &QPushButton::clicked, plate384, &PlateWidget::clearLayout);
     connect(undo384Btn,   &QPushButton::clicked, plate384, &PlateWidget::undo);
+    connect(redo384Btn,   &QPushButton::clicked, plate384, &PlateWidget::redo);
+    save384LibBtn = new QPushButton("Save 384 to Library", this);
+    open384LibBtn = new QPushButton("384 Library…", this);
+    connect(save384LibBtn, &QPushButton::clicked, this, &PlateMapDialog::save384ToLibrary);
+    connect(open384LibBtn, &QPushButton::clicked, this, &PlateMapDialog::open384FromLibrary);
 
     // 96-well buttons
     export96Btn = new QPushButton("Export 96 CSV", this);
     load96Btn   = new QPushButton("Load 96 CSV", this);
     clear96Btn  = new QPushButton("Clear 96", this);
     undo96Btn   = new QPushButton("Undo 96", this);
+    redo96Btn   = new QPushButton("Redo 96", this);
     connect(export96Btn, &QPushButton::clicked, this, &PlateMapDialog::export96);
     connect(load96Btn,   &QPushButton::clicked, this, &PlateMapDialog::load96);
     connect(clear96Btn,  &QPushButton::clicked, plate96,  &PlateWidget::clearLayout);
     connect(undo96Btn,   &QPushButton::clicked, plate96,  &PlateWidget::undo);
+    connect(redo96Btn,   &QPushButton::clicked, plate96,  &PlateWidget::redo);
+    save96LibBtn = new QPushButton("Save 96 to Library", this);
+    open96LibBtn = new QPushButton("96 Library…", this);
+    connect(save96LibBtn, &QPushButton::clicked, this, &PlateMapDialog::save96ToLibrary);
+    connect(open96LibBtn, &QPushButton::clicked, this, &PlateMapDialog::open96FromLibrary);
 
     // 1536-well dialog launcher
     open1536Btn = new QPushButton("1536-well…", this);
     connect(open1536Btn, &QPushButton::clicked,
             this,        &PlateMapDialog::open1536Dialog);
 
+    // Bulk conversion of a layout archive to the current schema
+    convertFolderBtn = new QPushButton("Convert folder…", this);
+    connect(convertFolderBtn, &QPushButton::clicked,
+            this,             &PlateMapDialog::convertFolder);
+
     // Button layout
     auto btnLayout = new QHBoxLayout;
     btnLayout->addWidget(export384Btn);
     btnLayout->addWidget(load384Btn);
     btnLayout->addWidget(clear384Btn);
     btnLayout->addWidget(undo384Btn);
+    btnLayout->addWidget(redo384Btn);
+    btnLayout->addWidget(save384LibBtn);
+    btnLayout->addWidget(open384LibBtn);
     btnLayout->addSpacing(20);
     btnLayout->addWidget(export96Btn);
     btnLayout->addWidget(load96Btn);
     btnLayout->addWidget(clear96Btn);
     btnLayout->addWidget(undo96Btn);
+    btnLayout->addWidget(redo96Btn);
+    btnLayout->addWidget(save96LibBtn);
+    btnLayout->addWidget(open96LibBtn);
     btnLayout->addSpacing(20);
     btnLayout->addWidget(open1536Btn);
+    btnLayout->addWidget(convertFolderBtn);
 
     // Plates layout
     auto platesLayout = new QHBoxLayout;
@@ -189,245 +202,148 @@ void PlateMapDialog::onDilutionChanged(int step)
 }
 
 // ============================ CSV Export ==================================
-// New schema header:
+// Written by PlateLayoutCodec:
 // layoutWell,layoutRow,layoutCol,layoutRole,layoutCompoundInPlate,layoutDilInPlate
 // Always output every well (Void for empty).
 
-void PlateMapDialog::writeCSV(const QString& defaultName,
-                              PlateWidget* widget,
-                              int /*totalWells*/)
+void PlateMapDialog::writeCSV(const QString& defaultName, PlateWidget* widget)
 {
     QString filePath = QFileDialog::getSaveFileName(
         this, "Save CSV", defaultName, "CSV Files (*.csv)");
     if (filePath.isEmpty()) return;
 
-    QFile out(filePath);
-    if (!out.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QMessageBox::warning(this, "Error", "Cannot write file");
-        return;
-    }
+    PlateLayoutCodec::Layout layout;
+    layout.rows   = widget->rows();
+    layout.cols   = widget->cols();
+    layout.schema = PlateLayoutCodec::LayoutColumns;
+    layout.wells  = widget->layout();
 
-    const int rows = widget->rows();
-    const int cols = widget->cols();
-    const auto layout = widget->layout(); // QVector<PlateWidget::WellData>
-
-    QTextStream ts(&out);
-    ts << ";;;;;;\n";
-    ts << "layoutWell,layoutRow,layoutCol,layoutRole,layoutCompoundInPlate,layoutDilInPlate\n";
-
-    for (int r0 = 0; r0 < rows; ++r0) {
-        for (int c0 = 0; c0 < cols; ++c0) {
-            const int idx  = r0 * cols + c0;
-            const int row1 = r0 + 1;
-            const int col1 = c0 + 1;
-
-            PlateWidget::WellData wd; // defaults to None/Void
-            if (idx >= 0 && idx < layout.size()) wd = layout[idx];
-
-            const QString role = roleToString(wd.type);
-
-            QString sampleId, dilStep;
-            switch (wd.type) {
-            case PlateWidget::Sample:
-            case PlateWidget::Standard:   // <-- export Standard like Sample
-                sampleId = QString::number(wd.sampleId);
-                dilStep  = QString::number(wd.dilutionStep);
-                break;
-            case PlateWidget::DMSO:       // 0,0
-            case PlateWidget::None:       // Void -> 0,0
-                sampleId = "0";
-                dilStep  = "0";
-                break;
-            }
-
-            ts << toA01(row1, col1) << ','
-               << row1 << ','
-               << col1 << ','
-               << role << ','
-               << sampleId << ','
-               << dilStep << '\n';
-        }
-    }
+    QString err;
+    if (!PlateLayoutCodec::write(filePath, layout, &err))
+        QMessageBox::warning(this, "Error", err);
 }
 
-
-
-
-void PlateMapDialog::export384() { writeCSV("layout_384.csv", plate384, 384); }
-void PlateMapDialog::export96()  { writeCSV("layout_96.csv",  plate96,   96); }
+void PlateMapDialog::export384() { writeCSV("layout_384.csv", plate384); }
+void PlateMapDialog::export96()  { writeCSV("layout_96.csv",  plate96); }
 
 // ============================ CSV Import ==================================
-//
-// New schema (preferred):
-// layoutWell,layoutRow,layoutCol,layoutRole,layoutCompoundInPlate,layoutDilInPlate
-//
-// Old schema (fallback):
-// <WellToken>,<ROLE>[,<SampleId>,<DilStep>]
-//
-// The loaders try the new schema first; if it doesn't match, they fall back.
-
-namespace {
-QVector<PlateWidget::WellData>
-readPlateCSV_NewSchema(QTextStream& ts, int rows, int cols)
-{
-    QVector<PlateWidget::WellData> data(rows * cols);
-    const QString header = ts.readLine();
-    if (header.isNull()) return {};
-
-    const QStringList headCols = header.split(',', Qt::KeepEmptyParts);
-    QMap<QString,int> h;
-    for (int i=0;i<headCols.size();++i)
-        h[headCols[i].trimmed().toLower()] = i;
-
-    const bool hasNew =
-        h.contains("layoutwell") &&
-        h.contains("layoutrow") &&
-        h.contains("layoutcol") &&
-        h.contains("layoutrole");
-    if (!hasNew) return {};
-
-    auto colAt = [&](const QString& key, const QStringList& parts)->QString {
-        int ci = h.value(key, -1);
-        return (ci >= 0 && ci < parts.size()) ? parts[ci] : QString();
-    };
-
-    while (!ts.atEnd()) {
-        const QString line = ts.readLine().trimmed();
-        if (line.isEmpty()) continue;
-
-        const QStringList parts = line.split(',', Qt::KeepEmptyParts);
-
-        int row1 = colAt("layoutrow", parts).toInt();
-        int col1 = colAt("layoutcol", parts).toInt();
-        if (row1 <= 0 || col1 <= 0) {
-            int r=0,c=0;
-            PlateMapDialog::parseA01(colAt("layoutwell", parts), r, c);
-            row1 = r; col1 = c;
-        }
-        const int r0 = row1 - 1, c0 = col1 - 1;
-        if (r0 < 0 || r0 >= rows || c0 < 0 || c0 >= cols) continue;
-
-        PlateWidget::WellData wd;
-        wd.type = PlateMapDialog::roleFromString(colAt("layoutrole", parts));
-
-        if (wd.type == PlateWidget::Sample || wd.type == PlateWidget::Standard) {
-            wd.sampleId     = colAt("layoutcompoundinplate", parts).toInt();
-            wd.dilutionStep = colAt("layoutdilinplate", parts).toInt();
-        } else if (wd.type == PlateWidget::DMSO || wd.type == PlateWidget::None) {
-            // Enforce zeros for DMSO/Void
-            wd.sampleId     = 0;
-            wd.dilutionStep = 0;
-        }
-
-        data[r0 * cols + c0] = wd;
-    }
-    return data;
-}
-}
-
-
+// PlateLayoutCodec detects the current or the old
+// (<WellToken>,<ROLE>[,<SampleId>,<DilStep>]) schema from the first lines.
 
-// Old schema fallback (caller must have already skipped the old header)
-QVector<PlateWidget::WellData>
-readPlateCSV_OldSchema(QTextStream& ts, int rows, int cols)
-{
-    QVector<PlateWidget::WellData> data(rows * cols);
-    while (!ts.atEnd()) {
-        const QString line = ts.readLine().trimmed();
-        if (line.isEmpty()) continue;
-
-        const QStringList parts = line.split(',', Qt::KeepEmptyParts);
-        if (parts.size() < 2) continue;
-
-        // parts[0] like "A1" or "A01"
-        QString wellTok = parts[0].trimmed();
-        if (wellTok.size() == 2 && wellTok[1].isDigit()) {
-            // normalize A1 -> A01
-            wellTok = wellTok[0] + QString("%1").arg(wellTok.mid(1).toInt(), 2, 10, QChar('0'));
-        }
-
-        int row1=0, col1=0;
-        if (!PlateMapDialog::parseA01(wellTok, row1, col1)) continue;
-        const int r0 = row1 - 1, c0 = col1 - 1;
-        if (r0 < 0 || r0 >= rows || c0 < 0 || c0 >= cols) continue;
-
-        PlateWidget::WellData wd;
-        const QString t = parts[1].trimmed().toUpper();
-        if (t == "SAMPLE" && parts.size() >= 4) {
-            wd.type         = PlateWidget::Sample;
-            wd.sampleId     = parts[2].toInt();
-            wd.dilutionStep = parts[3].toInt();
-        } else if (t == "DMSO") {
-            wd.type = PlateWidget::DMSO;
-        } else if (t == "STANDARD") {
-            wd.type = PlateWidget::Standard;
-        } else {
-            wd.type = PlateWidget::None;
-        }
-
-        data[r0 * cols + c0] = wd;
-    }
-    return data;
-}
- // anonymous namespace
-
-void PlateMapDialog::load384()
+void PlateMapDialog::loadCSV(PlateWidget* widget)
 {
     QString file = QFileDialog::getOpenFileName(
         this, "Open CSV", {}, "CSV Files (*.csv)");
     if (file.isEmpty()) return;
 
-    QFile in(file);
-    if (!in.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QMessageBox::warning(this, "Error", "Cannot open file");
+    PlateLayoutCodec::Layout layout;
+    QString err;
+    if (!PlateLayoutCodec::read(file, widget->rows(), widget->cols(), layout, &err)) {
+        QMessageBox::warning(this, "Error", err);
         return;
     }
+    widget->loadLayout(layout.wells);
+}
 
-    QTextStream ts(&in);
-    const qint64 pos0 = in.pos();
-
-    QVector<PlateWidget::WellData> data =
-        readPlateCSV_NewSchema(ts, plate384->rows(), plate384->cols());
+void PlateMapDialog::load384() { loadCSV(plate384); }
+void PlateMapDialog::load96()  { loadCSV(plate96); }
 
-    if (data.isEmpty()) {
-        // Fallback to old schema: rewind and skip the old header line
-        in.seek(pos0);
-        ts.seek(0);
-        ts.readLine(); // skip old header line "<file>,<n>,user_layout"
-        data = readPlateCSV_OldSchema(ts, plate384->rows(), plate384->cols());
+void PlateMapDialog::convertFolder()
+{
+    const QString src = QFileDialog::getExistingDirectory(
+        this, "Folder with layout CSV files");
+    if (src.isEmpty()) return;
+    const QString dst = QFileDialog::getExistingDirectory(
+        this, "Write converted layouts to", src);
+    if (dst.isEmpty()) return;
+    if (QDir(src) == QDir(dst)) {
+        QMessageBox::warning(this, "Convert Folder",
+                             "Please choose a different output folder.");
+        return;
     }
 
-    plate384->loadLayout(data);
+    // parsed in the background; the dialog follows each file as it finishes
+    auto* import   = new PlateLayoutFolderImport(this);
+    auto* progress = new QProgressDialog("Converting layouts…", "Cancel", 0, 0, this);
+    progress->setWindowTitle("Convert Folder");
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setMinimumDuration(0);
+    progress->setAutoClose(false);
+    progress->setAutoReset(false);
+
+    auto timer  = std::make_shared<QElapsedTimer>();
+    auto failed = std::make_shared<QStringList>();
+    timer->start();
+
+    connect(progress, &QProgressDialog::canceled, import, &PlateLayoutFolderImport::cancel);
+    connect(import, &PlateLayoutFolderImport::fileFinished, progress,
+            [progress, failed](int done, int total, const PlateLayoutFolderImport::Result& r) {
+        progress->setMaximum(total);
+        progress->setValue(done);
+        progress->setLabelText(QString("%1 of %2: %3").arg(done).arg(total)
+                                   .arg(QFileInfo(r.path).fileName()));
+        if (!r.ok && failed->size() < 10)
+            *failed << QString("%1: %2").arg(QFileInfo(r.path).fileName(), r.error);
+    });
+    connect(import, &PlateLayoutFolderImport::finished, this,
+            [this, import, progress, timer, failed](int succeeded, int total) {
+        progress->deleteLater();
+        import->deleteLater();
+
+        QString msg = QString("%1 of %2 layout(s) converted in %3 s.")
+                          .arg(succeeded).arg(total)
+                          .arg(timer->elapsed() / 1000.0, 0, 'f', 1);
+        if (!failed->isEmpty())
+            msg += "\n\n" + failed->join('\n');
+        QMessageBox::information(this, "Convert Folder", msg);
+    });
+
+    progress->show();
+    import->start(src, 0, 0, dst);
 }
 
-void PlateMapDialog::load96()
-{
-    QString file = QFileDialog::getOpenFileName(
-        this, "Open CSV", {}, "CSV Files (*.csv)");
-    if (file.isEmpty()) return;
+// ============================ Layout Library ==============================
 
-    QFile in(file);
-    if (!in.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QMessageBox::warning(this, "Error", "Cannot open file");
-        return;
+bool PlateMapDialog::saveToLibrary(QWidget* parent, PlateWidget* widget)
+{
+    if (widget->wellCount(PlateWidget::None) == widget->rows() * widget->cols()) {
+        QMessageBox::information(parent, "Save to Library", "The plate is empty.");
+        return false;
     }
 
-    QTextStream ts(&in);
-    const qint64 pos0 = in.pos();
-
-    QVector<PlateWidget::WellData> data =
-        readPlateCSV_NewSchema(ts, plate96->rows(), plate96->cols());
-
-    if (data.isEmpty()) {
-        in.seek(pos0);
-        ts.seek(0);
-        ts.readLine(); // skip old header line
-        data = readPlateCSV_OldSchema(ts, plate96->rows(), plate96->cols());
+    bool ok = false;
+    const QString name = QInputDialog::getText(
+        parent, "Save to Library", "Layout name:", QLineEdit::Normal, QString(), &ok);
+    if (!ok || name.trimmed().isEmpty()) return false;
+
+    const QString user = QSettings("Invenesis", "DatabaseApp").value("lastUsername").toString();
+    PlateLayoutLibrary::SaveResult res;
+    QString err;
+    if (!PlateLayoutLibrary::save(name, user, widget->rows(), widget->cols(),
+                                  widget->layout(), &res, &err)) {
+        QMessageBox::warning(parent, "Error", err);
+        return false;
     }
+    if (res.existed)
+        QMessageBox::information(parent, "Save to Library",
+                                 QString("This layout is already in the library as \"%1\".")
+                                     .arg(res.existingName));
+    return true;
+}
 
-    plate96->loadLayout(data);
+bool PlateMapDialog::openFromLibrary(QWidget* parent, PlateWidget* widget)
+{
+    PlateLayoutPickerDialog picker(widget->rows(), widget->cols(), parent);
+    if (picker.exec() != QDialog::Accepted) return false;
+    widget->loadLayout(picker.selectedLayout());
+    return true;
 }
 
+void PlateMapDialog::save384ToLibrary()   { saveToLibrary(this, plate384); }
+void PlateMapDialog::save96ToLibrary()    { saveToLibrary(this, plate96); }
+void PlateMapDialog::open384FromLibrary() { openFromLibrary(this, plate384); }
+void PlateMapDialog::open96FromLibrary()  { openFromLibrary(this, plate96); }
+
 void PlateMapDialog::open1536Dialog()
 {
     Plate1536Dialog dlg(this);
@@ -19,6 +19,10 @@ public:
     static bool parseA01(const QString& a01, int& row1, int& col1);  // from "A01" -> (1,1)
     static PlateWidget::WellType roleFromString(const QString& s);
 
+    // Layout library actions shared with Plate1536Dialog; false if cancelled or failed
+    static bool saveToLibrary(QWidget* parent, PlateWidget* widget);
+    static bool openFromLibrary(QWidget* parent, PlateWidget* widget);
+
 private slots:
     void onSelectionChanged(int id);
     void onSampleChanged(int index);
@@ -29,17 +33,15 @@ private slots:
     void export96();
     void load96();
     void open1536Dialog();
+    void convertFolder();
+    void save384ToLibrary();
+    void open384FromLibrary();
+    void save96ToLibrary();
+    void open96FromLibrary();
 
 private:
-    void writeCSV(const QString& defaultName,
-                  PlateWidget* widget,
-                  int totalWells);
-
-    // Helpers for CSV formatting/parsing
-    static QString toA01(int row1Based, int col1Based);                 // "A01".."P24" etc.
-
-    static QString roleToString(PlateWidget::WellType t);               // Sample/Standard/DMSO/Void
-
+    void writeCSV(const QString& defaultName, PlateWidget* widget);
+    void loadCSV(PlateWidget* widget);
 
 private:
     PlateWidget* plate384;
@@ -53,13 +55,20 @@ private:
     QPushButton* load384Btn;
     QPushButton* clear384Btn;
     QPushButton* undo384Btn;
+    QPushButton* redo384Btn;
+    QPushButton* save384LibBtn;
+    QPushButton* open384LibBtn;
 
     QPushButton* export96Btn;
     QPushButton* load96Btn;
     QPushButton* clear96Btn;
     QPushButton* undo96Btn;
+    QPushButton* redo96Btn;
+    QPushButton* save96LibBtn;
+    QPushButton* open96LibBtn;
 
     QPushButton* open1536Btn;
+    QPushButton* convertFolderBtn;
 };
 
 #endif // PLATEMAPDIALOG_H
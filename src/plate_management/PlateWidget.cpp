@@ -3,52 +3,185 @@
 #include <QMouseEvent>
 #include <QMessageBox>
 #include <QRubberBand>
+#include <QPaintEvent>
+#include <QWheelEvent>
+#include <QKeyEvent>
+#include <QFontMetrics>
 #include <QDebug>
 
 PlateWidget::PlateWidget(int rows, int cols, QWidget* parent)
     : QWidget(parent)
     , m_rows(rows)
     , m_cols(cols)
-    , m_cellSize(30)
+    , m_cellSize(0)
     , m_labelMargin(20)
-    , m_layout(rows * cols)
+    , m_wells(rows * cols, pack(WellData()))
+    , m_occupied(rows * cols)
     , m_currentType(None)
     , m_currentSample(1)
     , m_currentDilutionStep(1)
     , m_rubberBand(new QRubberBand(QRubberBand::Rectangle, this))
     , m_selecting(false)
     , m_serialSelecting(false)
+    , m_drawText(true)
 {
+    for (WellMask& m : m_typeMask)
+        m = WellMask(rows * cols);
+    m_typeMask[None].setRange(0, rows * cols);
+
     setFocusPolicy(Qt::StrongFocus);
     setAttribute(Qt::WA_Hover);
+    setCellSize(30);
+    setMouseTracking(true);
+}
+
+void PlateWidget::setCellSize(int px)
+{
+    px = qBound(kMinCellPx, px, kMaxCellPx);
+    if (px == m_cellSize)
+        return;
+    m_cellSize = px;
+
+    // level of detail: text only where two lines of it fit
+    m_wellFont = font();
+    m_wellFont.setPointSize(qMax(6, m_cellSize / 5));
+    m_drawText = m_cellSize >= kMinTextCellPx
+                 && 2 * QFontMetrics(m_wellFont).height() <= m_cellSize - 2;
+
+    m_staticLayer = QPixmap();
     setMinimumSize(
         m_labelMargin + m_cols * m_cellSize + 1,
         m_labelMargin + m_rows * m_cellSize + 1
         );
-    setMouseTracking(true);
+    update();
 }
 
-void PlateWidget::saveState()
+PlateWidget::PackedWell PlateWidget::pack(const WellData& wd)
 {
-    m_undoStack.push(m_layout);
-    if (m_undoStack.size() > 50)
-        m_undoStack.remove(0);
+    if (wd.type != Sample && wd.type != Standard)
+        return PackedWell(wd.type & 0x3);           // DMSO/None are always 0,0
+    return PackedWell(wd.type)
+         | PackedWell(qBound(0, wd.dilutionStep, 0xFF)) << 2
+         | PackedWell(qBound(0, wd.sampleId, 0x3FFFFF)) << 10;
 }
 
-void PlateWidget::undo()
+PlateWidget::WellData PlateWidget::unpack(PackedWell v)
+{
+    return WellData{ typeOf(v), int(v >> 10), int((v >> 2) & 0xFF) };
+}
+
+void PlateWidget::writeWell(int idx, PackedWell v)
 {
-    if (m_undoStack.isEmpty())
+    const WellType was = typeOf(m_wells[idx]);
+    const WellType now = typeOf(v);
+    m_wells[idx] = v;
+    if (was == now)
         return;
-    m_layout = m_undoStack.pop();
-    update();
+    m_typeMask[was].reset(idx);
+    m_typeMask[now].set(idx);
+    if (now == None)
+        m_occupied.reset(idx);
+    else
+        m_occupied.set(idx);
+}
+
+void PlateWidget::beginEdit()
+{
+    if (m_recording)
+        endEdit();          // a release we never saw (e.g. a modal warning mid-drag)
+    m_recording = true;
+}
+
+void PlateWidget::setWell(int idx, const WellData& wd)
+{
+    const PackedWell cur = m_wells[idx];
+    const PackedWell next = pack(wd);
+    if (cur == next)
+        return;
+    if (!m_recording)
+        beginEdit();
+
+    auto it = m_pendingIndex.constFind(idx);
+    if (it == m_pendingIndex.cend()) {
+        m_pendingIndex.insert(idx, int(m_pending.changes.size()));
+        m_pending.changes.append(WellChange{ idx, cur, next });
+    } else {
+        m_pending.changes[*it].after = next;    // the drag came back over this well
+    }
+    writeWell(idx, next);
+}
+
+void PlateWidget::endEdit()
+{
+    if (!m_recording)
+        return;
+    m_recording = false;
+
+    Edit edit;
+    for (const WellChange& ch : std::as_const(m_pending.changes))
+        if (ch.before != ch.after)
+            edit.changes.append(ch);
+    edit.changes.squeeze();
+    m_pending.changes.clear();
+    m_pendingIndex.clear();
+    if (edit.changes.isEmpty())
+        return;
+
+    for (const Edit& e : m_redoStack)
+        m_historyBytes -= e.bytes();
+    m_redoStack.clear();
+
+    m_historyBytes += edit.bytes();
+    m_undoStack.push_back(std::move(edit));
+
+    // Oldest edits go first; the newest is kept even if it alone is over budget
+    while (m_historyBytes > kHistoryBudgetBytes && m_undoStack.size() > 1) {
+        m_historyBytes -= m_undoStack.front().bytes();
+        m_undoStack.pop_front();
+    }
+}
+
+void PlateWidget::applyEdit(const Edit& edit, bool forward)
+{
+    QRect changed;
+    const int n = int(edit.changes.size());
+    for (int i = 0; i < n; ++i) {
+        const WellChange& ch = edit.changes[forward ? i : n - 1 - i];
+        writeWell(ch.index, forward ? ch.after : ch.before);
+        changed |= QRect(ch.index % m_cols, ch.index / m_cols, 1, 1);
+    }
+    updateCells(changed);
     emit layoutChanged();
 }
 
+void PlateWidget::undo()
+{
+    endEdit();
+    if (m_undoStack.empty())
+        return;
+    Edit edit = std::move(m_undoStack.back());
+    m_undoStack.pop_back();
+    applyEdit(edit, false);
+    m_redoStack.push_back(std::move(edit));
+}
+
+void PlateWidget::redo()
+{
+    endEdit();
+    if (m_redoStack.empty())
+        return;
+    Edit edit = std::move(m_redoStack.back());
+    m_redoStack.pop_back();
+    applyEdit(edit, true);
+    m_undoStack.push_back(std::move(edit));
+}
+
 void PlateWidget::clearLayout()
 {
-    saveState();
-    for (auto &wd : m_layout)
-        wd = WellData(); // default: None, id=0, dil=0
+    beginEdit();
+    const WellMask occupied = m_occupied;
+    occupied.forEach([this](int i) { setWell(i, WellData()); }); // default: None
+    endEdit();
     update();
     emit layoutChanged();
 }
@@ -57,15 +190,21 @@ void PlateWidget::loadLayout(const QVector<WellData> &layout)
 {
     if (layout.size() != m_rows * m_cols)
         return;
-    saveState();
-    m_layout = layout;
+    beginEdit();
+    for (int i = 0; i < layout.size(); ++i)
+        setWell(i, layout[i]);
+    endEdit();
     update();
     emit layoutChanged();
 }
 
 QVector<PlateWidget::WellData> PlateWidget::layout() const
 {
-    return m_layout;
+    QVector<WellData> out;
+    out.reserve(m_wells.size());
+    for (PackedWell v : m_wells)
+        out.append(unpack(v));
+    return out;
 }
 
 void PlateWidget::setCurrentWellType(PlateWidget::WellType type)
@@ -90,25 +229,49 @@ QRect PlateWidget::cellRect(int row, int col) const
     return QRect(x + 1, y + 1, m_cellSize - 2, m_cellSize - 2);
 }
 
-QColor PlateWidget::sampleColor(int sampleId, int dilutionStep) const
+QColor PlateWidget::wellColor(const WellData& wd, int cols)
 {
-    // Unique-ish hue per sample ID
-    int hue = (sampleId * 137) % 360;
-    int sat = 200;
-    const int dark = 55;
-    const int bright = 255;
-    int val = dark + ((dilutionStep - 1) * (bright - dark)) / qMax(1, (m_cols - 1));
-    val = qBound(dark, val, bright);
-    return QColor::fromHsv(hue, sat, val);
+    switch (wd.type) {
+    case Sample: {
+        // Unique-ish hue per sample ID, darker for earlier dilution steps
+        int hue = (wd.sampleId * 137) % 360;
+        int sat = 200;
+        const int dark = 55;
+        const int bright = 255;
+        int val = dark + ((wd.dilutionStep - 1) * (bright - dark)) / qMax(1, (cols - 1));
+        val = qBound(dark, val, bright);
+        return QColor::fromHsv(hue, sat, val);
+    }
+    case DMSO:
+        return QColor(152, 251, 152); // pale green
+    case Standard:
+        return Qt::red;
+    case None:
+    default:
+        return Qt::white;
+    }
 }
 
-void PlateWidget::paintEvent(QPaintEvent*)
+void PlateWidget::rebuildStaticLayer()
 {
-    QPainter p(this);
-    p.setRenderHint(QPainter::Antialiasing);
-
-    // Draw row labels (single-letter for ≤26 rows, else two-letter)
-    for (int r = 0; r < m_rows; ++r) {
+    const qreal dpr = devicePixelRatioF();
+    const QSize size(m_labelMargin + m_cols * m_cellSize + 1,
+                     m_labelMargin + m_rows * m_cellSize + 1);
+    m_staticLayer = QPixmap(size * dpr);
+    m_staticLayer.setDevicePixelRatio(dpr);
+    m_staticLayer.fill(palette().color(backgroundRole()));
+
+    QPainter p(&m_staticLayer);
+    p.setFont(font());
+    p.setPen(palette().color(foregroundRole()));
+
+    // Labels that do not fit in one cell are drawn every n-th row/column
+    const QFontMetrics fm(font());
+    const int colStride = qMax(1, (fm.horizontalAdvance(QStringLiteral("00")) + 4 + m_cellSize - 1) / m_cellSize);
+    const int rowStride = qMax(1, (fm.height() + m_cellSize - 1) / m_cellSize);
+
+    // Row labels (single-letter for ≤26 rows, else two-letter)
+    for (int r = 0; r < m_rows; r += rowStride) {
         QString rowLabel;
         if (m_rows <= 26) {
             rowLabel = QChar('A' + r);
@@ -126,59 +289,125 @@ void PlateWidget::paintEvent(QPaintEvent*)
         p.drawText(lr, Qt::AlignCenter, rowLabel);
     }
 
-    // Draw column labels (zero-padded if >9)
-    for (int c = 0; c < m_cols; ++c) {
+    // Column labels (zero-padded if >9)
+    for (int c = 0; c < m_cols; c += colStride) {
         QString colLabel = (m_cols > 9)
         ? QString("%1").arg(c + 1, 2, 10, QChar('0'))
         : QString::number(c + 1);
 
-        QRect lc(m_labelMargin + c * m_cellSize,
+        QRect lc(m_labelMargin + c * m_cellSize - (colStride > 1 ? m_cellSize : 0),
                  0,
-                 m_cellSize,
+                 m_cellSize * (colStride > 1 ? 3 : 1),
                  m_labelMargin);
         p.drawText(lc, Qt::AlignCenter, colLabel);
     }
 
-    // Draw wells
+    // Empty wells; filled ones are painted over this in paintEvent
+    p.setPen(Qt::black);
     for (int r = 0; r < m_rows; ++r) {
         for (int c = 0; c < m_cols; ++c) {
-            int idx = r * m_cols + c;
             QRect rect = cellRect(r, c);
-            const WellData &wd = m_layout[idx];
-
-            QColor fill = Qt::white;
-            switch (wd.type) {
-            case Sample:
-                fill = sampleColor(wd.sampleId, wd.dilutionStep);
-                break;
-            case DMSO:
-                fill = QColor(152, 251, 152); // pale green
-                break;
-            case Standard:
-                fill = Qt::red;
-                break;
-            case None:
-            default:
-                break;
-            }
-            p.fillRect(rect, fill);
-            p.setPen(Qt::black);
+            p.fillRect(rect, Qt::white);
             p.drawRect(rect);
+        }
+    }
+}
 
-            // Text for Sample and Standard (now both render ID & dilution)
-            if (wd.type == Sample || wd.type == Standard) {
-                QFont f = p.font();
-                f.setPointSize(qMax(6, m_cellSize / 5));
-                p.setFont(f);
-                const QString prefix = (wd.type == Sample) ? "S" : "Std";
-                p.drawText(rect, Qt::AlignCenter,
-                           QString("%1%2\n%3").arg(prefix).arg(wd.sampleId).arg(wd.dilutionStep));
-            }
-            // DMSO/None: no text (id/dil are 0,0 by definition)
+void PlateWidget::paintWell(QPainter& p, int idx) const
+{
+    const WellData wd = unpack(m_wells[idx]);
+    const QRect rect = cellRect(idx / m_cols, idx % m_cols);
+
+    p.fillRect(rect, wellColor(wd, m_cols));
+    p.setPen(Qt::black);
+    p.drawRect(rect);
+
+    // Text for Sample and Standard (both render ID & dilution), if it fits
+    if (m_drawText && (wd.type == Sample || wd.type == Standard)) {
+        const QString prefix = (wd.type == Sample) ? "S" : "Std";
+        p.drawText(rect, Qt::AlignCenter,
+                   QString("%1%2\n%3").arg(prefix).arg(wd.sampleId).arg(wd.dilutionStep));
+    }
+    // DMSO/None: no text (id/dil are 0,0 by definition)
+}
+
+void PlateWidget::paintEvent(QPaintEvent* event)
+{
+    QPainter p(this);
+    if (m_staticLayer.isNull() || m_staticLayer.devicePixelRatio() != devicePixelRatioF())
+        rebuildStaticLayer();
+
+    // Static layer for the dirty area only
+    const qreal dpr = m_staticLayer.devicePixelRatio();
+    const QRect dirty = event->rect() & QRect(0, 0,
+                                              m_labelMargin + m_cols * m_cellSize + 1,
+                                              m_labelMargin + m_rows * m_cellSize + 1);
+    if (dirty.isEmpty())
+        return;
+    p.drawPixmap(dirty.topLeft(), m_staticLayer,
+                 QRectF(QPointF(dirty.topLeft()) * dpr, QSizeF(dirty.size()) * dpr));
+
+    // Non-empty wells that intersect it
+    if (dirty.right() < m_labelMargin || dirty.bottom() < m_labelMargin)
+        return;
+    const int c0 = qMax(0, (dirty.left() - m_labelMargin) / m_cellSize);
+    const int r0 = qMax(0, (dirty.top()  - m_labelMargin) / m_cellSize);
+    const int c1 = qMin(m_cols - 1, (dirty.right()  - m_labelMargin) / m_cellSize);
+    const int r1 = qMin(m_rows - 1, (dirty.bottom() - m_labelMargin) / m_cellSize);
+
+    p.setFont(m_wellFont);
+    for (int r = r0; r <= r1; ++r) {
+        for (int c = c0; c <= c1; ++c) {
+            int idx = r * m_cols + c;
+            if (m_occupied.test(idx))
+                paintWell(p, idx);
         }
     }
 }
 
+void PlateWidget::updateCells(const QRect& cells)
+{
+    if (cells.isEmpty())
+        return;
+    update(m_labelMargin + cells.left() * m_cellSize,
+           m_labelMargin + cells.top()  * m_cellSize,
+           cells.width()  * m_cellSize + 1,
+           cells.height() * m_cellSize + 1);
+}
+
+void PlateWidget::wheelEvent(QWheelEvent* event)
+{
+    if (!(event->modifiers() & Qt::ControlModifier)) {
+        QWidget::wheelEvent(event);     // let the scroll area scroll
+        return;
+    }
+    const int delta = event->angleDelta().y();
+    if (delta != 0)
+        setCellSize(m_cellSize + (delta > 0 ? 2 : -2));
+    event->accept();
+}
+
+void PlateWidget::changeEvent(QEvent* event)
+{
+    if (event->type() == QEvent::FontChange || event->type() == QEvent::PaletteChange) {
+        m_staticLayer = QPixmap();
+        const int px = m_cellSize;
+        m_cellSize = 0;
+        setCellSize(px);                // re-derive the well font and text LOD
+    }
+    QWidget::changeEvent(event);
+}
+
+void PlateWidget::keyPressEvent(QKeyEvent* event)
+{
+    if (event->matches(QKeySequence::Undo))
+        undo();
+    else if (event->matches(QKeySequence::Redo))
+        redo();
+    else
+        QWidget::keyPressEvent(event);
+}
+
 void PlateWidget::mousePressEvent(QMouseEvent* event)
 {
     Qt::KeyboardModifiers mods = event->modifiers();
@@ -190,7 +419,7 @@ void PlateWidget::mousePressEvent(QMouseEvent* event)
     //    If you want this for Standard too, change the condition below to:
     //    (m_currentType == Sample || m_currentType == Standard)
     if (shift && ctrl && (m_currentType == Sample || m_currentType == Standard)) {
-        saveState();
+        beginEdit();
         m_serialSelecting = true;
         m_selecting = false;
         m_dragStart = event->pos();
@@ -199,7 +428,7 @@ void PlateWidget::mousePressEvent(QMouseEvent* event)
     }
     // 2) Normal rectangle selection: Shift in any non-None mode
     else if (shift && m_currentType != None) {
-        saveState();
+        beginEdit();
         m_selecting = true;
         m_serialSelecting = false;
         m_dragStart = event->pos();
@@ -208,7 +437,7 @@ void PlateWidget::mousePressEvent(QMouseEvent* event)
     }
     // 3) Single-well click (all modes)
     else {
-        saveState();
+        beginEdit();
         setWellAt(event->pos());
     }
 }
@@ -239,40 +468,38 @@ void PlateWidget::mouseReleaseEvent(QMouseEvent* event)
     else {
         setWellAt(event->pos());
     }
+    endEdit();      // the whole press–drag–release is one undo step
 }
 
 void PlateWidget::applySelectionRect(const QRect& rect)
 {
-    bool warned = false;
-    for (int r = 0; r < m_rows; ++r) {
-        for (int c = 0; c < m_cols; ++c) {
-            int idx = r * m_cols + c;
-            QRect cell = cellRect(r, c);
-            if (!rect.intersects(cell))
-                continue;
-            if (m_layout[idx].type != None
-                && m_currentType != None
-                && m_layout[idx].type != m_currentType)
-            {
-                if (!warned) {
-                    QMessageBox::warning(
-                        this,
-                        "Overlap",
-                        "Cannot overwrite non-empty wells!"
-                        );
-                    warned = true;
-                }
-                continue;
-            }
+    if (rect.right() < m_labelMargin || rect.bottom() < m_labelMargin)
+        return;
+    const int r0 = qMax(0, (rect.top() - m_labelMargin) / m_cellSize);
+    const int c0 = qMax(0, (rect.left() - m_labelMargin) / m_cellSize);
+    const int r1 = qMin(m_rows - 1, (rect.bottom() - m_labelMargin) / m_cellSize);
+    const int c1 = qMin(m_cols - 1, (rect.right() - m_labelMargin) / m_cellSize);
+    const WellMask cells = WellMask::rect(m_rows, m_cols, r0, c0, r1, c1);
+
+    // Wells holding a different type are left alone
+    WellMask blocked(m_rows * m_cols);
+    if (m_currentType != None)
+        blocked = cells & (m_occupied - m_typeMask[m_currentType]);
+    if (blocked.any()) {
+        QMessageBox::warning(
+            this,
+            "Overlap",
+            "Cannot overwrite non-empty wells!"
+            );
+    }
 
-            // Normalize data: DMSO and None must be (0,0). Sample/Standard keep selected id/dil.
-            int id  = (m_currentType == DMSO || m_currentType == None) ? 0 : m_currentSample;
-            int dil = (m_currentType == DMSO || m_currentType == None) ? 0 : m_currentDilutionStep;
+    // Normalize data: DMSO and None must be (0,0). Sample/Standard keep selected id/dil.
+    int id  = (m_currentType == DMSO || m_currentType == None) ? 0 : m_currentSample;
+    int dil = (m_currentType == DMSO || m_currentType == None) ? 0 : m_currentDilutionStep;
+    const WellData wd{ m_currentType, id, dil };
 
-            m_layout[idx] = WellData{ m_currentType, id, dil };
-        }
-    }
-    update();
+    (cells - blocked).forEach([&](int idx) { setWell(idx, wd); });
+    updateCells(QRect(QPoint(c0, r0), QPoint(c1, r1)));
     emit layoutChanged();
 }
 
@@ -310,10 +537,10 @@ void PlateWidget::applySerialSelectionRect(const QRect& rect)
             // If you prefer Standard NOT to increment ID across rows, uncomment next line:
             // if (t == Standard) sample = m_currentSample;
 
-            m_layout[idx] = WellData{ t, sample, dil };
+            setWell(idx, WellData{ t, sample, dil });
         }
     }
-    update();
+    updateCells(QRect(QPoint(c0, r0), QPoint(c1, r1)));
     emit layoutChanged();
 }
 
@@ -329,9 +556,9 @@ void PlateWidget::setWellAt(const QPoint& pos)
         return;
 
     int idx = r * m_cols + c;
-    if (m_layout[idx].type != None
+    if (m_occupied.test(idx)
         && m_currentType != None
-        && m_layout[idx].type != m_currentType)
+        && !m_typeMask[m_currentType].test(idx))
     {
         QMessageBox::warning(
             this,
@@ -345,8 +572,13 @@ void PlateWidget::setWellAt(const QPoint& pos)
     int id  = (m_currentType == DMSO || m_currentType == None) ? 0 : m_currentSample;
     int dil = (m_currentType == DMSO || m_currentType == None) ? 0 : m_currentDilutionStep;
 
-    m_layout[idx] = WellData{ m_currentType, id, dil };
-    update();
+    // Dragging over a well that already holds this value repaints nothing
+    const WellData wd{ m_currentType, id, dil };
+    if (m_wells[idx] == pack(wd))
+        return;
+
+    setWell(idx, wd);
+    updateCells(QRect(c, r, 1, 1));
     emit layoutChanged();
 }
 
@@ -5,12 +5,16 @@
 
 #include <QWidget>
 #include <QVector>
-#include <QStack>
+#include <QHash>
+#include <deque>
 #include <QRubberBand>
 #include <QMouseEvent>
 #include <QPainter>
 #include <QMessageBox>
 #include <QColor>
+#include <QPixmap>
+#include <QFont>
+#include "wellmask.h"
 
 class PlateWidget : public QWidget {
     Q_OBJECT
@@ -20,6 +24,10 @@ public:
         WellType type = None;
         int sampleId = 1;
         int dilutionStep = 1;
+
+        friend bool operator==(const WellData& a, const WellData& b)
+        { return a.type == b.type && a.sampleId == b.sampleId && a.dilutionStep == b.dilutionStep; }
+        friend bool operator!=(const WellData& a, const WellData& b) { return !(a == b); }
     };
 
     explicit PlateWidget(int rows, int cols, QWidget* parent = nullptr);
@@ -32,10 +40,29 @@ public:
     void setCurrentSample(int id);
     void setCurrentDilutionStep(int step);
     void undo();
+    void redo();
+
+    // Ctrl+wheel zooms; below kMinTextCellPx wells are drawn without text
+    void setCellSize(int px);
+    int cellSize() const { return m_cellSize; }
 
     int rows() const { return m_rows; }
     int cols() const { return m_cols; }
 
+    // popcount of the type mask, no scan of the wells
+    int wellCount(WellType type) const { return m_typeMask[type].count(); }
+
+    // fill colour of a well on a plate with `cols` columns (thumbnails use it too)
+    static QColor wellColor(const WellData& wd, int cols);
+
+    // 4 bytes per well: type (2 bits) | dilution step (8 bits) | sample id (22 bits).
+    // DMSO/None keep id and dilution at 0,0, so equal-looking layouts pack
+    // (and hash) equal; the layout library stores wells in this form too.
+    using PackedWell = quint32;
+    static PackedWell pack(const WellData& wd);
+    static WellData unpack(PackedWell v);
+    static WellType typeOf(PackedWell v) { return WellType(v & 0x3); }
+
 signals:
     void layoutChanged();
 
@@ -44,27 +71,64 @@ protected:
     void mousePressEvent(QMouseEvent* event) override;
     void mouseMoveEvent(QMouseEvent* event) override;
     void mouseReleaseEvent(QMouseEvent* event) override;
+    void wheelEvent(QWheelEvent* event) override;
+    void changeEvent(QEvent* event) override;
+    void keyPressEvent(QKeyEvent* event) override;     // Undo / Redo shortcuts
 
 private:
+    static constexpr int kMinCellPx     = 6;
+    static constexpr int kMaxCellPx     = 60;
+    static constexpr int kMinTextCellPx = 22;
+    static constexpr qsizetype kHistoryBudgetBytes = 2 * 1024 * 1024;
+
+    // One user action: only the wells it changed, before and after
+    struct WellChange {
+        int index;
+        PackedWell before;
+        PackedWell after;
+    };
+    struct Edit {
+        QVector<WellChange> changes;
+        qsizetype bytes() const { return qsizetype(sizeof(Edit)) + changes.capacity() * qsizetype(sizeof(WellChange)); }
+    };
+
     int m_rows;
     int m_cols;
     int m_cellSize;
     int m_labelMargin;
-    QVector<WellData> m_layout;
+    QVector<PackedWell> m_wells;
+    WellMask m_typeMask[4];                 // one per WellType
+    WellMask m_occupied;                    // type != None
     WellType m_currentType;
     int m_currentSample;
     int m_currentDilutionStep;
-    QStack<QVector<WellData>> m_undoStack;
+    std::deque<Edit> m_undoStack;           // oldest first, evicted from the front
+    std::deque<Edit> m_redoStack;
+    qsizetype m_historyBytes = 0;           // both stacks
+    Edit m_pending;                         // edit being recorded (a whole drag)
+    QHash<int, int> m_pendingIndex;         // well ➜ position in m_pending.changes
+    bool m_recording = false;
     QRubberBand* m_rubberBand;
     QPoint m_dragStart;
     bool m_selecting;
     bool m_serialSelecting;
 
+    // labels + empty grid, rebuilt only when the cell size or DPR changes
+    QPixmap m_staticLayer;
+    QFont m_wellFont;
+    bool m_drawText;
+
     QRect cellRect(int row, int col) const;
-    void saveState();
+    void rebuildStaticLayer();
+    void paintWell(QPainter& p, int idx) const;
+    void updateCells(const QRect& cells);   // repaint a row/col range (cells: x=col, y=row)
+    void beginEdit();
+    void setWell(int idx, const WellData& wd);   // records into the open edit
+    void endEdit();
+    void writeWell(int idx, PackedWell v);      // keeps the masks in step
+    void applyEdit(const Edit& edit, bool forward);
     void applySelectionRect(const QRect& rect);
     void applySerialSelectionRect(const QRect& rect);
     void setWellAt(const QPoint& pos);
-    QColor sampleColor(int sampleId, int dilutionStep) const;
 };
 #endif
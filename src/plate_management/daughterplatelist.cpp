@@ -0,0 +1,198 @@
+#include "daughterplatelist.h"
+#include "daughterplatewidget.h"
+
+// Qt
+#include <QEvent>
+#include <QScrollArea>
+#include <QScrollBar>
+
+/* ======================================================================== */
+/*                               constructor                                */
+/* ======================================================================== */
+DaughterPlateList::DaughterPlateList(QScrollArea *scrollArea)
+    : QWidget(nullptr),
+    scrollArea_{scrollArea}
+{
+    scrollArea_->setWidgetResizable(true);
+    scrollArea_->setAlignment(Qt::AlignTop | Qt::AlignHCenter);
+    scrollArea_->setWidget(this);
+    scrollArea_->viewport()->installEventFilter(this);
+
+    connect(scrollArea_->verticalScrollBar(), &QScrollBar::valueChanged,
+            this, &DaughterPlateList::syncVisible);
+}
+
+/* ======================================================================== */
+/*                                 plates                                   */
+/* ======================================================================== */
+void DaughterPlateList::setPlates(const QVector<DaughterPlateState> &plates,
+                                  bool acceptDrops)
+{
+    releaseAll();
+
+    plates_.clear();
+    plates_.reserve(plates.size());
+    for (const DaughterPlateState &s : plates)
+        plates_.append({s, acceptDrops});
+
+    if (!plates_.isEmpty()) setFormat(plates_.first().state);
+    if (!slotSize_.isValid()) updateSlotSize();
+    setMinimumSize(slotSize_.width(), plateCount() * slotSize_.height());
+    syncVisible();
+}
+
+void DaughterPlateList::resizePlates(int count, const DaughterPlateState &blank,
+                                     bool acceptDrops)
+{
+    if (count == plateCount()) return;
+    if (count < plateCount()) plates_.resize(count);
+    while (plateCount() < count) plates_.append({blank, acceptDrops});
+
+    setFormat(blank);
+    if (!slotSize_.isValid()) updateSlotSize();
+    setMinimumSize(slotSize_.width(), plateCount() * slotSize_.height());
+    syncVisible();
+}
+
+void DaughterPlateList::updatePlate(int index, const DaughterPlateState &state,
+                                    const QVector<int> &changedWells)
+{
+    plates_[index].state = state;
+    if (DaughterPlateWidget *w = shown_.value(index))
+        w->setState(state, changedWells);
+}
+
+void DaughterPlateList::clear()
+{
+    setPlates({}, false);
+}
+
+void DaughterPlateList::clearCompounds()
+{
+    for (Plate &p : plates_) {
+        p.state.clearCompounds();
+        p.acceptDrops = true;
+    }
+    for (auto it = shown_.cbegin(); it != shown_.cend(); ++it)
+        bind(it.value(), it.key());
+}
+
+void DaughterPlateList::setStandardInfo(const QString &name, const QString &notes)
+{
+    standardName_  = name;
+    standardNotes_ = notes;
+
+    for (DaughterPlateWidget *w : std::as_const(pool_))
+        w->setStandardInfo(name, notes);
+    for (DaughterPlateWidget *w : std::as_const(shown_))
+        w->setStandardInfo(name, notes);
+
+    // the label changes the plate height
+    updateSlotSize();
+    setMinimumSize(slotSize_.width(), plateCount() * slotSize_.height());
+    syncVisible();
+}
+
+/* ======================================================================== */
+/*                          widget binding & reuse                          */
+/* ======================================================================== */
+void DaughterPlateList::syncVisible()
+{
+    if (plates_.isEmpty() || !slotSize_.isValid()) { releaseAll(); return; }
+
+    const int pitch = slotSize_.height();
+    const int top   = scrollArea_->verticalScrollBar()->value();
+    const int first = qMax(0, top / pitch - kOverscan);
+    const int last  = qMin(plateCount() - 1,
+                           (top + scrollArea_->viewport()->height()) / pitch + kOverscan);
+
+    for (auto it = shown_.begin(); it != shown_.end(); ) {
+        if (it.key() < first || it.key() > last) {
+            it.value()->hide();
+            pool_.append(it.value());
+            it = shown_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    const int x = qMax(0, (width() - slotSize_.width()) / 2);
+    for (int i = first; i <= last; ++i) {
+        DaughterPlateWidget *w = shown_.value(i);
+        if (!w) {
+            w = acquire();
+            bind(w, i);
+            shown_.insert(i, w);
+        }
+        w->move(x, i * pitch);
+    }
+}
+
+void DaughterPlateList::bind(DaughterPlateWidget *w, int index)
+{
+    const Plate &p = plates_.at(index);
+    w->setPlateNumber(index + 1);
+    w->setState(p.state);
+    w->setAcceptDrops(p.acceptDrops);
+    w->show();
+}
+
+DaughterPlateWidget *DaughterPlateList::acquire()
+{
+    if (!pool_.isEmpty())
+        return pool_.takeLast();
+
+    auto *w = new DaughterPlateWidget(0, this);
+    if (!standardName_.isEmpty())
+        w->setStandardInfo(standardName_, standardNotes_);
+
+    // edits go straight back to the plate data, so a recycled widget loses nothing
+    connect(w, &DaughterPlateWidget::wellsChanged, this, [this, w] {
+        const int i = w->plateNumber() - 1;
+        if (i >= 0 && i < plates_.size())
+            plates_[i].state = w->state();
+    });
+    w->hide();
+    return w;
+}
+
+void DaughterPlateList::releaseAll()
+{
+    for (DaughterPlateWidget *w : std::as_const(shown_)) {
+        w->hide();
+        pool_.append(w);
+    }
+    shown_.clear();
+}
+
+void DaughterPlateList::updateSlotSize()
+{
+    DaughterPlateWidget *probe = acquire();
+    probe->setState(DaughterPlateState(rows_, columns_));
+    slotSize_ = probe->sizeHint() + QSize(0, kSlotSpacingPx);
+    pool_.append(probe);
+}
+
+void DaughterPlateList::setFormat(const DaughterPlateState &state)
+{
+    if (state.rows() == rows_ && state.columns() == columns_) return;
+    rows_    = state.rows();
+    columns_ = state.columns();
+    slotSize_ = QSize();                // all plates share one format; re-measure
+}
+
+/* ======================================================================== */
+/*                                 events                                   */
+/* ======================================================================== */
+bool DaughterPlateList::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == scrollArea_->viewport() && event->type() == QEvent::Resize)
+        syncVisible();
+    return QWidget::eventFilter(watched, event);
+}
+
+void DaughterPlateList::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    syncVisible();                      // re-centre the shown plates
+}
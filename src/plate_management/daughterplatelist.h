@@ -0,0 +1,88 @@
+#ifndef INVENESIS_DAUGHTERPLATELIST_H
+#define INVENESIS_DAUGHTERPLATELIST_H
+/**
+ * @file  daughterplatelist.h
+ * @brief Scrolling list of daughter plates that only builds the visible ones.
+ *
+ * Every plate is kept as a DaughterPlateState. A DaughterPlateWidget exists
+ * only for the plates inside the viewport (plus one above and below);
+ * widgets that scroll out are returned to a pool and rebound to the plates
+ * that scroll in, so forty plates cost the same as two. All plates in the
+ * list share one format (96, 384 or 1536 wells); the slot height follows it.
+ */
+
+#include <QWidget>
+#include <QHash>
+#include <QVector>
+
+#include "daughterplatestate.h"
+
+QT_BEGIN_NAMESPACE
+class QScrollArea;
+QT_END_NAMESPACE
+
+class DaughterPlateWidget;
+
+class DaughterPlateList final : public QWidget
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(DaughterPlateList)
+
+public:
+    /** Installs itself as the widget of `scrollArea` (which then owns it). */
+    explicit DaughterPlateList(QScrollArea *scrollArea);
+
+    /** Replace all plates; `acceptDrops` applies to each of them. */
+    void setPlates(const QVector<DaughterPlateState> &plates, bool acceptDrops);
+    void clear();
+
+    [[nodiscard]] int plateCount() const { return int(plates_.size()); }
+    [[nodiscard]] const DaughterPlateState &plate(int index) const { return plates_.at(index).state; }
+
+    /** Grow (with copies of `blank`) or shrink to `count` plates. */
+    void resizePlates(int count, const DaughterPlateState &blank, bool acceptDrops);
+
+    /** Replace one plate; a shown plate repaints only `changedWells`. */
+    void updatePlate(int index, const DaughterPlateState &state,
+                     const QVector<int> &changedWells);
+
+    /** Remove compounds from every plate (Standard and DMSO stay) and allow drops. */
+    void clearCompounds();
+
+    /** Standard name + tooltip shown under every plate title; empty name hides it. */
+    void setStandardInfo(const QString &name, const QString &notes);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;   // viewport resize
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    struct Plate {
+        DaughterPlateState state;
+        bool               acceptDrops = false;
+    };
+
+    void syncVisible();                                // bind / release widgets
+    void bind(DaughterPlateWidget *widget, int index);
+    DaughterPlateWidget *acquire();
+    void releaseAll();
+    void updateSlotSize();
+    void setFormat(const DaughterPlateState &state);   // invalidates slotSize_ on change
+
+private:
+    static constexpr int kSlotSpacingPx = 6;
+    static constexpr int kOverscan      = 1;           // plates kept beyond the viewport
+
+    QScrollArea                     *scrollArea_ = nullptr;
+    QVector<Plate>                   plates_;
+    QHash<int, DaughterPlateWidget*> shown_;           // plate index ➜ widget
+    QVector<DaughterPlateWidget*>    pool_;            // hidden, ready for reuse
+
+    QString                          standardName_;
+    QString                          standardNotes_;
+    QSize                            slotSize_;        // one plate incl. spacing
+    int                              rows_    = DaughterPlateState::kRows;
+    int                              columns_ = DaughterPlateState::kColumns;
+};
+
+#endif // INVENESIS_DAUGHTERPLATELIST_H
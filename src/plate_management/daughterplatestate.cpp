@@ -0,0 +1,203 @@
+#include "daughterplatestate.h"
+
+namespace {
+const QColor kEmptyFill(Qt::black);
+
+// A … Z, then AA, AB … (1536‑well plates have 32 rows)
+QString rowName(int row)
+{
+    return row < 26 ? QString(QChar('A' + row))
+                    : QString(QChar('A' + row / 26 - 1)) + QChar('A' + row % 26);
+}
+}
+
+DaughterPlateState::DaughterPlateState(int rows, int columns)
+    : rows_{qMax(1, rows)},
+    columns_{qMax(1, columns)}
+{
+    wellCompound_.fill(-1, rows_ * columns_);
+    wellColour_.fill(kEmptyFill.rgb(), rows_ * columns_);
+}
+
+/* ======================================================================== */
+/*                                 lookup                                   */
+/* ======================================================================== */
+int DaughterPlateState::wellIndex(const QString &wellId) const
+{
+    const QString id = wellId.trimmed().toUpper();
+    int i = 0, row = 0;
+    while (i < id.size() && i < 2 && id.at(i) >= 'A' && id.at(i) <= 'Z')
+        row = row * 26 + (id.at(i++).unicode() - 'A' + 1);
+    if (i == 0 || i == id.size()) return -1;
+
+    bool ok = false;
+    const int col = id.mid(i).toInt(&ok);
+    if (!ok || row > rows_ || col < 1 || col > columns_) return -1;
+    return (row - 1) * columns_ + (col - 1);
+}
+
+QString DaughterPlateState::wellId(int index) const
+{
+    return rowName(index / columns_) + QString::number(index % columns_ + 1);
+}
+
+QString DaughterPlateState::compoundName(int well) const
+{
+    const int c = wellCompound_.at(well);
+    return c >= 0 ? compounds_.at(c) : QString();
+}
+
+QString DaughterPlateState::displayText(int well) const
+{
+    const int c = wellCompound_.at(well);
+    return c >= 0 ? compoundText_.at(c) : wellId(well);
+}
+
+QColor DaughterPlateState::compoundColour(const QString &name)
+{
+    if (name == "Standard") return QColor(0,122,204);
+    if (name == "DMSO")     return Qt::darkGray;
+
+    quint32 h = 2166136261u;                           // FNV-1a, stable across runs
+    for (QChar ch : name) { h ^= ch.unicode(); h *= 16777619u; }
+    return QColor::fromHsv(int(h % 360), 200, 220);
+}
+
+int DaughterPlateState::compoundIndex(const QString &name)
+{
+    int idx = compounds_.indexOf(name);
+    if (idx < 0) {
+        idx = int(compounds_.size());
+        compounds_    << name;
+        compoundText_ << (name.length() > 10 && name.contains('-')
+                              ? QString(name).replace('-', "-\n")
+                              : name);
+    }
+    return idx;
+}
+
+void DaughterPlateState::setWell(int well, int compound, const QColor &colour)
+{
+    wellCompound_[well] = qint16(compound);
+    wellColour_[well]   = colour.rgb();
+}
+
+/* ======================================================================== */
+/*                                 editing                                  */
+/* ======================================================================== */
+QVector<int> DaughterPlateState::populate(const CompoundMap &compoundWells,
+                                          const ColorMap    &compoundColors,
+                                          int                dilutionSteps)
+{
+    dilutionSteps_ = dilutionSteps;
+
+    QVector<int> changed;
+    for (auto it = compoundWells.cbegin(); it != compoundWells.cend(); ++it)
+    {
+        const QString &compound = it.key();
+        const QStringList &wells = it.value();
+        const QColor base = compoundColors.value(compound, Qt::gray);
+        const int cIdx = compoundIndex(compound);
+
+        for (int i = 0; i < wells.size(); ++i)
+        {
+            const int w = wellIndex(wells[i]);
+            if (w < 0) continue;
+
+            QColor shade;
+            if (compound == "DMSO")
+                shade = Qt::darkGray;
+            else {
+                const qreal fade = 1.0 - (static_cast<qreal>(i) / dilutionSteps_);
+                shade = base.lighter(100 + static_cast<int>((1 - fade) * 30));
+            }
+            setWell(w, cIdx, shade);
+            changed << w;
+        }
+    }
+    return changed;
+}
+
+QVector<int> DaughterPlateState::clearCompounds()
+{
+    const int stdIdx  = int(compounds_.indexOf("Standard"));
+    const int dmsoIdx = int(compounds_.indexOf("DMSO"));
+
+    QVector<int> changed;
+    for (int w = 0; w < wellCompound_.size(); ++w)
+    {
+        const int c = wellCompound_.at(w);
+        if (c >= 0 && c != stdIdx && c != dmsoIdx) {
+            setWell(w, -1, kEmptyFill);
+            changed << w;
+        }
+    }
+    return changed;
+}
+
+QVector<int> DaughterPlateState::clearWells(const QVector<int> &wells)
+{
+    QVector<int> changed;
+    for (int w : wells)
+        if (w >= 0 && w < wellCount() && !isEmpty(w)) {
+            setWell(w, -1, kEmptyFill);
+            changed << w;
+        }
+    return changed;
+}
+
+bool DaughterPlateState::canPlace(int start, int steps) const
+{
+    if (start < 0 || start >= wellCount()) return false;
+    if (start % columns_ + steps > columns_) return false;
+    for (int i = 0; i < steps; ++i)
+        if (!isEmpty(start + i)) return false;
+    return true;
+}
+
+QVector<int> DaughterPlateState::place(int start, const QString &compound,
+                                       const QColor &base, int steps)
+{
+    if (!canPlace(start, steps)) return {};
+
+    const int cIdx = compoundIndex(compound);
+    QVector<int> changed;
+    for (int i = 0; i < steps; ++i)
+    {
+        const qreal fade = 1.0 - static_cast<qreal>(i) / steps;
+        setWell(start + i, cIdx, base.lighter(100 + static_cast<int>((1 - fade) * 80)));
+        changed << start + i;
+    }
+    return changed;
+}
+
+/* ======================================================================== */
+/*                              serialisation                               */
+/* ======================================================================== */
+QJsonObject DaughterPlateState::toJson() const
+{
+    QJsonObject json;
+    for (int w = 0; w < wellCompound_.size(); ++w)
+    {
+        const int c = wellCompound_.at(w);
+        if (c >= 0)
+            json[wellId(w)] = compounds_.at(c);
+    }
+    return json;
+}
+
+DaughterPlateState DaughterPlateState::fromJson(const QJsonObject &json, int dilutionSteps,
+                                                int rows, int columns)
+{
+    CompoundMap cmpdWells;
+    for (auto it = json.constBegin(); it != json.constEnd(); ++it)
+        cmpdWells[it.value().toString()].append(it.key());
+
+    ColorMap cmpdColors;
+    for (auto it = cmpdWells.cbegin(); it != cmpdWells.cend(); ++it)
+        cmpdColors[it.key()] = compoundColour(it.key());
+
+    DaughterPlateState s(rows, columns);
+    s.populate(cmpdWells, cmpdColors, dilutionSteps);
+    return s;
+}
@@ -0,0 +1,81 @@
+#ifndef INVENESIS_DAUGHTERPLATESTATE_H
+#define INVENESIS_DAUGHTERPLATESTATE_H
+/**
+ * @file  daughterplatestate.h
+ * @brief Contents of one daughter plate as plain data (no widget).
+ *
+ * One compound index and one colour per well, row‑major (A1, A2, … H12 on
+ * a 96‑well plate; 16 x 24 and 32 x 48 for 384 and 1536, with rows
+ * … Z, AA, AB …), plus the interned compound names. Cheap to copy (implicitly shared), so
+ * plates that are not on screen are kept as this and handed to a
+ * DaughterPlateWidget only while visible.
+ */
+
+#include <QColor>
+#include <QJsonObject>
+#include <QMap>
+#include <QStringList>
+#include <QVector>
+
+class DaughterPlateState
+{
+public:
+    using CompoundMap = QMap<QString, QStringList>;
+    using ColorMap    = QMap<QString, QColor>;
+
+    static constexpr int kRows    = 8;             // default (96‑well) format
+    static constexpr int kColumns = 12;
+
+    explicit DaughterPlateState(int rows = kRows, int columns = kColumns);
+
+    int rows() const                    { return rows_; }
+    int columns() const                 { return columns_; }
+
+    /* ---- wells ---- */
+    int     wellCount() const           { return int(wellCompound_.size()); }
+    int     compoundAt(int well) const  { return wellCompound_.at(well); }   // -1 = empty
+    bool    isEmpty(int well) const     { return wellCompound_.at(well) < 0; }
+    QColor  colourAt(int well) const    { return QColor::fromRgb(wellColour_.at(well)); }
+    QString compoundName(int well) const;
+    QString displayText(int well) const; // compound (wrapped at '-') or well id
+
+    int     wellIndex(const QString &wellId) const;      // "B3" ➜ 14 on 96, -1 if invalid
+    QString wellId(int index) const;                    // 0 ➜ "A1", 384 wells: 383 ➜ "P24"
+
+    /** Base colour of a compound; depends only on the name, so a compound
+        keeps its colour when others are added or removed. */
+    static QColor  compoundColour(const QString &name);
+
+    /* ---- editing; each returns the wells it changed ---- */
+    QVector<int> populate(const CompoundMap &compoundWells,
+                          const ColorMap    &compoundColors,
+                          int                dilutionSteps);
+    QVector<int> clearCompounds();                     // keeps Standard and DMSO
+    QVector<int> clearWells(const QVector<int> &wells);
+
+    /** `steps` free wells from `start` along its row? */
+    bool canPlace(int start, int steps) const;
+    QVector<int> place(int start, const QString &compound, const QColor &base, int steps);
+
+    /* ---- serialisation ---- */
+    QJsonObject toJson() const;                         // { "B3": "Cmpd", … }
+    static DaughterPlateState fromJson(const QJsonObject &json, int dilutionSteps,
+                                       int rows = kRows, int columns = kColumns);
+
+    int  dilutionSteps() const      { return dilutionSteps_; }
+    void setDilutionSteps(int n)    { dilutionSteps_ = n; }
+
+private:
+    int  compoundIndex(const QString &name);            // interned, appended if new
+    void setWell(int well, int compound, const QColor &colour);
+
+    int             rows_;
+    int             columns_;
+    QVector<qint16> wellCompound_;
+    QVector<QRgb>   wellColour_;
+    QStringList     compounds_;
+    QStringList     compoundText_;
+    int             dilutionSteps_ = 1;
+};
+
+#endif // INVENESIS_DAUGHTERPLATESTATE_H
@@ -1,70 +1,129 @@
 #include "daughterplatewidget.h"
 
 // Qt
-#include <QGridLayout>
 #include <QVBoxLayout>
 #include <QLabel>
+#include <QSpacerItem>
 #include <QDragEnterEvent>
 #include <QDropEvent>
 #include <QMimeData>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QHelpEvent>
+#include <QToolTip>
 #include <QRandomGenerator>
-#include <QJsonArray>
-#include <QJsonValue>
 
-namespace { constexpr int kSpacingPx = 1; }
+namespace {
+constexpr int kSpacingPx = 1;
 
-/* static */ const QStringList DaughterPlateWidget::kRows =
-    {"A","B","C","D","E","F","G","H"};
+const QColor kEmptyText    (90, 90, 90);
+const QColor kPreviewOk    (0xd0, 0xf0, 0xff);
+const QColor kPreviewBad   (0xff, 0xaa, 0xaa);
+}
 
 /* ======================================================================== */
 /*                               constructor                                */
 /* ======================================================================== */
-DaughterPlateWidget::DaughterPlateWidget(int plateNumber, QWidget *parent)
+DaughterPlateWidget::DaughterPlateWidget(int plateNumber, QWidget *parent,
+                                         int rows, int columns)
     : QWidget(parent),
-    plateNumber_{plateNumber}
+    plateNumber_{plateNumber},
+    state_{rows, columns}
 {
     /* main vertical layout */
     auto *mainLayout = new QVBoxLayout(this);
     mainLayout->setContentsMargins(4,4,4,4);
     mainLayout->setSpacing(4);
 
-    auto *title = new QLabel(tr("Daughter Plate %1").arg(plateNumber_), this);
-    title->setAlignment(Qt::AlignCenter);
-    title->setStyleSheet(QStringLiteral("font-weight:bold;"));
-    mainLayout->addWidget(title);
-
-    plateLayout_ = new QGridLayout;
-    plateLayout_->setSpacing(kSpacingPx);
-    plateLayout_->setSizeConstraint(QLayout::SetFixedSize);        // fixed grid
-    mainLayout->addLayout(plateLayout_);
+    titleLabel_ = new QLabel(tr("Daughter Plate %1").arg(plateNumber_), this);
+    titleLabel_->setAlignment(Qt::AlignCenter);
+    titleLabel_->setStyleSheet(QStringLiteral("font-weight:bold;"));
+    mainLayout->addWidget(titleLabel_);
 
-    setupEmptyPlate();
+    /* the grid itself is painted into the area this spacer reserves */
+    gridSpacer_ = new QSpacerItem(0, 0, QSizePolicy::Fixed, QSizePolicy::Fixed);
+    mainLayout->addItem(gridSpacer_);
 
     setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);          // no stretch
-    adjustSize();
+    updateGridSize();
 
     setAcceptDrops(false);
 }
 
 /* ======================================================================== */
-/*                           plate initialisation                           */
+/*                        state (for DaughterPlateList)                     */
 /* ======================================================================== */
-void DaughterPlateWidget::setupEmptyPlate()
+void DaughterPlateWidget::setState(const DaughterPlateState &state)
 {
-    for (int r = 0; r < kRows.size(); ++r)
-        for (int c = 1; c <= kColumns; ++c)
-        {
-            const QString wellId = kRows[r] + QString::number(c);
-            auto *lbl = new QLabel(wellId, this);
-            lbl->setFixedSize(kWellSizePx, kWellSizePx);
-            lbl->setFrameStyle(QFrame::Box);
-            lbl->setAlignment(Qt::AlignCenter);
-            lbl->setStyleSheet(QStringLiteral(
-                "background-color:black; border:1px solid black;"));
-
-            plateLayout_->addWidget(lbl, r, c-1);
-            wellLabels_.insert(wellId, lbl);
-        }
+    clearDropPreview();
+    const bool resized = state.rows() != state_.rows() || state.columns() != state_.columns();
+    state_ = state;
+    if (resized) updateGridSize();
+    update();
+}
+
+void DaughterPlateWidget::setState(const DaughterPlateState &state,
+                                   const QVector<int> &changedWells)
+{
+    if (state.rows() != state_.rows() || state.columns() != state_.columns()) {
+        setState(state);
+        return;
+    }
+    clearDropPreview();
+    state_ = state;
+    updateWells(changedWells);
+}
+
+void DaughterPlateWidget::setPlateNumber(int plateNumber)
+{
+    if (plateNumber_ == plateNumber) return;
+    plateNumber_ = plateNumber;
+    titleLabel_->setText(tr("Daughter Plate %1").arg(plateNumber_));
+}
+
+/* ======================================================================== */
+/*                           geometry & lookup                              */
+/* ======================================================================== */
+void DaughterPlateWidget::updateGridSize()
+{
+    // keep 384 / 1536 plates about as wide as a 96‑well one
+    const int columns = state_.columns(), rows = state_.rows();
+    wellSizePx_ = qMax(6, (DaughterPlateState::kColumns * (kWellSizePx + kSpacingPx)) / columns
+                              - kSpacingPx);
+
+    gridSpacer_->changeSize(columns * wellSizePx_ + (columns - 1) * kSpacingPx,
+                            rows    * wellSizePx_ + (rows    - 1) * kSpacingPx,
+                            QSizePolicy::Fixed, QSizePolicy::Fixed);
+    layout()->invalidate();
+    adjustSize();
+}
+
+QRect DaughterPlateWidget::wellRect(int index) const
+{
+    const QPoint origin = gridSpacer_->geometry().topLeft();
+    const int row = index / state_.columns(), col = index % state_.columns();
+    return QRect(origin.x() + col * (wellSizePx_ + kSpacingPx),
+                 origin.y() + row * (wellSizePx_ + kSpacingPx),
+                 wellSizePx_, wellSizePx_);
+}
+
+int DaughterPlateWidget::wellAt(const QPoint &pos) const
+{
+    const QPoint p = pos - gridSpacer_->geometry().topLeft();
+    if (p.x() < 0 || p.y() < 0) return -1;
+
+    const int pitch = wellSizePx_ + kSpacingPx;
+    const int col = p.x() / pitch, row = p.y() / pitch;
+    if (col >= state_.columns() || row >= state_.rows()) return -1;
+    if (p.x() % pitch >= wellSizePx_ || p.y() % pitch >= wellSizePx_) return -1;   // on a gap
+    return row * state_.columns() + col;
+}
+
+void DaughterPlateWidget::updateWells(const QVector<int> &indices)
+{
+    QRect dirty;
+    for (int i : indices) dirty |= wellRect(i);
+    if (!dirty.isNull()) update(dirty.adjusted(-1, -1, 1, 1));
 }
 
 /* ======================================================================== */
@@ -74,69 +133,82 @@ void DaughterPlateWidget::populatePlate(const CompoundMap &compoundWells,
                                         const ColorMap    &compoundColors,
                                         int                dilutionSteps)
 {
-    dilutionSteps_ = dilutionSteps;
-
-    QFont font; font.setPointSize(7);
-
-    for (auto it = compoundWells.cbegin(); it != compoundWells.cend(); ++it)
-    {
-        const QString &compound = it.key();
-        const QStringList &wells = it.value();
-        const QColor base = compoundColors.value(compound, Qt::gray);
-
-        for (int i = 0; i < wells.size(); ++i)
-        {
-            const QString &well = wells[i];
-            if (!wellLabels_.contains(well)) continue;
-
-            auto *lbl = wellLabels_[well];
-            QString text = compound.length() > 10 && compound.contains('-')
-                               ? QString(compound).replace('-', "-\n")
-                               : compound;
-
-            lbl->setText(text);
-            lbl->setFont(font);
-            lbl->setToolTip(compound);
-
-            QColor shade;
-            if (compound == "DMSO")
-                shade = Qt::darkGray;
-            else {
-                const qreal fade = 1.0 - (static_cast<qreal>(i) / dilutionSteps_);
-                shade = base.lighter(100 + static_cast<int>((1 - fade) * 30));
-            }
-            lbl->setStyleSheet(QStringLiteral(
-                                   "background-color:%1; border:1px solid black;").arg(shade.name()));
-            lbl->setProperty("compound", compound);
-        }
-    }
+    updateWells(state_.populate(compoundWells, compoundColors, dilutionSteps));
 }
 
 void DaughterPlateWidget::clearCompounds()
 {
-    QFont font; font.setPointSize(7);
+    const QVector<int> changed = state_.clearCompounds();
+    updateWells(changed);
+    setAcceptDrops(true);
+    if (!changed.isEmpty()) emit wellsChanged();
+}
 
-    for (auto it = wellLabels_.begin(); it != wellLabels_.end(); ++it)
-    {
-        auto *lbl = it.value();
-        const QString compound = lbl->property("compound").toString();
+void DaughterPlateWidget::enableCompoundDragDrop(int dilutionSteps)
+{
+    state_.setDilutionSteps(dilutionSteps);
+    setAcceptDrops(true);
+}
 
-        if (compound != "Standard" && compound != "DMSO")
+/* ======================================================================== */
+/*                                painting                                  */
+/* ======================================================================== */
+void DaughterPlateWidget::paintEvent(QPaintEvent *e)
+{
+    QPainter p(this);
+    QFont font = p.font(); font.setPointSize(7);
+    p.setFont(font);
+
+    // only the wells the dirty rectangle touches
+    const int   cols   = state_.columns();
+    const int   pitch  = wellSizePx_ + kSpacingPx;
+    const bool  text   = wellSizePx_ >= kMinTextPx;
+    const QRect area   = e->rect().translated(-gridSpacer_->geometry().topLeft());
+    if (area.right() < 0 || area.bottom() < 0) return;
+    const int   c0 = qMax(0, area.left() / pitch),  c1 = qMin(cols - 1,            area.right()  / pitch);
+    const int   r0 = qMax(0, area.top()  / pitch),  r1 = qMin(state_.rows() - 1,   area.bottom() / pitch);
+
+    for (int r = r0; r <= r1; ++r)
+        for (int c = c0; c <= c1; ++c)
         {
-            lbl->setText(it.key());
-            lbl->setFont(font);
-            lbl->setStyleSheet(QStringLiteral(
-                "background-color:black; border:1px solid black;"));
-            lbl->setProperty("compound", QString());
+            const int   w    = r * cols + c;
+            const QRect rect = wellRect(w);
+            const bool  full = !state_.isEmpty(w);
+
+            const bool inPreview = previewWells_.contains(w) && !full;
+            if (inPreview) {
+                p.fillRect(rect, previewConflict_ ? kPreviewBad : kPreviewOk);
+                p.setPen(QPen(previewConflict_ ? Qt::red : Qt::blue, 2, Qt::DashLine));
+                p.drawRect(rect.adjusted(1, 1, -1, -1));
+            } else {
+                p.fillRect(rect, Qt::black);                                  // 1px border
+                p.fillRect(rect.adjusted(1, 1, -1, -1), state_.colourAt(w));
+            }
+
+            if (!text) continue;
+            p.setPen(full ? Qt::black : kEmptyText);
+            p.drawText(rect, Qt::AlignCenter | Qt::TextWordWrap, state_.displayText(w));
         }
-    }
-    setAcceptDrops(true);
 }
 
-void DaughterPlateWidget::enableCompoundDragDrop(int dilutionSteps)
+bool DaughterPlateWidget::event(QEvent *e)
 {
-    dilutionSteps_ = dilutionSteps;
-    setAcceptDrops(true);
+    if (e->type() == QEvent::ToolTip) {
+        auto *he = static_cast<QHelpEvent*>(e);
+        const int w = wellAt(he->pos());
+        if (w >= 0 && !state_.isEmpty(w))
+            QToolTip::showText(he->globalPos(),
+                               wellSizePx_ >= kMinTextPx
+                                   ? state_.compoundName(w)
+                                   : state_.wellId(w) + ": " + state_.compoundName(w),
+                               this, wellRect(w));
+        else if (w >= 0 && wellSizePx_ < kMinTextPx)
+            QToolTip::showText(he->globalPos(), state_.wellId(w), this, wellRect(w));
+        else
+            QToolTip::hideText();
+        return true;
+    }
+    return QWidget::event(e);
 }
 
 /* ======================================================================== */
@@ -156,78 +228,42 @@ void DaughterPlateWidget::dragLeaveEvent(QDragLeaveEvent *e)
 
 void DaughterPlateWidget::dragMoveEvent(QDragMoveEvent *e)
 {
-    clearDropPreview();
-
-    auto *lbl = qobject_cast<QLabel*>(childAt(e->position().toPoint()));
-    if (!lbl) return;
-
-    const QString startWell = lbl->text();
-    if (startWell.isEmpty()) return;
-
-    showDropPreview(e->mimeData()->text(), startWell);
+    const int w = wellAt(e->position().toPoint());
+    if (w < 0) { clearDropPreview(); return; }
+
+    const QString startWell = state_.wellId(w);
+    if (previewWells_.isEmpty() || previewWells_.first() != w
+        || previewCompound_ != e->mimeData()->text()) {
+        clearDropPreview();
+        showDropPreview(e->mimeData()->text(), startWell);
+    }
     e->acceptProposedAction();
 }
 
 void DaughterPlateWidget::dropEvent(QDropEvent *e)
 {
     const QString compound = e->mimeData()->text();
-    auto *target = qobject_cast<QLabel*>(childAt(e->position().toPoint()));
-    if (!target) return;
-
-    const QString startWell = target->text();
-    if (startWell.isEmpty()) return;
-
-    const QChar rowLetter = startWell.at(0);
-    const int   startCol  = startWell.mid(1).toInt();
-
-    QStringList targetWells;
-    for (int i = 0; i < dilutionSteps_; ++i) {
-        const int col = startCol + i;
-        if (col > kColumns) return;
+    const int start = wellAt(e->position().toPoint());
+    clearDropPreview();
+    if (start < 0) return;
 
-        const QString well = rowLetter + QString::number(col);
-        if (!wellLabels_[well]->property("compound").toString().isEmpty())
-            return;
-        targetWells << well;
-    }
+    if (!state_.canPlace(start, state_.dilutionSteps())) return;
 
     const QColor base = QColor::fromHsv(
         QRandomGenerator::global()->bounded(360), 200, 220);
-
-    QFont font; font.setPointSize(7);
-    const QString dispText = compound.length() > 10 && compound.contains('-')
-                                 ? QString(compound).replace('-', "-\n")
-                                 : compound;
-
-    for (int i = 0; i < targetWells.size(); ++i)
-    {
-        auto *lbl = wellLabels_[targetWells[i]];
-        lbl->setText(dispText);
-        lbl->setFont(font);
-
-        const qreal fade = 1.0 - static_cast<qreal>(i) / dilutionSteps_;
-        const QColor shade = base.lighter(100 + static_cast<int>((1 - fade) * 80));
-        lbl->setStyleSheet(QStringLiteral(
-                               "background-color:%1; border:1px solid black;").arg(shade.name()));
-        lbl->setProperty("compound", compound);
-    }
+    updateWells(state_.place(start, compound, base, state_.dilutionSteps()));
+    emit wellsChanged();
     e->acceptProposedAction();
 }
 
 /* ---------- preview helpers --------------------------------------------- */
 void DaughterPlateWidget::clearDropPreview()
 {
-    for (const QString &well : std::as_const(previewWells_))
-    {
-        auto *lbl = wellLabels_[well];
-        if (lbl->property("compound").toString().isEmpty())
-            lbl->setStyleSheet(QStringLiteral(
-                "background-color:black; border:1px solid black;"));
-        /*  ← we NO LONGER reset lbl->setText(well) here, preventing
-            accidental overwrite of compound names                      */
-    }
+    const QVector<int> old = previewWells_;
     previewWells_.clear();
     previewCompound_.clear();
+    previewConflict_ = false;
+    updateWells(old);
 }
 
 void DaughterPlateWidget::showDropPreview(const QString &cmpd,
@@ -235,30 +271,26 @@ void DaughterPlateWidget::showDropPreview(const QString &cmpd,
 {
     previewWells_.clear();
     previewCompound_ = cmpd;
+    previewConflict_ = false;
 
-    const int rowIdx   = kRows.indexOf(startWell.left(1));
-    const int startCol = startWell.mid(1).toInt();
-    if (rowIdx == -1) return;
+    const int start = state_.wellIndex(startWell);
+    if (start < 0) return;
 
-    bool conflict = false;
-    for (int i = 0; i < dilutionSteps_; ++i) {
+    const int cols     = state_.columns();
+    const int row      = start / cols;
+    const int startCol = start % cols;
+    for (int i = 0; i < state_.dilutionSteps(); ++i) {
         const int col = startCol + i;
-        const QString well = kRows[rowIdx] + QString::number(col);
-
-        if (col > kColumns ||
-            !wellLabels_.contains(well) ||
-            !wellLabels_[well]->property("compound").toString().isEmpty())
-        {
-            conflict = true;
+        const int w   = row * cols + col;
+        if (col >= cols || !state_.isEmpty(w)) {
+            previewConflict_ = true;
             break;
         }
-        previewWells_ << well;
+        previewWells_ << w;
     }
-
-    const QString okCss  = "background-color:#d0f0ff; border:2px dashed blue;";
-    const QString badCss = "background-color:#ffaaaa; border:2px dashed red;";
-    for (const QString &well : std::as_const(previewWells_))
-        wellLabels_[well]->setStyleSheet(conflict ? badCss : okCss);
+    if (previewConflict_ && previewWells_.isEmpty())
+        previewWells_ << start;                     // keep the anchor for the move check
+    updateWells(previewWells_);
 }
 
 /* ======================================================================== */
@@ -266,35 +298,13 @@ void DaughterPlateWidget::showDropPreview(const QString &cmpd,
 /* ======================================================================== */
 QJsonObject DaughterPlateWidget::toJson() const
 {
-    QJsonObject json;
-    for (auto it = wellLabels_.cbegin(); it != wellLabels_.cend(); ++it)
-    {
-        const QString compound = it.value()->property("compound").toString();
-        if (!compound.isEmpty())
-            json[it.key()] = compound;
-    }
-    return json;
+    return state_.toJson();
 }
 
 void DaughterPlateWidget::fromJson(const QJsonObject &json, int dilutionSteps)
 {
-    dilutionSteps_ = dilutionSteps;
-
-    CompoundMap cmpdWells;
-    for (auto it = json.constBegin(); it != json.constEnd(); ++it)
-        cmpdWells[it.value().toString()].append(it.key());
-
-    ColorMap cmpdColors;
-    int hue = 0, step = 360 / (cmpdWells.size() + 1);
-    for (auto it = cmpdWells.cbegin(); it != cmpdWells.cend(); ++it)
-    {
-        const QString &cmpd = it.key();
-        if (cmpd == "Standard")      cmpdColors[cmpd] = QColor(0,122,204);
-        else if (cmpd == "DMSO")     cmpdColors[cmpd] = Qt::darkGray;
-        else                         cmpdColors[cmpd] = QColor::fromHsv(hue,200,220);
-        hue += step;
-    }
-    populatePlate(cmpdWells, cmpdColors, dilutionSteps_);
+    setState(DaughterPlateState::fromJson(json, dilutionSteps,
+                                          state_.rows(), state_.columns()));
 }
 
 /* ======================================================================== */
@@ -303,6 +313,7 @@ void DaughterPlateWidget::fromJson(const QJsonObject &json, int dilutionSteps)
 void DaughterPlateWidget::setStandardInfo(const QString &name,
                                           const QString &notes)
 {
+    if (!standardLabel_ && name.isEmpty()) return;
     if (!standardLabel_) {
         standardLabel_ = new QLabel(this);
         standardLabel_->setAlignment(Qt::AlignCenter);
@@ -313,4 +324,5 @@ void DaughterPlateWidget::setStandardInfo(const QString &name,
     }
     standardLabel_->setText(tr("Standard: %1").arg(name));
     standardLabel_->setToolTip(notes);
+    standardLabel_->setVisible(!name.isEmpty());
 }
@@ -2,9 +2,15 @@
 #define INVENESIS_DAUGHTERPLATEWIDGET_H
 /**
  * @file  daughterplatewidget.h
- * @brief Interactive 96‑well daughter‑plate widget (drag‑and‑drop compounds).
+ * @brief Interactive daughter‑plate widget (drag‑and‑drop compounds).
  *
  * 2025‑04 refactor – same public API, improved style & fixed‑spacing layout.
+ * The wells are painted from a compact per‑well state array (no child
+ * widget per well); hit‑testing is arithmetic and changes repaint only
+ * the wells they touch. The contents live in a DaughterPlateState, so a
+ * DaughterPlateList can hand one widget a different plate while scrolling.
+ * The grid follows the format of the state (96, 384 or 1536 wells); wells
+ * shrink with the format and only 96‑well plates print text into them.
  */
 
 #include <QWidget>
@@ -12,14 +18,17 @@
 #include <QStringList>
 #include <QColor>
 #include <QJsonObject>
+#include <QVector>
+
+#include "daughterplatestate.h"
 
 QT_BEGIN_NAMESPACE
-class QGridLayout;
 class QLabel;
-class QVBoxLayout;
+class QSpacerItem;
 class QDragEnterEvent;
 class QDropEvent;
 class QDragMoveEvent;
+class QPaintEvent;
 QT_END_NAMESPACE
 
 class DaughterPlateWidget final : public QWidget
@@ -28,10 +37,12 @@ class DaughterPlateWidget final : public QWidget
     Q_DISABLE_COPY_MOVE(DaughterPlateWidget)
 
 public:
-    explicit DaughterPlateWidget(int plateNumber, QWidget *parent = nullptr);
+    explicit DaughterPlateWidget(int plateNumber, QWidget *parent = nullptr,
+                                 int rows    = DaughterPlateState::kRows,
+                                 int columns = DaughterPlateState::kColumns);
 
-    using CompoundMap = QMap<QString, QStringList>;
-    using ColorMap    = QMap<QString, QColor>;
+    using CompoundMap = DaughterPlateState::CompoundMap;
+    using ColorMap    = DaughterPlateState::ColorMap;
 
     void populatePlate(const CompoundMap &compoundWells,
                        const ColorMap    &compoundColors,
@@ -43,32 +54,52 @@ public:
     [[nodiscard]] QJsonObject toJson() const;
     void fromJson(const QJsonObject &json, int dilutionSteps);
 
-    /** Display a standard name + tooltip underneath the title. */
+    /** Display a standard name + tooltip underneath the title; empty hides it. */
     void setStandardInfo(const QString &name, const QString &notes);
 
+    /* ---- view onto plain plate data (DaughterPlateList recycles widgets) ---- */
+    [[nodiscard]] const DaughterPlateState &state() const { return state_; }
+    void setState(const DaughterPlateState &state);
+    void setState(const DaughterPlateState &state, const QVector<int> &changedWells);
+    [[nodiscard]] int plateNumber() const { return plateNumber_; }
+    void setPlateNumber(int plateNumber);
+
+signals:
+    /** A drop or clearCompounds() changed the wells. */
+    void wellsChanged();
+
 protected:                                /* Qt D‑n‑D overrides */
     void dragEnterEvent(QDragEnterEvent *event) override;
     void dropEvent(QDropEvent *event) override;
     void dragMoveEvent(QDragMoveEvent *event) override;
     void dragLeaveEvent(QDragLeaveEvent *event) override;
 
+    void paintEvent(QPaintEvent *event) override;
+    bool event(QEvent *event) override;   // well tooltips
+
 private:                                 /* helpers */
-    void setupEmptyPlate();
     void showDropPreview(const QString &compoundName,
                          const QString &startWell);
     void clearDropPreview();
 
+    int     wellAt(const QPoint &pos) const;       // -1 outside the grid
+    QRect   wellRect(int index) const;
+    void    updateWells(const QVector<int> &indices);
+    void    updateGridSize();                       // after a format change
+
 private:                                 /* constants */
-    static constexpr int   kColumns     = 12;
-    static constexpr int   kWellSizePx  = 40;
-    static const QStringList kRows;
+    static constexpr int   kWellSizePx  = 40;       // 96‑well; denser formats scale down
+    static constexpr int   kMinTextPx   = 30;       // smaller wells show no text
 
 private:                                 /* state */
-    const int              plateNumber_;
-    int                    dilutionSteps_ = 1;
-    QGridLayout           *plateLayout_   = nullptr;
-    QMap<QString,QLabel*>  wellLabels_;           // well‑ID ➜ label*
-    QStringList            previewWells_;         // wells highlighted during drag
+    int                    plateNumber_;
+    QLabel                *titleLabel_    = nullptr;
+    QSpacerItem           *gridSpacer_    = nullptr;   // reserves the painted area
+    DaughterPlateState     state_;
+    int                    wellSizePx_    = kWellSizePx;
+
+    QVector<int>           previewWells_;               // wells highlighted during drag
+    bool                   previewConflict_ = false;
     QString                previewCompound_;
     QLabel                *standardLabel_ = nullptr;
 };
@@ -0,0 +1,451 @@
+#include "platelayoutcodec.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QObject>
+#include <QSaveFile>
+#include <QThread>
+#include <QThreadPool>
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+// A view into the mapped bytes; nothing is copied while parsing
+struct Field {
+    const char* p = nullptr;
+    int n = 0;
+};
+
+inline bool isBlank(char ch) { return ch == ' ' || ch == '\t' || ch == '"'; }
+
+inline Field trimmed(Field f)
+{
+    while (f.n > 0 && isBlank(*f.p)) { ++f.p; --f.n; }
+    while (f.n > 0 && isBlank(f.p[f.n - 1])) --f.n;
+    return f;
+}
+
+inline char lower(char ch) { return (ch >= 'A' && ch <= 'Z') ? char(ch - 'A' + 'a') : ch; }
+
+// `lit` is lower case
+inline bool equalsCI(Field f, const char* lit)
+{
+    const int n = int(std::strlen(lit));
+    if (f.n != n) return false;
+    for (int i = 0; i < n; ++i)
+        if (lower(f.p[i]) != lit[i]) return false;
+    return true;
+}
+
+inline int toInt(Field f)
+{
+    int v = 0;
+    const auto res = std::from_chars(f.p, f.p + f.n, v);
+    return res.ec == std::errc() ? v : 0;
+}
+
+// Splits [b, e) at ',' into at most `max` trimmed fields; returns the count
+int splitFields(const char* b, const char* e, Field* out, int max)
+{
+    int n = 0;
+    const char* start = b;
+    for (const char* p = b; ; ++p) {
+        if (p == e || *p == ',') {
+            if (n < max) out[n] = trimmed(Field{ start, int(p - start) });
+            ++n;
+            if (p == e) break;
+            start = p + 1;
+        }
+    }
+    return qMin(n, max);
+}
+
+// "B03" ➜ (1, 2). Two letters are AA = 26 (A..Z, AA..) unless `legacyPairs`,
+// where the 1536 dialog wrote AA = 0, AB = 1, … BA = 26.
+bool parseWell(Field f, bool legacyPairs, int& r0, int& c0)
+{
+    int i = 0, letters = 0, row = 0;
+    while (i < f.n && letters < 2) {
+        const char ch = f.p[i] & ~0x20;                 // upper case
+        if (ch < 'A' || ch > 'Z') break;
+        row = letters == 0 ? ch - 'A' : (legacyPairs ? row * 26 : (row + 1) * 26) + (ch - 'A');
+        ++letters;
+        ++i;
+    }
+    if (letters == 0 || i == f.n) return false;
+    int col = 0;
+    const auto res = std::from_chars(f.p + i, f.p + f.n, col);
+    if (res.ec != std::errc() || res.ptr != f.p + f.n || col < 1) return false;
+    r0 = row;
+    c0 = col - 1;
+    return true;
+}
+
+PlateWidget::WellType roleOf(Field f)
+{
+    if (equalsCI(f, "sample") || equalsCI(f, "samples") || equalsCI(f, "sample_id"))
+        return PlateWidget::Sample;
+    if (equalsCI(f, "standard"))
+        return PlateWidget::Standard;
+    if (equalsCI(f, "dmso") || equalsCI(f, "placebo"))      // the writer calls DMSO "placebo"
+        return PlateWidget::DMSO;
+    return PlateWidget::None;
+}
+
+// Next line in [p, end) without its line break; false at the end
+inline bool nextLine(const char*& p, const char* end, const char*& lb, const char*& le)
+{
+    if (p >= end) return false;
+    lb = p;
+    const void* nl = std::memchr(p, '\n', size_t(end - p));
+    le = nl ? static_cast<const char*>(nl) : end;
+    p  = nl ? le + 1 : end;
+    if (le > lb && le[-1] == '\r') --le;
+    return true;
+}
+
+inline bool isEmptyLine(const char* b, const char* e)
+{
+    for (; b < e; ++b)
+        if (*b != ' ' && *b != '\t') return false;
+    return true;
+}
+
+inline bool onlySeparators(const char* b, const char* e)
+{
+    for (; b < e; ++b)
+        if (*b != ';' && *b != ',' && *b != ' ') return false;
+    return true;
+}
+
+struct Entry {
+    int r0;
+    int c0;
+    PlateWidget::WellData wd;
+};
+
+constexpr int kMaxFields = 16;
+
+inline void appendInt(QByteArray& out, int v, int minDigits = 1)
+{
+    char buf[16];
+    const auto res = std::to_chars(buf, buf + sizeof buf, v);
+    for (int pad = minDigits - int(res.ptr - buf); pad > 0; --pad) out.append('0');
+    out.append(buf, int(res.ptr - buf));
+}
+
+// A..Z, then AA.. (LayoutColumns) or AA = row 0 (Legacy)
+inline void appendRow(QByteArray& out, int r0, bool legacyPairs)
+{
+    if (legacyPairs) {
+        out.append(char('A' + r0 / 26));
+        out.append(char('A' + r0 % 26));
+    } else if (r0 < 26) {
+        out.append(char('A' + r0));
+    } else {
+        out.append(char('A' + r0 / 26 - 1));
+        out.append(char('A' + r0 % 26));
+    }
+}
+
+} // namespace
+
+bool PlateLayoutCodec::parse(const char* data, qsizetype size, int rows, int cols,
+                             Layout& out, QString* errorMsg)
+{
+    auto fail = [&](const QString& msg) {
+        if (errorMsg) *errorMsg = msg;
+        return false;
+    };
+
+    const char* p   = data;
+    const char* end = data + size;
+    if (size >= 3 && std::memcmp(p, "\xEF\xBB\xBF", 3) == 0) p += 3;      // UTF-8 BOM
+
+    /* ---- schema, once ---- */
+    const char *lb = nullptr, *le = nullptr;
+    do {
+        if (!nextLine(p, end, lb, le)) return fail(QObject::tr("The file is empty."));
+    } while (isEmptyLine(lb, le));
+    if (onlySeparators(lb, le)) {                   // ";;;;;;" preamble
+        do {
+            if (!nextLine(p, end, lb, le)) return fail(QObject::tr("The file has no header."));
+        } while (isEmptyLine(lb, le));
+    }
+
+    Field f[kMaxFields];
+    int nf = splitFields(lb, le, f, kMaxFields);
+
+    int iWell = -1, iRow = -1, iCol = -1, iRole = -1, iCmpd = -1, iDil = -1;
+    for (int i = 0; i < nf; ++i) {
+        if      (equalsCI(f[i], "layoutwell"))            iWell = i;
+        else if (equalsCI(f[i], "layoutrow"))             iRow  = i;
+        else if (equalsCI(f[i], "layoutcol"))             iCol  = i;
+        else if (equalsCI(f[i], "layoutrole"))            iRole = i;
+        else if (equalsCI(f[i], "layoutcompoundinplate")) iCmpd = i;
+        else if (equalsCI(f[i], "layoutdilinplate"))      iDil  = i;
+    }
+
+    const char* dataStart = p;                      // after the header line
+    Schema schema = UnknownSchema;
+    int headerWells = 0;                            // <n> of a Legacy header
+    if (iWell >= 0 || iRow >= 0) {
+        if (iRole < 0 || (iWell < 0 && (iRow < 0 || iCol < 0)))
+            return fail(QObject::tr("The layout header has no role or well column."));
+        schema = LayoutColumns;
+    } else {
+        // "<file>,<n>,user_layout" header, or straight into data
+        schema = Legacy;
+        int r0 = 0, c0 = 0;
+        if (nf >= 2 && parseWell(f[0], true, r0, c0) && roleOf(f[1]) != PlateWidget::None)
+            dataStart = lb;
+        else if (nf >= 3 && equalsCI(f[2], "user_layout"))
+            headerWells = toInt(f[1]);
+    }
+
+    /* ---- one pass over the data ---- */
+    QVector<Entry> entries;
+    entries.reserve(int(qMin<qsizetype>((end - dataStart) / 12 + 1, 1 << 20)));
+    int maxR = -1, maxC = -1;
+
+    const int need = schema == LayoutColumns
+        ? qMax(qMax(iWell, iRow), qMax(iCol, iRole)) + 1 : 2;
+
+    p = dataStart;
+    while (nextLine(p, end, lb, le)) {
+        if (isEmptyLine(lb, le)) continue;
+        nf = splitFields(lb, le, f, kMaxFields);
+        if (nf < 2) continue;
+
+        Entry e{ -1, -1, PlateWidget::WellData() };
+        if (schema == LayoutColumns) {
+            if (nf < qMin(need, kMaxFields)) continue;
+            const int row1 = iRow >= 0 ? toInt(f[iRow]) : 0;
+            const int col1 = iCol >= 0 ? toInt(f[iCol]) : 0;
+            if (row1 > 0 && col1 > 0) {
+                e.r0 = row1 - 1;
+                e.c0 = col1 - 1;
+            } else if (iWell < 0 || !parseWell(f[iWell], false, e.r0, e.c0)) {
+                continue;
+            }
+            e.wd.type = roleOf(f[iRole]);
+            if (e.wd.type == PlateWidget::Sample || e.wd.type == PlateWidget::Standard) {
+                e.wd.sampleId     = iCmpd >= 0 && iCmpd < nf ? toInt(f[iCmpd]) : 0;
+                e.wd.dilutionStep = iDil  >= 0 && iDil  < nf ? toInt(f[iDil])  : 0;
+            } else {
+                e.wd.sampleId     = 0;                  // DMSO/Void are always 0,0
+                e.wd.dilutionStep = 0;
+            }
+        } else {
+            if (!parseWell(f[0], true, e.r0, e.c0)) continue;
+            if (equalsCI(f[1], "sample") && nf >= 4) {
+                e.wd.type         = PlateWidget::Sample;
+                e.wd.sampleId     = toInt(f[2]);
+                e.wd.dilutionStep = toInt(f[3]);
+            } else if (equalsCI(f[1], "dmso")) {
+                e.wd.type = PlateWidget::DMSO;
+            } else if (equalsCI(f[1], "standard")) {
+                e.wd.type = PlateWidget::Standard;
+            }
+        }
+        maxR = qMax(maxR, e.r0);
+        maxC = qMax(maxC, e.c0);
+        entries.append(e);
+    }
+
+    /* ---- plate format ---- */
+    // Legacy files list only non-empty wells, so their format comes from the
+    // header; LayoutColumns files list every well, so the last one gives it
+    static const int kFormats[][2] = { {8, 12}, {16, 24}, {32, 48}, {48, 72} };
+    if (headerWells > 0 && rows > 0 && cols > 0 && headerWells != rows * cols)
+        return fail(QObject::tr("The file is for %1 wells, not %2.").arg(headerWells).arg(rows * cols));
+
+    if (rows <= 0 || cols <= 0) {
+        rows = cols = 0;
+        int fits = 0;
+        for (const auto& fmt : kFormats) {
+            if (headerWells > 0) {
+                if (fmt[0] * fmt[1] == headerWells) { rows = fmt[0]; cols = fmt[1]; }
+                continue;
+            }
+            if (maxR < fmt[0] && maxC < fmt[1] && fits++ == 0) { rows = fmt[0]; cols = fmt[1]; }
+        }
+        if (headerWells > 0 && rows == 0)
+            return fail(QObject::tr("%1 wells is not a known plate format.").arg(headerWells));
+        if (rows == 0)
+            return fail(QObject::tr("Well %1/%2 is outside every known plate format.")
+                            .arg(maxR + 1).arg(maxC + 1));
+        if (headerWells == 0) {
+            const bool complete = schema == LayoutColumns && maxR == rows - 1 && maxC == cols - 1;
+            if (!complete && fits > 1)
+                return fail(QObject::tr("The plate format cannot be told from the file; "
+                                        "give the number of rows and columns."));
+        }
+    }
+
+    out.rows   = rows;
+    out.cols   = cols;
+    out.schema = schema;
+    out.wells  = QVector<PlateWidget::WellData>(rows * cols);
+    for (const Entry& e : std::as_const(entries))
+        if (e.r0 < rows && e.c0 < cols)             // wells off the plate are ignored
+            out.wells[e.r0 * cols + e.c0] = e.wd;
+    return true;
+}
+
+bool PlateLayoutCodec::read(const QString& path, int rows, int cols,
+                            Layout& out, QString* errorMsg)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) {
+        if (errorMsg) *errorMsg = QObject::tr("Cannot open %1: %2").arg(path, f.errorString());
+        return false;
+    }
+    const qint64 size = f.size();
+    if (size > 0) {
+        if (uchar* m = f.map(0, size)) {
+            const bool ok = parse(reinterpret_cast<const char*>(m), size, rows, cols, out, errorMsg);
+            f.unmap(m);
+            return ok;
+        }
+    }
+    const QByteArray all = f.readAll();             // not mappable (pipe, some network shares)
+    return parse(all.constData(), all.size(), rows, cols, out, errorMsg);
+}
+
+QByteArray PlateLayoutCodec::encode(const Layout& layout, const QString& fileName)
+{
+    const int rows = layout.rows, cols = layout.cols;
+    QByteArray out;
+
+    if (layout.schema == Legacy) {
+        out.reserve(64 + rows * cols * 16);
+        out.append(fileName.toUtf8()).append(',');
+        appendInt(out, rows * cols);
+        out.append(",user_layout\n");
+        for (int i = 0; i < layout.wells.size(); ++i) {
+            const auto& wd = layout.wells[i];
+            if (wd.type == PlateWidget::None) continue;
+            appendRow(out, i / cols, true);
+            appendInt(out, i % cols + 1, 2);
+            switch (wd.type) {
+            case PlateWidget::Sample:
+                out.append(",SAMPLE,");
+                appendInt(out, wd.sampleId);
+                out.append(',');
+                appendInt(out, wd.dilutionStep);
+                break;
+            case PlateWidget::DMSO:     out.append(",DMSO");     break;
+            case PlateWidget::Standard: out.append(",STANDARD"); break;
+            default: break;
+            }
+            out.append('\n');
+        }
+        return out;
+    }
+
+    // Every well, Void for empty ones; Standard carries id/dil like Sample
+    out.reserve(96 + rows * cols * 28);
+    out.append(";;;;;;\n"
+               "layoutWell,layoutRow,layoutCol,layoutRole,layoutCompoundInPlate,layoutDilInPlate\n");
+    for (int r0 = 0; r0 < rows; ++r0) {
+        for (int c0 = 0; c0 < cols; ++c0) {
+            const int idx = r0 * cols + c0;
+            const PlateWidget::WellData wd = idx < layout.wells.size() ? layout.wells[idx]
+                                                                       : PlateWidget::WellData();
+            appendRow(out, r0, false);
+            appendInt(out, c0 + 1, 2);
+            out.append(',');
+            appendInt(out, r0 + 1);
+            out.append(',');
+            appendInt(out, c0 + 1);
+            switch (wd.type) {
+            case PlateWidget::Sample:   out.append(",sample,");   break;
+            case PlateWidget::Standard: out.append(",standard,"); break;
+            case PlateWidget::DMSO:     out.append(",placebo,");  break;
+            default:                    out.append(",Void,");     break;
+            }
+            if (wd.type == PlateWidget::Sample || wd.type == PlateWidget::Standard) {
+                appendInt(out, wd.sampleId);
+                out.append(',');
+                appendInt(out, wd.dilutionStep);
+            } else {
+                out.append("0,0");
+            }
+            out.append('\n');
+        }
+    }
+    return out;
+}
+
+bool PlateLayoutCodec::write(const QString& path, const Layout& layout, QString* errorMsg)
+{
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly)
+        || f.write(encode(layout, QFileInfo(path).fileName())) < 0
+        || !f.commit()) {
+        if (errorMsg) *errorMsg = QObject::tr("Cannot write %1: %2").arg(path, f.errorString());
+        return false;
+    }
+    return true;
+}
+
+PlateLayoutFolderImport::PlateLayoutFolderImport(QObject* parent)
+    : QObject(parent)
+{
+}
+
+PlateLayoutFolderImport::~PlateLayoutFolderImport()
+{
+    cancel();
+    m_pool.waitForDone();
+}
+
+int PlateLayoutFolderImport::start(const QString& dir, int rows, int cols,
+                                   const QString& convertTo, int maxThreads)
+{
+    const QDir src(dir);
+    const QStringList names = src.entryList({ QStringLiteral("*.csv") },
+                                            QDir::Files | QDir::Readable, QDir::Name);
+    if (!convertTo.isEmpty())
+        QDir().mkpath(convertTo);
+
+    m_cancelled = false;
+    m_total     = names.size();
+    m_done      = 0;
+    m_succeeded = 0;
+    if (m_total == 0) {
+        QMetaObject::invokeMethod(this, [this]() { emit finished(0, 0); }, Qt::QueuedConnection);
+        return 0;
+    }
+
+    m_pool.setMaxThreadCount(maxThreads > 0 ? maxThreads : QThread::idealThreadCount());
+    for (const QString& name : names) {
+        const QString path = src.filePath(name);
+        const QString target = convertTo.isEmpty() ? QString() : QDir(convertTo).filePath(name);
+        m_pool.start([this, path, target, rows, cols]() {
+            Result res;
+            res.path = path;
+            PlateLayoutCodec::Layout layout;
+            if (m_cancelled) {
+                res.error = QObject::tr("Cancelled");
+            } else if (PlateLayoutCodec::read(path, rows, cols, layout, &res.error)) {
+                layout.schema = PlateLayoutCodec::LayoutColumns;
+                res.ok = target.isEmpty() || PlateLayoutCodec::write(target, layout, &res.error);
+            }
+            QMetaObject::invokeMethod(this, [this, res]() { fileDone(res); }, Qt::QueuedConnection);
+        });
+    }
+    return m_total;
+}
+
+void PlateLayoutFolderImport::fileDone(const Result& result)
+{
+    ++m_done;
+    if (result.ok) ++m_succeeded;
+    emit fileFinished(m_done, m_total, result);
+    if (m_done == m_total)
+        emit finished(m_succeeded, m_total);
+}
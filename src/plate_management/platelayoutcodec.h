@@ -0,0 +1,87 @@
+#ifndef PLATELAYOUTCODEC_H
+#define PLATELAYOUTCODEC_H
+
+#pragma once
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+#include <atomic>
+#include "PlateWidget.h"
+
+// Plate-layout CSV files without QTextStream / QStringList: the file is
+// memory-mapped, the schema is detected once from the first lines and the
+// rest is parsed in a single pass over the bytes.
+//
+// LayoutColumns (written by the plate map dialog):
+//   ;;;;;;
+//   layoutWell,layoutRow,layoutCol,layoutRole,layoutCompoundInPlate,layoutDilInPlate
+//   A01,1,1,sample,3,2
+// Legacy (first plate map / 1536 dialog):
+//   <file>,<wells>,user_layout
+//   AA01,SAMPLE,3,2
+class PlateLayoutCodec {
+public:
+    enum Schema { UnknownSchema, LayoutColumns, Legacy };
+
+    struct Layout {
+        int rows = 0;
+        int cols = 0;
+        Schema schema = UnknownSchema;
+        QVector<PlateWidget::WellData> wells;   // rows * cols, row-major
+    };
+
+    // rows/cols of 0: the <wells> of a Legacy header, else (LayoutColumns,
+    // which lists every well) the 96/384/1536/3456 format whose last well
+    // is present; fails when the format cannot be told
+    static bool parse(const char* data, qsizetype size, int rows, int cols,
+                      Layout& out, QString* errorMsg = nullptr);
+    static bool read(const QString& path, int rows, int cols,
+                     Layout& out, QString* errorMsg = nullptr);
+
+    // Legacy writes only non-empty wells; `fileName` goes into its header
+    static QByteArray encode(const Layout& layout, const QString& fileName = QString());
+    static bool write(const QString& path, const Layout& layout, QString* errorMsg = nullptr);
+};
+
+// Every *.csv in a folder, parsed on a thread pool without blocking the
+// caller. Each file is reported with fileFinished() as soon as it is done
+// (only its path and status; the decoded layout is dropped), finished()
+// follows once all are.
+class PlateLayoutFolderImport : public QObject {
+    Q_OBJECT
+
+public:
+    struct Result {
+        QString path;
+        QString error;
+        bool ok = false;
+    };
+
+    explicit PlateLayoutFolderImport(QObject* parent = nullptr);
+    ~PlateLayoutFolderImport() override;    // cancels and waits for running files
+
+    // Returns the number of files queued. With `convertTo` set each layout
+    // is written there as LayoutColumns.
+    int start(const QString& dir, int rows = 0, int cols = 0,
+              const QString& convertTo = QString(), int maxThreads = 0);
+    // Files not started yet are reported as cancelled
+    void cancel() { m_cancelled = true; }
+
+signals:
+    void fileFinished(int done, int total, const PlateLayoutFolderImport::Result& result);
+    void finished(int succeeded, int total);
+
+private:
+    void fileDone(const Result& result);
+
+    QThreadPool       m_pool;
+    std::atomic<bool> m_cancelled{ false };
+    int               m_total = 0;
+    int               m_done = 0;
+    int               m_succeeded = 0;
+};
+
+#endif // PLATELAYOUTCODEC_H
@@ -0,0 +1,231 @@
+#include "platelayoutlibrary.h"
+#include "common/SqlPattern.h"
+
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QPainter>
+#include <QSet>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QVariant>
+#include <QtEndian>
+
+#include <cstring>
+
+namespace {
+
+constexpr char kMagic[4] = { 'P', 'L', 'L', '1' };
+constexpr int kHeaderBytes = 8;         // magic, rows (u16), cols (u16)
+constexpr int kThumbWidth = 96;
+
+} // namespace
+
+QByteArray PlateLayoutLibrary::pack(int rows, int cols,
+                                    const QVector<PlateWidget::WellData>& wells)
+{
+    const int n = rows * cols;
+    QByteArray out(kHeaderBytes + n * 4, Qt::Uninitialized);
+    uchar* p = reinterpret_cast<uchar*>(out.data());
+    memcpy(p, kMagic, 4);
+    qToLittleEndian<quint16>(quint16(rows), p + 4);
+    qToLittleEndian<quint16>(quint16(cols), p + 6);
+    p += kHeaderBytes;
+    for (int i = 0; i < n; ++i, p += 4)
+        qToLittleEndian<quint32>(i < wells.size() ? PlateWidget::pack(wells[i]) : 0, p);
+    return out;
+}
+
+bool PlateLayoutLibrary::unpack(const QByteArray& packed, int& rows, int& cols,
+                                QVector<PlateWidget::WellData>& wells)
+{
+    if (packed.size() < kHeaderBytes || memcmp(packed.constData(), kMagic, 4) != 0)
+        return false;
+    const uchar* p = reinterpret_cast<const uchar*>(packed.constData());
+    rows = qFromLittleEndian<quint16>(p + 4);
+    cols = qFromLittleEndian<quint16>(p + 6);
+    const int n = rows * cols;
+    if (n <= 0 || packed.size() != kHeaderBytes + n * 4)
+        return false;
+
+    wells.resize(n);
+    p += kHeaderBytes;
+    for (int i = 0; i < n; ++i, p += 4)
+        wells[i] = PlateWidget::unpack(qFromLittleEndian<quint32>(p));
+    return true;
+}
+
+QString PlateLayoutLibrary::contentHash(const QByteArray& packed)
+{
+    return QString::fromLatin1(
+        QCryptographicHash::hash(packed, QCryptographicHash::Sha256).toHex());
+}
+
+QImage PlateLayoutLibrary::renderThumbnail(int rows, int cols,
+                                           const QVector<PlateWidget::WellData>& wells)
+{
+    const int px = qMax(2, kThumbWidth / qMax(1, cols));
+    const int gap = px >= 4 ? 1 : 0;
+    QImage img(cols * px, rows * px, QImage::Format_RGB32);
+    img.fill(QColor(190, 190, 190));
+
+    QPainter p(&img);
+    for (int i = 0; i < rows * cols && i < wells.size(); ++i)
+        p.fillRect((i % cols) * px, (i / cols) * px, px - gap, px - gap,
+                   PlateWidget::wellColor(wells[i], cols));
+    return img;
+}
+
+bool PlateLayoutLibrary::list(const Filter& filter, int limit,
+                              QVector<Summary>& out, QString* errorMsg)
+{
+    out.clear();
+    limit = qMax(1, limit);
+
+    QStringList where;
+    if (filter.rows > 0 && filter.cols > 0) where << "plate_rows = :rows AND plate_cols = :cols";
+    if (!filter.name.trimmed().isEmpty())   where << "name ILIKE :name";
+    if (filter.minSamples > 0)              where << "sample_count >= :samples";
+    if (filter.minDilutionDepth > 0)        where << "dilution_depth >= :depth";
+
+    const QString sql = QString("SELECT layout_id, name, created_by, created_at, plate_rows, plate_cols, "
+                                "sample_count, dilution_depth, standard_wells, dmso_wells, used_wells, "
+                                "thumbnail FROM plate_layouts %1 "
+                                "ORDER BY created_at DESC, layout_id DESC LIMIT %2")
+                            .arg(where.isEmpty() ? QString() : "WHERE " + where.join(" AND "))
+                            .arg(limit);
+
+    QSqlQuery q;
+    q.setForwardOnly(true);
+    q.prepare(sql);
+    if (filter.rows > 0 && filter.cols > 0) {
+        q.bindValue(":rows", filter.rows);
+        q.bindValue(":cols", filter.cols);
+    }
+    if (!filter.name.trimmed().isEmpty()) q.bindValue(":name",    likePattern(filter.name));
+    if (filter.minSamples > 0)            q.bindValue(":samples", filter.minSamples);
+    if (filter.minDilutionDepth > 0)      q.bindValue(":depth",   filter.minDilutionDepth);
+
+    if (!q.exec()) {
+        if (errorMsg) *errorMsg = q.lastError().text();
+        return false;
+    }
+
+    out.reserve(limit);
+    while (q.next()) {
+        Summary s;
+        s.layoutId      = q.value(0).toInt();
+        s.name          = q.value(1).toString();
+        s.createdBy     = q.value(2).toString();
+        s.createdAt     = q.value(3).toDateTime();
+        s.rows          = q.value(4).toInt();
+        s.cols          = q.value(5).toInt();
+        s.sampleCount   = q.value(6).toInt();
+        s.dilutionDepth = q.value(7).toInt();
+        s.standardWells = q.value(8).toInt();
+        s.dmsoWells     = q.value(9).toInt();
+        s.usedWells     = q.value(10).toInt();
+        s.thumbnail.loadFromData(q.value(11).toByteArray(), "PNG");
+        out.push_back(s);
+    }
+    return true;
+}
+
+bool PlateLayoutLibrary::load(int layoutId, int& rows, int& cols,
+                              QVector<PlateWidget::WellData>& wells,
+                              QString* errorMsg)
+{
+    QSqlQuery q;
+    q.prepare("SELECT data FROM plate_layouts WHERE layout_id = :id");
+    q.bindValue(":id", layoutId);
+
+    if (!q.exec()) {
+        if (errorMsg) *errorMsg = q.lastError().text();
+        return false;
+    }
+    if (!q.next()) {
+        if (errorMsg) *errorMsg = QString("Layout %1 not found").arg(layoutId);
+        return false;
+    }
+    if (!unpack(qUncompress(q.value(0).toByteArray()), rows, cols, wells)) {
+        if (errorMsg) *errorMsg = QString("Layout %1 is damaged").arg(layoutId);
+        return false;
+    }
+    return true;
+}
+
+bool PlateLayoutLibrary::save(const QString& name, const QString& createdBy,
+                              int rows, int cols,
+                              const QVector<PlateWidget::WellData>& wells,
+                              SaveResult* result,
+                              QString* errorMsg)
+{
+    const QByteArray packed = pack(rows, cols, wells);
+
+    QSet<int> samples;
+    int depth = 0, standards = 0, dmso = 0, used = 0;
+    for (int i = 0; i < rows * cols && i < wells.size(); ++i) {
+        const auto& wd = wells[i];
+        switch (wd.type) {
+        case PlateWidget::Sample:
+            samples.insert(wd.sampleId);
+            depth = qMax(depth, wd.dilutionStep);
+            break;
+        case PlateWidget::Standard: ++standards; break;
+        case PlateWidget::DMSO:     ++dmso;      break;
+        default:                    continue;
+        }
+        ++used;
+    }
+
+    QByteArray png;
+    QBuffer buf(&png);
+    buf.open(QIODevice::WriteOnly);
+    renderThumbnail(rows, cols, wells).save(&buf, "PNG");
+
+    // insert, or return the row that already holds this content
+    QSqlQuery q;
+    q.prepare(R"(
+        WITH ins AS (
+            INSERT INTO plate_layouts
+                   (content_hash, name, created_by, plate_rows, plate_cols, sample_count,
+                    dilution_depth, standard_wells, dmso_wells, used_wells, data, thumbnail)
+            VALUES (:hash, :name, :user, :rows, :cols, :samples,
+                    :depth, :standards, :dmso, :used, :data, :thumb)
+            ON CONFLICT (content_hash) DO NOTHING
+            RETURNING layout_id, name)
+        SELECT layout_id, name, false FROM ins
+        UNION ALL
+        SELECT layout_id, name, true FROM plate_layouts WHERE content_hash = :hash2
+        LIMIT 1)");
+    const QString hash = contentHash(packed);
+    q.bindValue(":hash",      hash);
+    q.bindValue(":name",      name.trimmed());
+    q.bindValue(":user",      createdBy);
+    q.bindValue(":rows",      rows);
+    q.bindValue(":cols",      cols);
+    q.bindValue(":samples",   samples.size());
+    q.bindValue(":depth",     depth);
+    q.bindValue(":standards", standards);
+    q.bindValue(":dmso",      dmso);
+    q.bindValue(":used",      used);
+    q.bindValue(":data",      qCompress(packed, 9));
+    q.bindValue(":thumb",     png);
+    q.bindValue(":hash2",     hash);
+
+    if (!q.exec()) {
+        if (errorMsg) *errorMsg = q.lastError().text();
+        return false;
+    }
+    if (!q.next()) {
+        // a concurrent save of the same layout committed after our snapshot
+        if (errorMsg) *errorMsg = "The layout was saved by someone else at the same time; please try again.";
+        return false;
+    }
+    if (result) {
+        result->layoutId     = q.value(0).toInt();
+        result->existed      = q.value(2).toBool();
+        result->existingName = result->existed ? q.value(1).toString() : QString();
+    }
+    return true;
+}
@@ -0,0 +1,78 @@
+#ifndef PLATELAYOUTLIBRARY_H
+#define PLATELAYOUTLIBRARY_H
+
+#pragma once
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QImage>
+#include <QString>
+#include <QVector>
+#include "PlateWidget.h"
+
+// The `plate_layouts` table (default DB connection, sql/migrations/004).
+//
+// A layout is stored once per content: the key is the SHA-256 of its
+// canonical packed form (format + 4 bytes per well, empty wells zeroed),
+// so saving an identical layout again returns the existing row. The wells
+// are kept qCompress'd; format, sample count and dilution depth are plain
+// indexed columns and a thumbnail is rendered once at save time, so the
+// picker never decodes a layout it does not open.
+class PlateLayoutLibrary {
+public:
+    struct Summary {
+        int       layoutId = -1;
+        QString   name;
+        QString   createdBy;
+        QDateTime createdAt;
+        int       rows = 0;
+        int       cols = 0;
+        int       sampleCount = 0;      // distinct sample ids
+        int       dilutionDepth = 0;    // highest dilution step
+        int       standardWells = 0;
+        int       dmsoWells = 0;
+        int       usedWells = 0;
+        QImage    thumbnail;
+    };
+
+    // Empty / zero fields are ignored; the name matches case-insensitively.
+    struct Filter {
+        int     rows = 0;
+        int     cols = 0;
+        QString name;
+        int     minSamples = 0;
+        int     minDilutionDepth = 0;
+    };
+
+    struct SaveResult {
+        int  layoutId = -1;
+        bool existed = false;           // same content was already stored
+        QString existingName;           // its name if so
+    };
+
+    // Newest first, at most `limit` rows; reads metadata and thumbnails only.
+    static bool list(const Filter& filter, int limit,
+                     QVector<Summary>& out, QString* errorMsg = nullptr);
+
+    static bool load(int layoutId, int& rows, int& cols,
+                     QVector<PlateWidget::WellData>& wells,
+                     QString* errorMsg = nullptr);
+
+    static bool save(const QString& name, const QString& createdBy,
+                     int rows, int cols,
+                     const QVector<PlateWidget::WellData>& wells,
+                     SaveResult* result = nullptr,
+                     QString* errorMsg = nullptr);
+
+    // Canonical packed form and its hash (hex SHA-256)
+    static QByteArray pack(int rows, int cols, const QVector<PlateWidget::WellData>& wells);
+    static bool unpack(const QByteArray& packed, int& rows, int& cols,
+                       QVector<PlateWidget::WellData>& wells);
+    static QString contentHash(const QByteArray& packed);
+
+    // About 96 px wide whatever the format, in the plate widget's colours
+    static QImage renderThumbnail(int rows, int cols,
+                                  const QVector<PlateWidget::WellData>& wells);
+};
+
+#endif // PLATELAYOUTLIBRARY_H
@@ -0,0 +1,143 @@
+#include "platelayoutpickerdialog.h"
+
+#include <QDialogButtonBox>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QMessageBox>
+#include <QPixmap>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTimer>
+#include <QVBoxLayout>
+
+PlateLayoutPickerDialog::PlateLayoutPickerDialog(int rows, int cols, QWidget* parent)
+    : QDialog(parent)
+    , m_rows(rows)
+    , m_cols(cols)
+{
+    setWindowTitle(QString("Layout Library (%1 wells)").arg(rows * cols));
+    resize(760, 520);
+
+    // Filters
+    m_nameEdit = new QLineEdit(this);
+    m_nameEdit->setPlaceholderText("Name contains…");
+    m_nameEdit->setClearButtonEnabled(true);
+
+    m_minSamplesSpin = new QSpinBox(this);
+    m_minSamplesSpin->setRange(0, rows * cols);
+    m_minSamplesSpin->setSpecialValueText("any");
+
+    m_minDepthSpin = new QSpinBox(this);
+    m_minDepthSpin->setRange(0, 255);
+    m_minDepthSpin->setSpecialValueText("any");
+
+    m_filterTimer = new QTimer(this);
+    m_filterTimer->setSingleShot(true);
+    m_filterTimer->setInterval(250);
+    connect(m_filterTimer, &QTimer::timeout, this, &PlateLayoutPickerDialog::reload);
+    connect(m_nameEdit, &QLineEdit::textChanged,
+            m_filterTimer, QOverload<>::of(&QTimer::start));
+    connect(m_minSamplesSpin, QOverload<int>::of(&QSpinBox::valueChanged),
+            m_filterTimer, QOverload<>::of(&QTimer::start));
+    connect(m_minDepthSpin, QOverload<int>::of(&QSpinBox::valueChanged),
+            m_filterTimer, QOverload<>::of(&QTimer::start));
+
+    auto filterLayout = new QHBoxLayout;
+    filterLayout->addWidget(m_nameEdit, 1);
+    filterLayout->addWidget(new QLabel("Min. samples:", this));
+    filterLayout->addWidget(m_minSamplesSpin);
+    filterLayout->addWidget(new QLabel("Min. dilution steps:", this));
+    filterLayout->addWidget(m_minDepthSpin);
+
+    // Thumbnails
+    m_list = new QListWidget(this);
+    m_list->setViewMode(QListView::IconMode);
+    m_list->setResizeMode(QListView::Adjust);
+    m_list->setMovement(QListView::Static);
+    m_list->setUniformItemSizes(true);
+    m_list->setIconSize(QSize(144, 96));
+    m_list->setSpacing(6);
+    m_list->setWordWrap(true);
+    connect(m_list, &QListWidget::itemDoubleClicked, this, &PlateLayoutPickerDialog::onOpen);
+    connect(m_list, &QListWidget::currentRowChanged, this, [this](int row) {
+        m_openBtn->setEnabled(row >= 0);
+    });
+
+    m_status = new QLabel(this);
+
+    auto buttons = new QDialogButtonBox(QDialogButtonBox::Cancel, this);
+    m_openBtn = buttons->addButton("Open", QDialogButtonBox::AcceptRole);
+    m_openBtn->setEnabled(false);
+    connect(m_openBtn, &QPushButton::clicked, this, &PlateLayoutPickerDialog::onOpen);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+    auto bottomLayout = new QHBoxLayout;
+    bottomLayout->addWidget(m_status, 1);
+    bottomLayout->addWidget(buttons);
+
+    auto mainLayout = new QVBoxLayout;
+    mainLayout->addLayout(filterLayout);
+    mainLayout->addWidget(m_list);
+    mainLayout->addLayout(bottomLayout);
+    setLayout(mainLayout);
+
+    reload();
+}
+
+void PlateLayoutPickerDialog::reload()
+{
+    PlateLayoutLibrary::Filter filter;
+    filter.rows             = m_rows;
+    filter.cols             = m_cols;
+    filter.name             = m_nameEdit->text();
+    filter.minSamples       = m_minSamplesSpin->value();
+    filter.minDilutionDepth = m_minDepthSpin->value();
+
+    QString err;
+    if (!PlateLayoutLibrary::list(filter, kPageSize, m_summaries, &err)) {
+        m_summaries.clear();
+        m_list->clear();
+        m_status->setText("Could not read the layout library: " + err);
+        return;
+    }
+
+    m_list->setUpdatesEnabled(false);
+    m_list->clear();
+    for (const auto& s : m_summaries) {
+        auto item = new QListWidgetItem(
+            QIcon(QPixmap::fromImage(s.thumbnail)),
+            QString("%1\n%2 samples · %3 steps").arg(s.name).arg(s.sampleCount).arg(s.dilutionDepth),
+            m_list);
+        item->setToolTip(QString("%1\n%2 used wells (%3 standard, %4 DMSO)\n%5, %6")
+                             .arg(s.name)
+                             .arg(s.usedWells).arg(s.standardWells).arg(s.dmsoWells)
+                             .arg(s.createdBy, s.createdAt.toString("yyyy-MM-dd HH:mm")));
+    }
+    m_list->setUpdatesEnabled(true);
+
+    m_status->setText(m_summaries.size() == kPageSize
+                          ? QString("Newest %1 layouts — narrow the filter to see older ones").arg(kPageSize)
+                          : QString("%1 layout(s)").arg(m_summaries.size()));
+}
+
+void PlateLayoutPickerDialog::onOpen()
+{
+    const int row = m_list->currentRow();
+    if (row < 0 || row >= m_summaries.size()) return;
+    const auto& s = m_summaries[row];
+
+    int rows = 0, cols = 0;
+    QString err;
+    if (!PlateLayoutLibrary::load(s.layoutId, rows, cols, m_wells, &err)) {
+        QMessageBox::warning(this, "Error", err);
+        return;
+    }
+    if (rows != m_rows || cols != m_cols) {
+        QMessageBox::warning(this, "Error", "The stored layout has a different plate format.");
+        return;
+    }
+    m_selectedName = s.name;
+    accept();
+}
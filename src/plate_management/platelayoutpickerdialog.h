@@ -0,0 +1,55 @@
+#ifndef PLATELAYOUTPICKERDIALOG_H
+#define PLATELAYOUTPICKERDIALOG_H
+
+#pragma once
+
+#include <QDialog>
+#include <QVector>
+#include "PlateWidget.h"
+#include "platelayoutlibrary.h"
+
+class QLineEdit;
+class QSpinBox;
+class QListWidget;
+class QLabel;
+class QPushButton;
+class QTimer;
+
+// Library layouts of one plate format as thumbnails. Filters run on the
+// server against the indexed metadata; only the layout that is opened is
+// fetched and decoded.
+class PlateLayoutPickerDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    PlateLayoutPickerDialog(int rows, int cols, QWidget* parent = nullptr);
+
+    // valid after accept()
+    const QVector<PlateWidget::WellData>& selectedLayout() const { return m_wells; }
+    QString selectedName() const { return m_selectedName; }
+
+private slots:
+    void reload();
+    void onOpen();
+
+private:
+    static constexpr int kPageSize = 500;
+
+    int m_rows;
+    int m_cols;
+    QVector<PlateLayoutLibrary::Summary> m_summaries;
+
+    QLineEdit*   m_nameEdit;
+    QSpinBox*    m_minSamplesSpin;
+    QSpinBox*    m_minDepthSpin;
+    QListWidget* m_list;
+    QLabel*      m_status;
+    QPushButton* m_openBtn;
+    QTimer*      m_filterTimer;         // coalesces typing into one query
+
+    QVector<PlateWidget::WellData> m_wells;
+    QString m_selectedName;
+};
+
+#endif // PLATELAYOUTPICKERDIALOG_H
@@ -0,0 +1,80 @@
+#include "wellmask.h"
+
+WellMask::WellMask(int size)
+    : m_words((size + 63) / 64, 0)
+    , m_size(size)
+{
+}
+
+void WellMask::setRange(int begin, int end)
+{
+    if (begin >= end)
+        return;
+    const int wb = begin >> 6, we = (end - 1) >> 6;
+    const quint64 head = ~quint64(0) << (begin & 63);
+    const quint64 tail = ~quint64(0) >> (63 - ((end - 1) & 63));
+    if (wb == we) {
+        m_words[wb] |= head & tail;
+        return;
+    }
+    m_words[wb] |= head;
+    for (int w = wb + 1; w < we; ++w)
+        m_words[w] = ~quint64(0);
+    m_words[we] |= tail;
+}
+
+void WellMask::clear()
+{
+    m_words.fill(0);
+}
+
+bool WellMask::any() const
+{
+    for (quint64 w : m_words)
+        if (w)
+            return true;
+    return false;
+}
+
+int WellMask::count() const
+{
+    int n = 0;
+    for (quint64 w : m_words)
+        n += int(qPopulationCount(w));
+    return n;
+}
+
+WellMask WellMask::rect(int rows, int cols, int r0, int c0, int r1, int c1)
+{
+    WellMask m(rows * cols);
+    r0 = qMax(0, r0);
+    c0 = qMax(0, c0);
+    r1 = qMin(rows - 1, r1);
+    c1 = qMin(cols - 1, c1);
+    if (c0 > c1)
+        return m;
+    for (int r = r0; r <= r1; ++r)
+        m.setRange(r * cols + c0, r * cols + c1 + 1);
+    return m;
+}
+
+WellMask& WellMask::operator&=(const WellMask& o)
+{
+    for (int w = 0; w < m_words.size(); ++w)
+        m_words[w] &= o.m_words[w];
+    return *this;
+}
+
+WellMask& WellMask::operator|=(const WellMask& o)
+{
+    for (int w = 0; w < m_words.size(); ++w)
+        m_words[w] |= o.m_words[w];
+    return *this;
+}
+
+WellMask& WellMask::operator-=(const WellMask& o)
+{
+    for (int w = 0; w < m_words.size(); ++w)
+        m_words[w] &= ~o.m_words[w];
+    return *this;
+}
@@ -0,0 +1,55 @@
+#ifndef WELLMASK_H
+#define WELLMASK_H
+
+#pragma once
+
+#include <QVector>
+#include <QtAlgorithms>
+
+// One bit per well, row-major (index = row * cols + col). A rectangle is a
+// contiguous bit run per row, so selection, overlap tests and counts work a
+// 64-bit word at a time whatever the plate format.
+class WellMask {
+public:
+    WellMask() = default;
+    explicit WellMask(int size);
+
+    int size() const { return m_size; }
+    bool test(int i) const { return (m_words[i >> 6] >> (i & 63)) & 1; }
+    void set(int i)   { m_words[i >> 6] |=  (quint64(1) << (i & 63)); }
+    void reset(int i) { m_words[i >> 6] &= ~(quint64(1) << (i & 63)); }
+    void setRange(int begin, int end);          // [begin, end)
+    void clear();
+
+    bool any() const;
+    int count() const;
+
+    // rows r0..r1, columns c0..c1 (inclusive) of a rows x cols plate
+    static WellMask rect(int rows, int cols, int r0, int c0, int r1, int c1);
+
+    WellMask& operator&=(const WellMask& o);
+    WellMask& operator|=(const WellMask& o);
+    WellMask& operator-=(const WellMask& o);    // and-not
+    friend WellMask operator&(WellMask a, const WellMask& b) { return a &= b; }
+    friend WellMask operator|(WellMask a, const WellMask& b) { return a |= b; }
+    friend WellMask operator-(WellMask a, const WellMask& b) { return a -= b; }
+
+    // f(index) for every set bit, in ascending order
+    template <typename F>
+    void forEach(F f) const
+    {
+        for (int w = 0; w < m_words.size(); ++w) {
+            quint64 bits = m_words[w];
+            while (bits) {
+                f(w * 64 + int(qCountTrailingZeroBits(bits)));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+private:
+    QVector<quint64> m_words;
+    int m_size = 0;
+};
+
+#endif // WELLMASK_H
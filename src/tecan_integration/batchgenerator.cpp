@@ -0,0 +1,194 @@
+#include "batchgenerator.h"
+#include "gwljob.h"
+#include "gwlregistry.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QObject>
+#include <QRegularExpression>
+#include <QSet>
+#include <QTextStream>
+#include <QThread>
+
+BatchGenerator::BatchGenerator(QObject *parent)
+    : QObject(parent)
+{
+}
+
+BatchGenerator::~BatchGenerator()
+{
+    cancel();
+    pool_.waitForDone();
+}
+
+QString BatchGenerator::folderNameFor(const Input &input)
+{
+    QString name = input.experimentCode.trimmed();
+    if (name.isEmpty()) name = QString("experiment_%1").arg(input.experimentId);
+    static const QRegularExpression bad(QStringLiteral("[^A-Za-z0-9._-]"));
+    return name.replace(bad, QStringLiteral("_"));
+}
+
+QStringList BatchGenerator::folderNamesFor(const QVector<Input> &inputs)
+{
+    QStringList names;
+    QHash<QString, int> count;
+    for (const Input &in : inputs) {
+        names << folderNameFor(in);
+        ++count[names.last().toLower()];
+    }
+
+    QSet<QString> taken;
+    for (int i = 0; i < names.size(); ++i) {
+        QString name = names.at(i);
+        if (count.value(name.toLower()) > 1)
+            name += QString("_%1").arg(inputs.at(i).experimentId);
+        // the same experiment twice, or a code that already ends in _<id>
+        for (int k = 2; taken.contains(name.toLower()); ++k)
+            name = QString("%1_%2").arg(names.at(i)).arg(k);
+        taken.insert(name.toLower());
+        names[i] = name;
+    }
+    return names;
+}
+
+bool BatchGenerator::start(const QVector<Input> &inputs, const QString &rootDir)
+{
+    if (running_) return false;
+    running_   = true;
+    cancelled_ = false;
+    done_      = 0;
+    rootDir_   = rootDir;
+    summary_   = Summary();
+    summary_.items.resize(inputs.size());
+    total_.start();
+
+    const auto registry = GWLRegistry::shared();   // parsed once, before the workers start
+    pool_.setMaxThreadCount(maxThreads_ > 0 ? maxThreads_ : QThread::idealThreadCount());
+
+    if (inputs.isEmpty()) {
+        QMetaObject::invokeMethod(this, [this]{ itemDone(-1, Item()); }, Qt::QueuedConnection);
+        return true;
+    }
+
+    // one folder per experiment, so no two workers write into the same one
+    const QStringList folders = folderNamesFor(inputs);
+
+    for (int i = 0; i < inputs.size(); ++i) {
+        const Input in = inputs.at(i);
+        const QJsonObject overrides = overrides_;
+        const QString outputDir = QDir(rootDir).filePath(folders.at(i));
+        pool_.start([this, in, overrides, outputDir, registry, i]() {
+            Item it;
+            it.experimentId   = in.experimentId;
+            it.experimentCode = in.experimentCode;
+            it.outputDir      = outputDir;
+
+            QElapsedTimer t;
+            t.start();
+
+            if (cancelled_) {
+                it.error = QObject::tr("Cancelled");
+            } else if (in.json.isEmpty()) {
+                it.error = QObject::tr("Experiment data is empty or not valid JSON");
+            } else {
+                QJsonObject exp = in.json;
+                for (auto o = overrides.constBegin(); o != overrides.constEnd(); ++o)
+                    exp.insert(o.key(), o.value());
+
+                const auto generator = GWLGenerator::forExperiment(exp);
+                generator->setRegistry(registry);
+
+                GwlJob::Result job;
+                QString err;
+                QDir old(it.outputDir);          // a previous run's files are dropped first
+                if (!GwlJob::run(*generator, exp, job, &err)) {
+                    it.error = err;
+                } else if (old.exists() && !old.removeRecursively()) {
+                    it.error = QObject::tr("Cannot clear %1").arg(it.outputDir);
+                } else if (!GWLGenerator::saveMany(it.outputDir, job.outs, &err)) {
+                    it.error = err;
+                } else {
+                    it.ok         = true;
+                    it.files      = job.outs.size();
+                    it.violations = job.validation.violations.size();
+                    it.runSeconds = job.runTime.totalSeconds;
+                }
+            }
+            it.elapsedMs = t.elapsed();
+
+            QMetaObject::invokeMethod(this, [this, i, it]{ itemDone(i, it); },
+                                      Qt::QueuedConnection);
+        });
+    }
+    return true;
+}
+
+void BatchGenerator::cancel()
+{
+    cancelled_ = true;
+}
+
+void BatchGenerator::itemDone(int index, const Item &item)
+{
+    const int total = summary_.items.size();
+    if (index >= 0) {
+        summary_.items[index] = item;
+        ++done_;
+        emit itemFinished(done_, total, item);
+    }
+    if (done_ < total) return;
+
+    summary_.elapsedMs = total_.elapsed();
+    running_ = false;
+
+    // Summary next to the experiment folders
+    QDir().mkpath(rootDir_);
+    QFile f(QDir(rootDir_).filePath(QStringLiteral("batch_summary.csv")));
+    if (f.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        QTextStream ts(&f);
+        for (const auto &ln : summary_.toCsv()) ts << ln << "\n";
+    }
+    emit finished(summary_);
+}
+
+int BatchGenerator::Summary::succeeded() const
+{
+    int n = 0;
+    for (const auto &it : items) if (it.ok) ++n;
+    return n;
+}
+
+QString BatchGenerator::Summary::text() const
+{
+    QString s = QObject::tr("%1 of %2 experiment(s) generated in %3 s.")
+                    .arg(succeeded()).arg(items.size())
+                    .arg(elapsedMs / 1000.0, 0, 'f', 1);
+    for (const auto &it : items) {
+        if (!it.ok)
+            s += QObject::tr("\n- %1: %2").arg(it.experimentCode, it.error);
+        else if (it.violations > 0)
+            s += QObject::tr("\n- %1: %2 validation issue(s)").arg(it.experimentCode).arg(it.violations);
+    }
+    return s;
+}
+
+QStringList BatchGenerator::Summary::toCsv() const
+{
+    QStringList L;
+    L << "ExperimentID,ExperimentCode,Status,Files,ValidationIssues,EstimatedRun_s,Generation_ms,Output,Error";
+    for (const auto &it : items)
+        L << QString("%1,%2,%3,%4,%5,%6,%7,%8,%9")
+                 .arg(it.experimentId)
+                 .arg(it.experimentCode)
+                 .arg(it.ok ? "ok" : "error")
+                 .arg(it.files)
+                 .arg(it.violations)
+                 .arg(QString::number(it.runSeconds, 'f', 0))
+                 .arg(it.elapsedMs)
+                 .arg(it.outputDir)
+                 .arg(QString(it.error).replace(',', ';'));
+    return L;
+}
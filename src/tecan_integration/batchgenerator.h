@@ -0,0 +1,101 @@
+#ifndef BATCHGENERATOR_H
+#define BATCHGENERATOR_H
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+
+#include <atomic>
+
+/**
+ * Generates the worklists of many experiments in one go.
+ *
+ * The caller passes the experiment JSON in (the GUI reads it through
+ * ExperimentStore); they are generated concurrently on a thread pool in the
+ * background, all generators sharing the read-only GWLRegistry. Each
+ * experiment replaces the contents of <root>/<experiment_code>/ (with
+ * "_<experiment_id>" appended when two codes sanitise to the same folder
+ * name) and is reported with itemFinished() as soon as it is done; finished() follows once all are,
+ * after the summary is written to <root>/batch_summary.csv.
+ */
+class BatchGenerator : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Input {
+        int         experimentId = -1;
+        QString     experimentCode;
+        QJsonObject json;
+    };
+
+    struct Item {
+        int     experimentId = -1;
+        QString experimentCode;
+        QString outputDir;
+        bool    ok          = false;
+        QString error;
+        int     files       = 0;
+        int     violations  = 0;
+        double  runSeconds  = 0.0;     // estimated robot time
+        qint64  elapsedMs   = 0;       // generation time
+    };
+
+    struct Summary {
+        QVector<Item> items;
+        qint64        elapsedMs = 0;
+
+        int succeeded() const;
+        QString text() const;
+        QStringList toCsv() const;
+    };
+
+    explicit BatchGenerator(QObject *parent = nullptr);
+    ~BatchGenerator() override;     // cancels and waits for running experiments
+
+    /** Keys copied into every experiment JSON (`_instrument`, options…). */
+    void setOverrides(const QJsonObject &overrides) { overrides_ = overrides; }
+
+    /** 0 = QThread::idealThreadCount(). */
+    void setMaxThreads(int n) { maxThreads_ = n; }
+
+    /** Starts the batch and returns at once; false if one is running. */
+    bool start(const QVector<Input> &inputs, const QString &rootDir);
+
+    /** Experiments not started yet are skipped (reported as cancelled);
+        the running ones finish. finished() is still emitted. */
+    void cancel();
+
+    bool isRunning() const { return running_; }
+
+    /** Folder name for one experiment: its code with characters other than
+        letters, digits, '.', '_' and '-' replaced by '_'. */
+    static QString folderNameFor(const Input &input);
+
+    /** folderNameFor() of every input, made unique (case-insensitively, for
+        Windows shares) by appending the experiment id where names collide. */
+    static QStringList folderNamesFor(const QVector<Input> &inputs);
+
+signals:
+    void itemFinished(int done, int total, const BatchGenerator::Item &item);
+    void finished(const BatchGenerator::Summary &summary);
+
+private:
+    void itemDone(int index, const Item &item);
+
+    QJsonObject       overrides_;
+    int               maxThreads_ = 0;
+    QThreadPool       pool_;
+    std::atomic<bool> cancelled_{ false };
+    bool              running_ = false;
+    int               done_    = 0;
+    QString           rootDir_;
+    Summary           summary_;
+    QElapsedTimer     total_;
+};
+
+#endif // BATCHGENERATOR_H
@@ -0,0 +1,147 @@
+#include "channelscheduler.h"
+
+#include <algorithm>
+
+namespace {
+
+// rows of 8 / 16 / 32 are 4 / 2 / 1 units apart; other formats count as 96
+int unitFor(int rows)
+{
+    return (rows >= 8 && rows <= 32 && 32 % rows == 0) ? 32 / rows : 4;
+}
+
+} // namespace
+
+ChannelScheduler::ChannelScheduler(int plateRows, int sourceRows)
+    : rows_(std::max(1, plateRows)),
+      srcRows_(sourceRows > 0 ? sourceRows : std::max(1, plateRows)),
+      unit_(unitFor(rows_)),
+      srcUnit_(unitFor(srcRows_))
+{
+}
+
+QVector<ChannelScheduler::Batch>
+ChannelScheduler::batchIndependent(const QVector<Transfer> &transfers) const
+{
+    // Transfers can share a batch when both wells sit in one column each and
+    // the source/destination offset (in pitch units) is identical; the tip is
+    // the destination row in tip pitches, so rows between two tips (384, 1536)
+    // never share a batch.
+    struct Group {
+        int srcCol = 0;
+        int dstCol = 0;
+        int offset = 0;
+        QVector<Batch> batches;
+        QVector<int>   masks;     // used channels per batch
+    };
+    QVector<Group> groups;
+    QVector<Batch> loose;         // unknown positions: one transfer per batch
+
+    for (const Transfer &t : transfers) {
+        if (t.srcPos < 1 || t.dstPos < 1) {
+            loose.push_back(Batch{ Slot{ t, 0 } });
+            continue;
+        }
+
+        const int srcCol  = srcColOf(t.srcPos);
+        const int dstCol  = colOf(t.dstPos);
+        const int offset  = yOf(t.dstPos) - srcYOf(t.srcPos);
+        const int channel = (yOf(t.dstPos) / kUnitsPerTip) % kChannels;
+
+        auto git = std::find_if(groups.begin(), groups.end(), [&](const Group &g){
+            return g.srcCol == srcCol && g.dstCol == dstCol && g.offset == offset;
+        });
+        if (git == groups.end()) {
+            Group g; g.srcCol = srcCol; g.dstCol = dstCol; g.offset = offset;
+            groups.push_back(g);
+            git = groups.end() - 1;
+        }
+
+        int b = 0;
+        while (b < git->masks.size() && (git->masks[b] & (1 << channel))) ++b;
+        if (b == git->masks.size()) {
+            git->batches.push_back({});
+            git->masks.push_back(0);
+        }
+        git->batches[b].push_back(Slot{ t, channel });
+        git->masks[b] |= (1 << channel);
+    }
+
+    QVector<Batch> out;
+    for (const Group &g : std::as_const(groups))
+        for (const Batch &b : g.batches) out.push_back(b);
+    for (const Batch &b : std::as_const(loose)) out.push_back(b);
+
+    // tips fire in channel order inside a batch
+    for (Batch &b : out)
+        std::sort(b.begin(), b.end(), [](const Slot &a, const Slot &c){
+            return a.channel < c.channel;
+        });
+    return out;
+}
+
+QVector<ChannelScheduler::ChainBlock>
+ChannelScheduler::batchChains(const QVector<Chain> &chains) const
+{
+    // Chains with the same shape (columns visited + row offsets from the
+    // start well, + the start row between tip pitches on 384/1536) move in
+    // lock-step; each one keeps the tip of its start row.
+    QVector<QVector<int>> blockShapes;
+    QVector<int>          blockMasks;
+    QVector<ChainBlock>   blocks;
+
+    for (int ci = 0; ci < chains.size(); ++ci) {
+        const Chain &c = chains[ci];
+        if (c.pos.size() < 2) continue;
+
+        const int row0 = rowOf(c.pos.first());
+        QVector<int> shape;
+        shape.reserve(c.pos.size() * 2 + 1);
+        shape << yOf(c.pos.first()) % kUnitsPerTip;
+        for (int p : c.pos) {
+            shape << colOf(p) << (rowOf(p) - row0);
+        }
+        const int channel = (yOf(c.pos.first()) / kUnitsPerTip) % kChannels;
+
+        int b = 0;
+        while (b < blocks.size() &&
+               (blockShapes[b] != shape || (blockMasks[b] & (1 << channel))))
+            ++b;
+        if (b == blocks.size()) {
+            blocks.push_back({});
+            blockShapes.push_back(shape);
+            blockMasks.push_back(0);
+        }
+        blocks[b].chains.push_back(ci);
+        blockMasks[b] |= (1 << channel);
+    }
+
+    for (ChainBlock &blk : blocks) {
+        const int nSteps = chains[blk.chains.first()].pos.size() - 1;
+        blk.steps.resize(nSteps);
+        for (int ci : std::as_const(blk.chains)) {
+            const Chain &c = chains[ci];
+            const int channel = (yOf(c.pos.first()) / kUnitsPerTip) % kChannels;
+            for (int s = 0; s < nSteps; ++s) {
+                Transfer t;
+                t.srcPos = c.pos[s];
+                t.dstPos = c.pos[s + 1];
+                t.volUL  = c.volUL;
+                t.tag    = c.tag;
+                blk.steps[s].push_back(Slot{ t, channel });
+            }
+        }
+        for (Batch &b : blk.steps)
+            std::sort(b.begin(), b.end(), [](const Slot &a, const Slot &c){
+                return a.channel < c.channel;
+            });
+    }
+    return blocks;
+}
+
+int ChannelScheduler::tipMask(const Batch &batch)
+{
+    int mask = 0;
+    for (const Slot &s : batch) mask |= (1 << s.channel);
+    return mask;
+}
@@ -0,0 +1,82 @@
+#ifndef CHANNELSCHEDULER_H
+#define CHANNELSCHEDULER_H
+
+#include <QVector>
+
+/**
+ * Groups single-tip transfers into batches the 8-channel Fluent LiHa can
+ * pipette in one arm movement.
+ *
+ * Positions are 1-based and column-major (A1=1, B1=2 … H12=96), exactly as
+ * the Fluent backend numbers daughter wells and matrix tubes. A batch only
+ * holds transfers whose tips keep the same row offset on the source and on
+ * the destination side, so the fixed tip pitch lines up on both racks.
+ * Each transfer is assigned one channel (0..7 -> tip 1..8).
+ *
+ * Rows are measured in quarters of the 9 mm tip pitch, so 384- and
+ * 1536-well plates (16 and 32 rows) work too: the tips of one batch sit on
+ * every second / fourth row there, and the channel is the row / 2 (/ 4).
+ */
+class ChannelScheduler
+{
+public:
+    static constexpr int kChannels = 8;
+
+    struct Transfer {
+        int    srcPos = 0;
+        int    dstPos = 0;
+        double volUL  = 0.0;
+        int    tag    = -1;      // caller data (index into the caller's hit list)
+    };
+
+    struct Slot {
+        Transfer transfer;
+        int      channel = 0;
+    };
+    using Batch = QVector<Slot>;
+
+    /** Serial-dilution chain: step i moves pos[i] -> pos[i+1]. */
+    struct Chain {
+        QVector<int> pos;
+        double       volUL = 0.0;
+        int          tag   = -1;
+    };
+
+    /** Chains sharing one set of tips; steps[i] is step i of every chain. */
+    struct ChainBlock {
+        QVector<int>   chains;   // indices into the input chain list
+        QVector<Batch> steps;
+    };
+
+    /** `plateRows` of the destination (and of the source in batchChains);
+        `sourceRows` of the source rack in batchIndependent, 0 = the same. */
+    explicit ChannelScheduler(int plateRows = 8, int sourceRows = 0);
+
+    /** Independent transfers from ONE source rack (e.g. compound seeding).
+        Batches come out in first-seen order of their column group. */
+    QVector<Batch> batchIndependent(const QVector<Transfer> &transfers) const;
+
+    /** Serial-dilution chains. Every chain keeps a single tip for all of its
+        steps, and step i of a chain is always emitted after step i-1. */
+    QVector<ChainBlock> batchChains(const QVector<Chain> &chains) const;
+
+    static int tipMask(const Batch &batch);
+
+    int rowOf(int pos) const { return (pos - 1) % rows_; }
+    int colOf(int pos) const { return (pos - 1) / rows_; }
+
+private:
+    static constexpr int kUnitsPerTip = 4;     // 9 mm = 4 x 2.25 mm (1536 pitch)
+
+    // row position in kUnitsPerTip-ths of the tip pitch
+    int yOf(int pos) const    { return rowOf(pos) * unit_; }
+    int srcYOf(int pos) const { return ((pos - 1) % srcRows_) * srcUnit_; }
+    int srcColOf(int pos) const { return (pos - 1) / srcRows_; }
+
+    int rows_    = 8;
+    int srcRows_ = 8;
+    int unit_    = kUnitsPerTip;
+    int srcUnit_ = kUnitsPerTip;
+};
+
+#endif // CHANNELSCHEDULER_H
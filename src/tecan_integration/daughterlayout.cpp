@@ -0,0 +1,456 @@
+#include "daughterlayout.h"
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QVariant>
+#include <QtAlgorithms>
+#include <algorithm>
+
+DaughterLayoutEngine::Reservation DaughterLayoutEngine::reservationForTest(const QString &testType)
+{
+    return testType.contains(QLatin1String("INV-T-031")) ? StandardDmsoColumns
+                                                         : StandardRowDmsoRow;
+}
+
+QString DaughterLayoutEngine::wellName(int row, int column)
+{
+    QString r;
+    if (row < 26) r = QChar('A' + row);
+    else          r = QString(QChar('A' + row / 26 - 1)) + QChar('A' + row % 26);   // AA, AB, …
+    return r + QString::number(column + 1);
+}
+
+bool DaughterLayoutEngine::parseWell(const QString &name, int &row, int &column)
+{
+    const QString s = name.trimmed().toUpper();
+    int i = 0, r = 0;
+    while (i < s.size() && s.at(i) >= 'A' && s.at(i) <= 'Z') {
+        r = r * 26 + (s.at(i).unicode() - 'A' + 1);     // A=1 … Z=26, AA=27
+        ++i;
+    }
+    if (i == 0 || i > 2 || i == s.size()) return false;
+
+    bool ok = false;
+    const int c = s.mid(i).toInt(&ok);
+    if (!ok || c < 1) return false;
+    row    = r - 1;
+    column = c - 1;
+    return true;
+}
+
+DaughterLayoutEngine::Format DaughterLayoutEngine::formatForWells(int wells)
+{
+    switch (wells) {
+    case 384:  return Format{ 16, 24 };
+    case 1536: return Format{ 32, 48 };
+    default:   return Format{};
+    }
+}
+
+DaughterLayoutEngine::Format DaughterLayoutEngine::formatOfPlate(const QJsonObject &plate)
+{
+    const int rows = plate.value("rows").toInt();
+    const int cols = plate.value("columns").toInt();
+    if (rows > 0 && cols > 0) return Format{ rows, cols };
+
+    int maxRow = 0, maxCol = 0;
+    const QJsonObject wells = plate.value("wells").toObject();
+    for (auto it = wells.constBegin(); it != wells.constEnd(); ++it) {
+        int r = 0, c = 0;
+        if (!parseWell(it.key(), r, c)) continue;
+        maxRow = qMax(maxRow, r);
+        maxCol = qMax(maxCol, c);
+    }
+    for (int n : { 96, 384 }) {
+        const Format f = formatForWells(n);
+        if (maxRow < f.rows && maxCol < f.columns) return f;
+    }
+    return formatForWells(1536);
+}
+
+double DaughterLayoutEngine::wellCapacityUL(const Format &format)
+{
+    const int wells = format.rows * format.columns;
+    return wells >= 1536 ? 12.0 : wells >= 384 ? 120.0 : 300.0;
+}
+
+namespace {
+
+using Engine = DaughterLayoutEngine;
+
+// `len` set bits starting at `col`
+inline quint64 runMask(int len, int col)
+{
+    return (len >= 64 ? ~quint64(0) : (quint64(1) << len) - 1) << col;
+}
+
+int longestFreeRun(quint64 used, int cols)
+{
+    int best = 0, run = 0;
+    for (int c = 0; c < cols; ++c) {
+        run = (used >> c) & 1 ? 0 : run + 1;
+        best = qMax(best, run);
+    }
+    return best;
+}
+
+// historical fill: down the rows of a column band, then the next band
+int packRowBands(const QVector<int> &lengths, int rowBegin, int rowEnd, int colEnd,
+                 QVector<Engine::Segment> &segments)
+{
+    int plate = 0, row = rowBegin, col = 0, bandWidth = 0;
+    for (int i = 0; i < lengths.size(); ++i) {
+        const int len = lengths.at(i);
+        if (col + len > colEnd) {                   // band does not fit: next plate
+            ++plate;
+            row = rowBegin;
+            col = 0;
+            bandWidth = 0;
+        }
+        segments[i] = Engine::Segment{ i, quint16(plate), quint8(row), quint8(col), quint8(len) };
+        bandWidth = qMax(bandWidth, len);
+
+        if (++row >= rowEnd) {
+            row  = rowBegin;
+            col += bandWidth;
+            bandWidth = 0;
+        }
+    }
+    return plate + 1;
+}
+
+// first free run of `len` wells, column by column, then row
+bool firstFit(QVector<quint64> &used, int rows, int cols, int len, int &row, int &col)
+{
+    for (int c = 0; c + len <= cols; ++c) {
+        const quint64 m = runMask(len, c);
+        for (int r = 0; r < rows; ++r) {
+            if (used.at(r) & m) continue;
+            used[r] |= m;
+            row = r;
+            col = c;
+            return true;
+        }
+    }
+    return false;
+}
+
+QVector<quint64> reservedMask(const Engine::Layout &lay)
+{
+    QVector<quint64> mask(lay.format.rows, 0);
+    for (const Engine::Well &w : lay.standardWells) mask[w.row] |= quint64(1) << w.column;
+    for (const Engine::Well &w : lay.dmsoWells)     mask[w.row] |= quint64(1) << w.column;
+    return mask;
+}
+
+bool sameWells(const QVector<Engine::Well> &a, const QVector<Engine::Well> &b)
+{
+    return std::equal(a.cbegin(), a.cend(), b.cbegin(), b.cend(),
+                      [](const Engine::Well &x, const Engine::Well &y) {
+                          return x.row == y.row && x.column == y.column;
+                      });
+}
+
+bool sameFrame(const Engine::Layout &a, const Engine::Layout &b)
+{
+    return a.format.rows == b.format.rows && a.format.columns == b.format.columns
+        && a.dilutionSteps == b.dilutionSteps
+        && sameWells(a.standardWells, b.standardWells)
+        && sameWells(a.dmsoWells, b.dmsoWells);
+}
+
+bool samePlace(const Engine::Segment &a, const Engine::Segment &b)
+{
+    return a.plate == b.plate && a.row == b.row && a.column == b.column && a.length == b.length;
+}
+
+// first-fit decreasing over the free wells of each plate (one bit per well)
+int packFirstFitDecreasing(const QVector<int> &lengths, const QVector<quint64> &reserved,
+                           int rows, int cols, QVector<Engine::Segment> &segments)
+{
+    QVector<int> order(lengths.size());
+    for (int i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+                     [&](int a, int b) { return lengths.at(a) > lengths.at(b); });
+
+    int freePerPlate = 0;
+    for (int r = 0; r < rows; ++r) freePerPlate += cols - int(qPopulationCount(reserved.at(r)));
+
+    struct Plate { QVector<quint64> used; int free; };
+    QVector<Plate> plates;
+    int firstOpen = 0;                              // plates before it cannot take any chain
+    const int shortest = lengths.isEmpty() ? 1
+                       : *std::min_element(lengths.cbegin(), lengths.cend());
+
+    auto tryPlace = [&](int p, int idx) -> bool {
+        Plate &pl = plates[p];
+        const int len = lengths.at(idx);
+        int r = 0, c = 0;
+        if (pl.free < len || !firstFit(pl.used, rows, cols, len, r, c)) return false;
+        pl.free -= len;
+        segments[idx] = Engine::Segment{ idx, quint16(p), quint8(r), quint8(c), quint8(len) };
+        return true;
+    };
+
+    for (int idx : std::as_const(order)) {
+        bool placed = false;
+        for (int p = firstOpen; p < plates.size() && !placed; ++p)
+            placed = tryPlace(p, idx);
+        if (!placed) {
+            plates.push_back(Plate{ reserved, freePerPlate });
+            tryPlace(plates.size() - 1, idx);       // fits: checked by the caller
+        }
+        while (firstOpen < plates.size() && plates.at(firstOpen).free < shortest) ++firstOpen;
+    }
+    return qMax(1, int(plates.size()));             // an empty layout still shows one plate
+}
+
+} // namespace
+
+bool DaughterLayoutEngine::layout(const Request &req, Layout &out, QString *errorMsg)
+{
+    out = Layout();
+    out.format        = req.format;
+    out.dilutionSteps = req.dilutionSteps;
+
+    const int rows  = req.format.rows;
+    const int cols  = req.format.columns;
+    const int steps = req.dilutionSteps;
+    const bool inColumns = req.reservation == StandardDmsoColumns;
+
+    auto fail = [&](const QString &msg) {
+        if (errorMsg) *errorMsg = msg;
+        return false;
+    };
+    if (rows < 2 || cols < 3 || rows > 255 || cols > 64)
+        return fail(QObject::tr("Unsupported daughter plate format %1x%2.").arg(rows).arg(cols));
+
+    /* ---- chain length per compound ---- */
+    QVector<int> lengths = req.chainLengths;
+    if (lengths.size() != req.compoundCount) lengths = QVector<int>(req.compoundCount, steps);
+    const int longest = lengths.isEmpty() ? steps : *std::max_element(lengths.cbegin(), lengths.cend());
+    const int shortest = lengths.isEmpty() ? steps : *std::min_element(lengths.cbegin(), lengths.cend());
+    if (shortest < 1)
+        return fail(QObject::tr("Every compound needs at least one dilution step."));
+
+    /* ---- reserved wells (identical on every plate) ---- */
+    QVector<quint64> reserved(rows, 0);
+    if (inColumns) {
+        for (int r = 0; r < rows; ++r) {
+            out.standardWells.push_back(Well{ quint8(r), quint8(cols - 2) });
+            out.dmsoWells.push_back    (Well{ quint8(r), quint8(cols - 1) });
+            reserved[r] |= runMask(2, cols - 2);
+        }
+    } else {
+        const int stdWells = qMin(qMax(steps, 6), cols);
+        for (int c = 0; c < stdWells; ++c) out.standardWells.push_back(Well{ 0, quint8(c) });
+        for (int c = 0; c < cols; ++c)     out.dmsoWells.push_back    (Well{ quint8(rows - 1), quint8(c) });
+        reserved[0]        |= runMask(stdWells, 0);
+        reserved[rows - 1] |= runMask(cols, 0);
+    }
+
+    /* ---- pack ---- */
+    out.segments.resize(lengths.size());
+    if (req.packing == RowBands) {
+        const int rowBegin = inColumns ? 0    : 1;
+        const int rowEnd   = inColumns ? rows : rows - 1;
+        const int colEnd   = inColumns ? cols - 2 : cols;
+        if (longest > colEnd || rowBegin >= rowEnd)
+            return fail(QObject::tr("%1 dilution steps do not fit on a %2x%3 daughter plate.")
+                            .arg(longest).arg(rows).arg(cols));
+        out.plateCount = packRowBands(lengths, rowBegin, rowEnd, colEnd, out.segments);
+    } else {
+        int room = 0;
+        for (quint64 m : std::as_const(reserved)) room = qMax(room, longestFreeRun(m, cols));
+        if (longest > room)
+            return fail(QObject::tr("%1 dilution steps do not fit on a %2x%3 daughter plate.")
+                            .arg(longest).arg(rows).arg(cols));
+        out.plateCount = packFirstFitDecreasing(lengths, reserved, rows, cols, out.segments);
+    }
+    return true;
+}
+
+bool DaughterLayoutEngine::relayout(const Request &req, const QStringList &names,
+                                    const Layout &previous, const QStringList &previousNames,
+                                    const QVector<QVector<quint64>> &handPlaced,
+                                    Layout &out, QString *errorMsg)
+{
+    Layout fresh;
+    if (!layout(req, fresh, errorMsg)) return false;
+    if (req.packing != FirstFitDecreasing || previous.segments.isEmpty()
+        || !sameFrame(previous, fresh)) {
+        out = fresh;
+        return true;
+    }
+
+    const int rows = fresh.format.rows, cols = fresh.format.columns;
+    const QVector<quint64> reserved = reservedMask(fresh);
+
+    QVector<int> lengths = req.chainLengths;
+    if (lengths.size() != names.size()) lengths = QVector<int>(names.size(), req.dilutionSteps);
+
+    // wells nothing may be placed on: reserved plus whatever was filled by hand
+    auto blocked = [&](int p) {
+        QVector<quint64> m = reserved;
+        if (p < handPlaced.size())
+            for (int r = 0; r < rows && r < handPlaced.at(p).size(); ++r)
+                m[r] |= handPlaced.at(p).at(r);
+        return m;
+    };
+    bool anyHandPlaced = false;
+    for (const QVector<quint64> &plate : handPlaced)
+        for (quint64 m : plate) anyHandPlaced = anyHandPlaced || m != 0;
+
+    // surviving chains by name (a repeated name reuses its chains in order)
+    QHash<QString, QVector<Segment>> kept;
+    for (const Segment &s : previous.segments)
+        if (s.compound < previousNames.size())
+            kept[previousNames.at(s.compound)].append(s);
+
+    Layout lay = fresh;
+    lay.segments = QVector<Segment>(names.size());
+    QVector<QVector<quint64>> used;
+    QVector<int> pending;
+
+    for (int i = 0; i < names.size(); ++i) {
+        QVector<Segment> &old = kept[names.at(i)];
+        if (!old.isEmpty() && old.first().length == lengths.at(i)) {
+            Segment s = old.takeFirst();
+            s.compound = i;
+            while (used.size() <= s.plate) used.append(blocked(used.size()));
+            const quint64 run = runMask(s.length, s.column);
+            if (used.at(s.plate).at(s.row) & run) {         // covered by a hand edit
+                pending.append(i);
+                continue;
+            }
+            used[s.plate][s.row] |= run;
+            lay.segments[i] = s;
+        } else {
+            pending.append(i);
+        }
+    }
+
+    std::stable_sort(pending.begin(), pending.end(),
+                     [&](int a, int b) { return lengths.at(a) > lengths.at(b); });
+    for (int i : std::as_const(pending)) {
+        const int len = lengths.at(i);
+        int p = 0, r = 0, c = 0;
+        while (p < used.size() && !firstFit(used[p], rows, cols, len, r, c)) ++p;
+        if (p == used.size()) {
+            used.append(blocked(p));
+            if (!firstFit(used[p], rows, cols, len, r, c)) {  // hand edits fill the plate
+                used[p] = reserved;
+                firstFit(used[p], rows, cols, len, r, c);     // fits: checked by layout()
+            }
+        }
+        lay.segments[i] = Segment{ i, quint16(p), quint8(r), quint8(c), quint8(len) };
+    }
+
+    // drop emptied plates at the end; holes in the middle keep the numbering
+    int last = 0;
+    for (const Segment &s : std::as_const(lay.segments)) last = qMax(last, int(s.plate));
+    lay.plateCount = last + 1;
+
+    // a fresh layout would ignore the hand-placed wells
+    out = (lay.plateCount > fresh.plateCount && !anyHandPlaced) ? fresh : lay;
+    return true;
+}
+
+DaughterLayoutEngine::Diff DaughterLayoutEngine::diff(const Layout &from, const QStringList &fromNames,
+                                                      const Layout &to,   const QStringList &toNames)
+{
+    Diff d;
+    if (!sameFrame(from, to)) {
+        d.rebuild = true;
+        return d;
+    }
+
+    QHash<QString, QVector<Segment>> before;
+    for (const Segment &s : from.segments)
+        if (s.compound < fromNames.size())
+            before[fromNames.at(s.compound)].append(s);
+
+    for (const Segment &s : to.segments) {
+        if (s.compound >= toNames.size()) continue;
+        QVector<Segment> &cand = before[toNames.at(s.compound)];
+        const auto it = std::find_if(cand.begin(), cand.end(),
+                                     [&](const Segment &o) { return samePlace(o, s); });
+        if (it != cand.end()) cand.erase(it);
+        else                  d.added.append(s);
+    }
+    for (const QVector<Segment> &rest : std::as_const(before))
+        d.removed += rest;
+    return d;
+}
+
+QMap<QString, QStringList>
+DaughterLayoutEngine::Layout::plateWells(int plate, const QStringList &names) const
+{
+    QMap<QString, QStringList> map;
+
+    QStringList &standard = map["Standard"];
+    for (const Well &w : standardWells) standard << wellName(w.row, w.column);
+    QStringList &dmso = map["DMSO"];
+    for (const Well &w : dmsoWells) dmso << wellName(w.row, w.column);
+
+    for (const Segment &s : segments) {
+        if (s.plate != plate || s.compound >= names.size()) continue;
+        QStringList &wells = map[names.at(s.compound)];
+        wells.clear();                              // a repeated name keeps its last chain
+        for (int d = 0; d < s.length; ++d) wells << wellName(s.row, s.column + d);
+    }
+    return map;
+}
+
+QJsonArray DaughterLayoutEngine::Layout::toJson(const QStringList &names) const
+{
+    QJsonArray plates;
+    for (int p = 0; p < plateCount; ++p) {
+        QJsonObject wells;
+        const auto map = plateWells(p, names);
+        for (auto it = map.cbegin(); it != map.cend(); ++it)
+            for (const QString &w : it.value()) wells[w] = it.key();
+
+        QJsonObject plateObj;
+        plateObj["plate_number"]   = p + 1;
+        if (format.rows != Format().rows || format.columns != Format().columns) {
+            plateObj["rows"]       = format.rows;
+            plateObj["columns"]    = format.columns;
+        }
+        plateObj["dilution_steps"] = dilutionSteps;
+        plateObj["wells"]          = wells;
+        plates.append(plateObj);
+    }
+    return plates;
+}
+
+bool DaughterLayoutEngine::layoutExperiment(const QJsonObject &experiment,
+                                            QJsonArray &daughterPlates,
+                                            QString *errorMsg)
+{
+    QStringList names;
+    QSet<QString> seen;
+    for (const QJsonValue &v : experiment.value("compounds").toArray()) {
+        const QString name = v.toObject().value("product_name").toString();
+        if (!name.isEmpty() && !seen.contains(name)) { seen.insert(name); names << name; }
+    }
+    if (names.isEmpty()) {
+        if (errorMsg) *errorMsg = QObject::tr("No compounds to place on daughter plates.");
+        return false;
+    }
+
+    const QJsonArray  trs = experiment.value("test_requests").toArray();
+    const QJsonObject tr0 = trs.isEmpty() ? QJsonObject() : trs.at(0).toObject();
+    Request req;
+    req.compoundCount = names.size();
+    req.dilutionSteps = tr0.value("number_of_dilutions").toVariant().toInt();
+    if (req.dilutionSteps <= 0) req.dilutionSteps = 3;          // same default as the editor
+    req.reservation   = reservationForTest(tr0.value("requested_tests").toString());
+    req.format        = formatForWells(experiment.value("daughter_plate_wells").toInt(96));
+
+    Layout lay;
+    if (!layout(req, lay, errorMsg)) return false;
+    daughterPlates = lay.toJson(names);
+    return true;
+}
@@ -0,0 +1,146 @@
+#ifndef DAUGHTERLAYOUT_H
+#define DAUGHTERLAYOUT_H
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * Widget-free placement of compound dilution chains on daughter plates.
+ *
+ * Every compound gets `dilutionSteps` consecutive wells along one row.
+ * Standard and DMSO wells are reserved on every plate:
+ *   - default:    Standard A1..A{max(steps,6)}, DMSO across the last row;
+ *   - INV-T-031:  Standard in the second-to-last column, DMSO in the last.
+ *
+ * Two packers:
+ *   - RowBands: the historical fill, down the rows of a column band and
+ *     then the next band; the rest of the Standard row stays empty;
+ *   - FirstFitDecreasing: longest chains first, each into the first plate
+ *     with a free run of wells (column by column, then row), using every
+ *     well that is not reserved. With equal chain lengths it never needs
+ *     more plates than RowBands, and fewer when the Standard row has room.
+ *
+ * The result only depends on the request (no colours, no widgets, no
+ * randomness), so the same input always gives the same plates.
+ *
+ * relayout() is the incremental variant for an editor: chains that survive
+ * stay where they were and only new compounds are placed, so diff() between
+ * the two layouts names just the handful of chains that moved.
+ */
+class DaughterLayoutEngine
+{
+public:
+    struct Format {
+        int rows    = 8;
+        int columns = 12;
+    };
+
+    enum Reservation {
+        StandardRowDmsoRow,         // default
+        StandardDmsoColumns         // INV-T-031
+    };
+
+    enum Packing {
+        RowBands,
+        FirstFitDecreasing
+    };
+
+    struct Request {
+        int          compoundCount = 0;
+        int          dilutionSteps = 1;
+        QVector<int> chainLengths;              // per compound; empty = dilutionSteps each
+        Format       format;
+        Reservation  reservation   = StandardRowDmsoRow;
+        Packing      packing       = FirstFitDecreasing;
+    };
+
+    /** Reservation rules for a requested_tests value. */
+    static Reservation reservationForTest(const QString &testType);
+
+    static constexpr int kStandard = -1;
+    static constexpr int kDmso     = -2;
+
+    /** One compound chain: `length` wells from (row, column) to the right. */
+    struct Segment {
+        qint32  compound = 0;       // index in the request
+        quint16 plate    = 0;
+        quint8  row      = 0;       // 0-based
+        quint8  column   = 0;       // 0-based
+        quint8  length   = 0;
+    };
+
+    struct Well {
+        quint8 row    = 0;
+        quint8 column = 0;
+    };
+
+    struct Layout {
+        Format           format;
+        int              dilutionSteps = 0;
+        int              plateCount    = 0;
+        QVector<Segment> segments;          // in compound order
+        QVector<Well>    standardWells;     // same on every plate
+        QVector<Well>    dmsoWells;
+
+        /** name ➜ wells on one plate, as DaughterPlateWidget::populatePlate takes it. */
+        QMap<QString, QStringList> plateWells(int plate, const QStringList &names) const;
+
+        /** `daughter_plates` array in the experiment JSON format; rows and
+            columns are written only for plates that are not 8x12. */
+        QJsonArray toJson(const QStringList &names) const;
+    };
+
+    static bool layout(const Request &request, Layout &out, QString *errorMsg = nullptr);
+
+    /** Like layout(), but keeps every chain of `previous` (laid out for
+        `previousNames`) whose compound is still in `names` with the same
+        length; new compounds go first fit into the free wells. Uses the
+        plain layout() instead for RowBands, when the format, steps or
+        reserved wells changed, or when that needs fewer plates.
+        `handPlaced` holds, per plate and row, the wells filled outside the
+        layout (bit c = column c); nothing is placed on them and a kept
+        chain they overlap is placed again. */
+    static bool relayout(const Request &request, const QStringList &names,
+                         const Layout &previous, const QStringList &previousNames,
+                         const QVector<QVector<quint64>> &handPlaced,
+                         Layout &out, QString *errorMsg = nullptr);
+
+    /** Chains to take away from `from` and to put onto it to get `to`,
+        matched by compound name and position. */
+    struct Diff {
+        bool             rebuild = false;   // format, steps or reserved wells differ
+        QVector<Segment> removed;           // compound indexes into the `from` names
+        QVector<Segment> added;             // compound indexes into the `to` names
+    };
+    static Diff diff(const Layout &from, const QStringList &fromNames,
+                     const Layout &to,   const QStringList &toNames);
+
+    /** Experiment JSON without daughter_plates: lay them out from
+        compounds[].product_name and test_requests[0], on plates of
+        daughter_plate_wells (96 if absent). */
+    static bool layoutExperiment(const QJsonObject &experiment,
+                                 QJsonArray &daughterPlates,
+                                 QString *errorMsg = nullptr);
+
+    /** (0, 0) ➜ "A1". */
+    static QString wellName(int row, int column);
+
+    /** "A1" / "AA12" ➜ 0-based (row, column); false if not a well name. */
+    static bool parseWell(const QString &name, int &row, int &column);
+
+    /** 384 ➜ 16x24, 1536 ➜ 32x48, anything else 8x12. */
+    static Format formatForWells(int wells);
+
+    /** Format of one `daughter_plates` entry: its rows/columns, otherwise the
+        smallest of 96/384/1536 that holds every well name (old files). */
+    static Format formatOfPlate(const QJsonObject &plate);
+
+    /** Working volume of one well: 300 µL (96), 120 µL (384), 12 µL (1536). */
+    static double wellCapacityUL(const Format &format);
+};
+
+#endif // DAUGHTERLAYOUT_H
@@ -0,0 +1,83 @@
+#include "decklayout.h"
+
+#include <algorithm>
+#include <cmath>
+
+DeckLayout DeckLayout::fluentDefault()
+{
+    DeckLayout deck;
+
+    Site trough;                       // 100 mL trough, 8 positions along Y
+    trough.x = 100.0; trough.y = 60.0; trough.cols = 1;
+    deck.setSite(QStringLiteral("100ml_Higher"), trough);
+
+    Site standards;
+    standards.x = 250.0; standards.y = 60.0;
+    deck.setSite(QStringLiteral("Standard_Matrix"), standards);
+
+    Family matrix;
+    matrix.origin.x = 400.0; matrix.origin.y = 60.0;
+    deck.setFamily(QStringLiteral("Matrix"), matrix);
+
+    Family daughter;
+    daughter.origin.x = 400.0; daughter.origin.y = 300.0;
+    deck.setFamily(QStringLiteral("Daughter"), daughter);
+
+    Family assay;
+    assay.origin.x = 100.0; assay.origin.y = 420.0;
+    assay.perRow = 6;
+    deck.setFamily(QStringLiteral("Assay"), assay);
+
+    return deck;
+}
+
+void DeckLayout::setFamilyFormat(const QString &name, int rows, int cols)
+{
+    auto fit = families_.find(name);
+    if (fit == families_.end() || rows < 1 || cols < 1) return;
+
+    Site &s = fit->origin;
+    const double pitch = s.pitchMM * s.rows / rows;
+    s.x += (pitch - s.pitchMM) / 2.0;          // A1 centre moves towards the corner
+    s.y += (pitch - s.pitchMM) / 2.0;
+    s.rows    = rows;
+    s.cols    = cols;
+    s.pitchMM = pitch;
+}
+
+DeckLayout::Site DeckLayout::siteFor(const QString &label) const
+{
+    auto sit = sites_.constFind(label);
+    if (sit != sites_.cend()) return sit.value();
+
+    // "Name[NNN]"
+    const int lb = label.indexOf(QLatin1Char('['));
+    if (lb > 0 && label.endsWith(QLatin1Char(']'))) {
+        auto fit = families_.constFind(label.left(lb));
+        if (fit != families_.cend()) {
+            const Family &f = fit.value();
+            const int idx   = qMax(1, label.mid(lb + 1, label.size() - lb - 2).toInt()) - 1;
+            const int perRow = qMax(1, f.perRow);
+            Site s = f.origin;
+            s.x += (idx % perRow) * f.strideX;
+            s.y += (idx / perRow) * f.strideY;
+            return s;
+        }
+    }
+    return Site();
+}
+
+QPointF DeckLayout::wellPosition(const QString &label, int position) const
+{
+    const Site s = siteFor(label);
+    const int p    = qMax(1, position) - 1;
+    const int rows = qMax(1, s.rows);
+    return QPointF(s.x + (p / rows) * s.pitchMM,
+                   s.y + (p % rows) * s.pitchMM);
+}
+
+double DeckLayout::distance(const QPointF &a, const QPointF &b)
+{
+    // X and Y drives move together: the slower axis decides
+    return std::max(std::abs(a.x() - b.x()), std::abs(a.y() - b.y()));
+}
@@ -0,0 +1,57 @@
+#ifndef DECKLAYOUT_H
+#define DECKLAYOUT_H
+
+#include <QHash>
+#include <QPointF>
+#include <QString>
+
+/**
+ * Physical positions of the labware used by the worklists, in deck
+ * millimetres. Used to cost and order arm travel.
+ *
+ * Labels are matched exactly ("100ml_Higher") or by family
+ * ("Matrix[002]" -> family "Matrix", index 2); family members are laid out
+ * left to right from the family origin and wrap after perRow sites.
+ */
+class DeckLayout
+{
+public:
+    struct Site {
+        double x       = 0.0;     // A1 centre
+        double y       = 0.0;
+        int    rows    = 8;
+        int    cols    = 12;
+        double pitchMM = 9.0;
+    };
+
+    struct Family {
+        Site   origin;            // site of index 1
+        double strideX = 150.0;
+        double strideY = 120.0;
+        int    perRow  = 4;
+    };
+
+    /** Fluent 780 deck as set up for the Invenesis methods. */
+    static DeckLayout fluentDefault();
+
+    void setSite(const QString &label, const Site &site) { sites_[label] = site; }
+    void setFamily(const QString &name, const Family &family) { families_[name] = family; }
+
+    /** Plate format of a family, e.g. 16 x 24 for 384-well daughter plates;
+        the pitch shrinks so the plate keeps the 96-well footprint. */
+    void setFamilyFormat(const QString &name, int rows, int cols);
+
+    /** Site for a label; unknown labels fall back to the deck origin. */
+    Site siteFor(const QString &label) const;
+
+    /** Centre of a 1-based column-major position on the labware. */
+    QPointF wellPosition(const QString &label, int position) const;
+
+    static double distance(const QPointF &a, const QPointF &b);
+
+private:
+    QHash<QString, Site>   sites_;
+    QHash<QString, Family> families_;
+};
+
+#endif // DECKLAYOUT_H
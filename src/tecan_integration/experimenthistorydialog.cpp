@@ -0,0 +1,163 @@
+#include "experimenthistorydialog.h"
+#include "jsondelta.h"
+
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPlainTextEdit>
+#include <QPushButton>
+#include <QSplitter>
+#include <QTableWidget>
+#include <QVBoxLayout>
+#include <algorithm>
+
+ExperimentHistoryDialog::ExperimentHistoryDialog(int experimentId,
+                                                 const QString &experimentCode,
+                                                 QWidget *parent)
+    : QDialog(parent),
+      experimentId_(experimentId)
+{
+    setWindowTitle(QString("History — %1").arg(experimentCode));
+    resize(900, 560);
+    auto *layout = new QVBoxLayout(this);
+
+    auto *splitter = new QSplitter(Qt::Horizontal, this);
+
+    table_ = new QTableWidget(0, 4, splitter);
+    table_->setHorizontalHeaderLabels({ "Version", "Saved", "User", "Stored" });
+    table_->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table_->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table_->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    table_->verticalHeader()->setVisible(false);
+    table_->horizontalHeader()->setStretchLastSection(true);
+
+    diff_ = new QPlainTextEdit(splitter);
+    diff_->setReadOnly(true);
+    diff_->setLineWrapMode(QPlainTextEdit::NoWrap);
+    diff_->setPlaceholderText("Select a version to see what changed, or two to compare them.");
+
+    splitter->setStretchFactor(1, 1);
+    layout->addWidget(splitter, 1);
+
+    status_ = new QLabel(this);
+    layout->addWidget(status_);
+
+    auto *btns = new QHBoxLayout();
+    open_ = new QPushButton("Open Version", this);
+    open_->setEnabled(false);
+    auto *close = new QPushButton("Close", this);
+    btns->addStretch(1);
+    btns->addWidget(open_);
+    btns->addWidget(close);
+    layout->addLayout(btns);
+
+    connect(table_, &QTableWidget::itemSelectionChanged, this, &ExperimentHistoryDialog::onSelectionChanged);
+    connect(open_, &QPushButton::clicked, this, &ExperimentHistoryDialog::onOpen);
+    connect(close, &QPushButton::clicked, this, &QDialog::reject);
+
+    reload();
+}
+
+bool ExperimentHistoryDialog::reload()
+{
+    QString err;
+    if (!ExperimentStore::listVersions(experimentId_, versions_, &err)) {
+        QMessageBox::critical(this, "Error", "Failed to load history:\n" + err);
+        return false;
+    }
+
+    table_->setRowCount(versions_.size());
+    qint64 stored = 0, baseBytes = 0;
+    for (int r = 0; r < versions_.size(); ++r) {
+        const auto &v = versions_.at(r);
+        table_->setItem(r, 0, new QTableWidgetItem(QString::number(v.version)));
+        table_->setItem(r, 1, new QTableWidgetItem(v.createdAt.toString("yyyy-MM-dd HH:mm")));
+        table_->setItem(r, 2, new QTableWidgetItem(v.createdBy));
+        table_->setItem(r, 3, new QTableWidgetItem(
+            QString("%1 %2 B").arg(v.isBase ? "base" : "delta").arg(v.storedBytes)));
+        stored += v.storedBytes;
+        if (v.isBase) baseBytes = qMax<qint64>(baseBytes, v.storedBytes);
+    }
+    table_->resizeColumnsToContents();
+
+    // compared with keeping one full copy per version
+    status_->setText(QString("%1 version(s), %2 KB stored (about %3 KB as full copies)")
+                         .arg(versions_.size())
+                         .arg(stored / 1024.0, 0, 'f', 1)
+                         .arg(baseBytes * versions_.size() / 1024.0, 0, 'f', 1));
+    return true;
+}
+
+QList<int> ExperimentHistoryDialog::selectedVersions() const
+{
+    QList<int> out;
+    const auto rows = table_->selectionModel()->selectedRows();
+    for (const QModelIndex &idx : rows)
+        out << versions_.at(idx.row()).version;
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+void ExperimentHistoryDialog::onSelectionChanged()
+{
+    const QList<int> sel = selectedVersions();
+    open_->setEnabled(sel.size() == 1);
+    diff_->clear();
+    if (sel.isEmpty()) return;
+
+    QString err;
+    QStringList lines;
+
+    if (sel.size() == 1) {
+        // one version: its stored delta is the diff to the one before
+        QJsonArray delta;
+        if (ExperimentStore::loadVersionDelta(experimentId_, sel.first(), delta, &err)) {
+            lines << QString("Changes in version %1:").arg(sel.first());
+            lines << JsonDelta::describe(delta);
+        } else if (!err.isEmpty()) {
+            diff_->setPlainText("Error: " + err);
+            return;
+        } else if (sel.first() > 1) {
+            // stored as a base: rebuild the previous version and diff
+            QJsonObject a, b;
+            if (!ExperimentStore::loadVersion(experimentId_, sel.first() - 1, a, &err)
+                || !ExperimentStore::loadVersion(experimentId_, sel.first(), b, &err)) {
+                diff_->setPlainText("Error: " + err);
+                return;
+            }
+            lines << QString("Changes in version %1:").arg(sel.first());
+            lines << JsonDelta::describe(JsonDelta::diff(a, b), a);
+        } else {
+            lines << "First saved version.";
+        }
+    } else {
+        const int from = sel.first(), to = sel.last();
+        QJsonObject a, b;
+        if (!ExperimentStore::loadVersion(experimentId_, from, a, &err)
+            || !ExperimentStore::loadVersion(experimentId_, to, b, &err)) {
+            diff_->setPlainText("Error: " + err);
+            return;
+        }
+        const QJsonArray delta = JsonDelta::diff(a, b);
+        lines << QString("Version %1 → %2: %3 change(s)").arg(from).arg(to).arg(delta.size());
+        lines << JsonDelta::describe(delta, a);
+    }
+    diff_->setPlainText(lines.join('\n'));
+}
+
+void ExperimentHistoryDialog::onOpen()
+{
+    const QList<int> sel = selectedVersions();
+    if (sel.size() != 1) return;
+
+    QString err;
+    QJsonObject json;
+    if (!ExperimentStore::loadVersion(experimentId_, sel.first(), json, &err)) {
+        QMessageBox::critical(this, "Error", "Failed to load version:\n" + err);
+        return;
+    }
+    openedVersion_ = sel.first();
+    openedJson_    = json;
+    accept();
+}
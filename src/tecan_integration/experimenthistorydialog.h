@@ -0,0 +1,53 @@
+#ifndef EXPERIMENTHISTORYDIALOG_H
+#define EXPERIMENTHISTORYDIALOG_H
+
+#include <QDialog>
+#include <QJsonObject>
+#include <QVector>
+
+#include "experimentstore.h"
+
+class QTableWidget;
+class QPlainTextEdit;
+class QPushButton;
+class QLabel;
+
+/**
+ * Saved versions of one experiment with the changes between them.
+ *
+ * Selecting one version shows its stored delta (no reconstruction);
+ * selecting two rebuilds both on the server and diffs them. "Open" accepts
+ * the dialog with the payload of the selected version.
+ */
+class ExperimentHistoryDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    ExperimentHistoryDialog(int experimentId, const QString &experimentCode,
+                            QWidget *parent = nullptr);
+
+    int selectedVersion() const { return openedVersion_; }
+    QJsonObject selectedVersionJson() const { return openedJson_; }
+
+private slots:
+    void onSelectionChanged();
+    void onOpen();
+
+private:
+    bool reload();
+    QList<int> selectedVersions() const;   // ascending
+
+    int experimentId_;
+    QVector<ExperimentStore::VersionInfo> versions_;
+
+    QTableWidget   *table_  = nullptr;
+    QPlainTextEdit *diff_   = nullptr;
+    QLabel         *status_ = nullptr;
+    QPushButton    *open_   = nullptr;
+
+    int         openedVersion_ = -1;
+    QJsonObject openedJson_;
+};
+
+#endif // EXPERIMENTHISTORYDIALOG_H
@@ -0,0 +1,350 @@
+#include "experimentstore.h"
+#include "jsondelta.h"
+#include "jsonhash.h"
+#include "common/SqlPattern.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QVariant>
+
+namespace {
+
+// newest experiment_versions.version of `e`, 0 without history
+QString latestVersionColumn()
+{
+    return QStringLiteral("COALESCE((SELECT max(v.version) FROM experiment_versions v "
+                          "WHERE v.experiment_id = e.experiment_id), 0)");
+}
+
+// columns: experiment_id, experiment_code, data::text, latest version
+ExperimentStore::Payload payloadFromQuery(const QSqlQuery &q)
+{
+    ExperimentStore::Payload p;
+    p.experimentId   = q.value(0).toInt();
+    p.experimentCode = q.value(1).toString();
+    p.version        = q.value(3).toInt();
+
+    QJsonParseError pe{};
+    const QJsonDocument doc = QJsonDocument::fromJson(q.value(2).toString().toUtf8(), &pe);
+    if (pe.error == QJsonParseError::NoError && doc.isObject())
+        p.json = doc.object();
+    return p;
+}
+
+} // namespace
+
+QString ExperimentStore::summaryColumns()
+{
+    return QStringLiteral("experiment_id, experiment_code, project_code, created_by, date_created");
+}
+
+bool ExperimentStore::listPage(const Filter &filter,
+                               const Cursor &after,
+                               int limit,
+                               QVector<Summary> &out,
+                               bool *hasMore,
+                               QString *errorMsg)
+{
+    out.clear();
+    limit = qMax(1, limit);
+
+    QStringList where;
+    if (!filter.code.trimmed().isEmpty())     where << "experiment_code ILIKE :code";
+    if (!filter.project.trimmed().isEmpty())  where << "project_code ILIKE :project";
+    if (!filter.user.trimmed().isEmpty())     where << "created_by ILIKE :user";
+    if (!filter.compound.trimmed().isEmpty()) where << "compound_search LIKE :compound";
+    if (filter.from.isValid())                where << "date_created >= CAST(:from AS date)";
+    if (filter.to.isValid())                  where << "date_created < CAST(:to AS date) + 1";
+    if (after.isValid())
+        where << "(date_created, experiment_id) < (CAST(:cdate AS timestamptz), :cid)";
+
+    // one extra row tells whether another page exists
+    const QString sql = QString("SELECT %1, date_created::text FROM experiments %2 "
+                                "ORDER BY date_created DESC, experiment_id DESC LIMIT %3")
+                            .arg(summaryColumns(),
+                                 where.isEmpty() ? QString() : "WHERE " + where.join(" AND "))
+                            .arg(limit + 1);
+
+    QSqlQuery q;
+    q.setForwardOnly(true);
+    q.prepare(sql);
+    if (!filter.code.trimmed().isEmpty())     q.bindValue(":code",     likePattern(filter.code));
+    if (!filter.project.trimmed().isEmpty())  q.bindValue(":project",  likePattern(filter.project));
+    if (!filter.user.trimmed().isEmpty())     q.bindValue(":user",     likePattern(filter.user));
+    if (!filter.compound.trimmed().isEmpty()) q.bindValue(":compound", likePattern(filter.compound.toLower()));
+    if (filter.from.isValid())                q.bindValue(":from", filter.from.toString(Qt::ISODate));
+    if (filter.to.isValid())                  q.bindValue(":to",   filter.to.toString(Qt::ISODate));
+    if (after.isValid()) {
+        q.bindValue(":cdate", after.dateKey);
+        q.bindValue(":cid",   after.experimentId);
+    }
+
+    if (!q.exec()) {
+        if (errorMsg) *errorMsg = q.lastError().text();
+        return false;
+    }
+
+    out.reserve(limit);
+    bool more = false;
+    while (q.next()) {
+        if (out.size() == limit) { more = true; break; }
+        Summary s;
+        s.experimentId   = q.value(0).toInt();
+        s.experimentCode = q.value(1).toString();
+        s.projectCode    = q.value(2).toString();
+        s.createdBy      = q.value(3).toString();
+        s.dateCreated    = q.value(4).toDateTime();
+        s.dateKey        = q.value(5).toString();
+        out.push_back(s);
+    }
+    if (hasMore) *hasMore = more;
+    return true;
+}
+
+bool ExperimentStore::loadPayload(int experimentId, Payload &out, QString *errorMsg)
+{
+    QSqlQuery q;
+    q.prepare("SELECT experiment_id, experiment_code, data::text, " + latestVersionColumn() +
+              " FROM  experiments e WHERE experiment_id = :id");
+    q.bindValue(":id", experimentId);
+
+    if (!q.exec()) {
+        if (errorMsg) *errorMsg = q.lastError().text();
+        return false;
+    }
+    if (!q.next()) {
+        if (errorMsg) *errorMsg = QString("Experiment %1 not found").arg(experimentId);
+        return false;
+    }
+    out = payloadFromQuery(q);
+    return true;
+}
+
+bool ExperimentStore::loadPayloads(const QList<int> &experimentIds,
+                                   QVector<Payload> &out,
+                                   QString *errorMsg)
+{
+    out.clear();
+    if (experimentIds.isEmpty()) return true;
+
+    // ids are integers, so the IN list can be inlined safely
+    QStringList idList;
+    idList.reserve(experimentIds.size());
+    for (int id : experimentIds) idList << QString::number(id);
+
+    QSqlQuery q;
+    q.setForwardOnly(true);
+    if (!q.exec(QString("SELECT experiment_id, experiment_code, data::text, %1 FROM experiments e "
+                        "WHERE experiment_id IN (%2) ORDER BY experiment_id")
+                    .arg(latestVersionColumn(), idList.join(',')))) {
+        if (errorMsg) *errorMsg = q.lastError().text();
+        return false;
+    }
+    while (q.next()) out.push_back(payloadFromQuery(q));
+    return true;
+}
+
+bool ExperimentStore::save(const QString &experimentCode,
+                           const QJsonObject &json,
+                           const QJsonObject *previous,
+                           int previousVersion,
+                           int *experimentId,
+                           int *version,
+                           QString *errorMsg)
+{
+    const QByteArray data = QJsonDocument(json).toJson(QJsonDocument::Compact);
+
+    // delta against the snapshot the user edited; the server only uses it
+    // if that snapshot's version is still the latest and its hash matches
+    QString parentHash;
+    QByteArray delta;
+    if (previous && !previous->isEmpty() && previousVersion > 0
+        && previous->value("experiment_code").toString() == experimentCode) {
+        parentHash = JsonHash::of(*previous, JsonHash::OrderedArrays).toHex();
+        delta = QJsonDocument(JsonDelta::diff(*previous, json)).toJson(QJsonDocument::Compact);
+        if (delta.size() * 2 > data.size()) delta.clear();          // not worth it: store a base
+    }
+
+    QJsonArray requestIds;
+    const QJsonArray trArr = json.value("test_requests").toArray();
+    for (const QJsonValue &v : trArr) {
+        // request_id is written as a number or a string depending on the source
+        bool ok = false;
+        const int rid = v.toObject().value("request_id").toVariant().toInt(&ok);
+        if (ok) requestIds.append(rid);
+    }
+
+    // experiment row, request links and the version row in a single
+    // round-trip
+    const QString sql = QStringLiteral(R"(
+        WITH e AS (
+            INSERT INTO experiments (experiment_code, project_code, date_created, data)
+            VALUES (:code, :project, NOW(), CAST(:data AS jsonb))
+            ON CONFLICT (experiment_code) DO UPDATE
+              SET project_code = EXCLUDED.project_code,
+                  date_created = NOW(),
+                  data         = EXCLUDED.data
+            RETURNING experiment_id, data),
+        arg AS (
+            SELECT CAST(:hash AS text)                 AS hash,
+                   CAST(:parent AS text)               AS parent,
+                   CAST(:pver AS integer)              AS pver,
+                   CAST(NULLIF(:delta, '') AS jsonb)   AS delta,
+                   CAST(:every AS integer)             AS every),
+        prev AS (
+            SELECT v.version, v.content_hash, v.since_base
+              FROM experiment_versions v JOIN e USING (experiment_id)
+             ORDER BY v.version DESC
+             LIMIT 1),
+        ver AS (
+            INSERT INTO experiment_versions
+                   (experiment_id, version, created_by, content_hash, since_base,
+                    parent_version, base, delta)
+            SELECT e.experiment_id,
+                   COALESCE(p.version, 0) + 1,
+                   :user,
+                   arg.hash,
+                   CASE WHEN d.use_delta THEN p.since_base + 1 ELSE 0 END,
+                   CASE WHEN d.use_delta THEN p.version END,
+                   CASE WHEN d.use_delta THEN NULL ELSE e.data END,
+                   CASE WHEN d.use_delta THEN arg.delta END
+              FROM e CROSS JOIN arg
+              LEFT JOIN prev p ON true
+              CROSS JOIN LATERAL (
+                  SELECT COALESCE(p.version = arg.pver
+                                  AND p.content_hash = arg.parent
+                                  AND arg.delta IS NOT NULL
+                                  AND p.since_base + 1 < arg.every, false) AS use_delta) d
+             WHERE p.content_hash IS DISTINCT FROM arg.hash
+            RETURNING version),
+        r AS (
+            SELECT DISTINCT rid::int AS rid
+              FROM jsonb_array_elements_text(CAST(:rids AS jsonb)) AS rid),
+        linked AS (
+            INSERT INTO experiment_requests (experiment_id, request_id)
+            SELECT e.experiment_id, r.rid FROM e, r
+            ON CONFLICT DO NOTHING)
+        SELECT experiment_id,
+               COALESCE((SELECT version FROM ver), (SELECT version FROM prev), 0)
+          FROM e)");
+
+    // Two saves of one experiment can both pick the same next version: the
+    // later one fails on the primary key and runs again on a fresh snapshot,
+    // where the other save is the latest version, so it stores a full base.
+    QSqlDatabase db = QSqlDatabase::database();
+    for (int attempt = 0; ; ++attempt) {
+        if (!db.transaction()) {
+            if (errorMsg) *errorMsg = db.lastError().text();
+            return false;
+        }
+
+        QSqlQuery q(db);
+        q.prepare(sql);
+        q.bindValue(":code",    experimentCode);
+        q.bindValue(":project", json.value("project_code").toString());
+        q.bindValue(":data",    QString::fromUtf8(data));
+        q.bindValue(":rids",    QString::fromUtf8(QJsonDocument(requestIds).toJson(QJsonDocument::Compact)));
+        q.bindValue(":user",    json.value("user").toString());
+        q.bindValue(":hash",    JsonHash::of(json, JsonHash::OrderedArrays).toHex());
+        q.bindValue(":parent",  parentHash);
+        q.bindValue(":pver",    previousVersion);
+        q.bindValue(":delta",   QString::fromUtf8(delta));
+        q.bindValue(":every",   kVersionsPerBase);
+
+        if (!q.exec() || !q.next()) {
+            const QSqlError e = q.lastError();
+            q.finish();
+            db.rollback();
+            if (e.nativeErrorCode() == QLatin1String("23505") && attempt < 2)
+                continue;                           // unique_violation: version taken
+            if (errorMsg) *errorMsg = e.text();
+            return false;
+        }
+        const int id  = q.value(0).toInt();
+        const int ver = q.value(1).toInt();
+        q.finish();
+
+        if (!db.commit()) {
+            if (errorMsg) *errorMsg = db.lastError().text();
+            db.rollback();
+            return false;
+        }
+        if (experimentId) *experimentId = id;
+        if (version)      *version      = ver;
+        return true;
+    }
+}
+
+bool ExperimentStore::listVersions(int experimentId,
+                                   QVector<VersionInfo> &out,
+                                   QString *errorMsg)
+{
+    out.clear();
+    QSqlQuery q;
+    q.setForwardOnly(true);
+    q.prepare("SELECT version, created_at, created_by, content_hash, base IS NOT NULL, "
+              "       octet_length(COALESCE(base, delta)::text) "
+              "FROM   experiment_versions WHERE experiment_id = :id "
+              "ORDER  BY version DESC");
+    q.bindValue(":id", experimentId);
+    if (!q.exec()) {
+        if (errorMsg) *errorMsg = q.lastError().text();
+        return false;
+    }
+    while (q.next()) {
+        VersionInfo v;
+        v.version     = q.value(0).toInt();
+        v.createdAt   = q.value(1).toDateTime();
+        v.createdBy   = q.value(2).toString();
+        v.contentHash = q.value(3).toString();
+        v.isBase      = q.value(4).toBool();
+        v.storedBytes = q.value(5).toInt();
+        out.push_back(v);
+    }
+    return true;
+}
+
+bool ExperimentStore::loadVersion(int experimentId,
+                                  int version,
+                                  QJsonObject &out,
+                                  QString *errorMsg)
+{
+    QSqlQuery q;
+    q.prepare("SELECT experiment_version_data(:id, :ver)::text");
+    q.bindValue(":id",  experimentId);
+    q.bindValue(":ver", version);
+    if (!q.exec() || !q.next()) {
+        if (errorMsg) *errorMsg = q.lastError().text();
+        return false;
+    }
+    const QJsonDocument doc = QJsonDocument::fromJson(q.value(0).toString().toUtf8());
+    if (!doc.isObject()) {
+        if (errorMsg) *errorMsg = QString("Version %1 of experiment %2 not found").arg(version).arg(experimentId);
+        return false;
+    }
+    out = doc.object();
+    return true;
+}
+
+bool ExperimentStore::loadVersionDelta(int experimentId,
+                                       int version,
+                                       QJsonArray &out,
+                                       QString *errorMsg)
+{
+    out = QJsonArray();
+    QSqlQuery q;
+    q.prepare("SELECT delta::text FROM experiment_versions "
+              "WHERE experiment_id = :id AND version = :ver AND delta IS NOT NULL");
+    q.bindValue(":id",  experimentId);
+    q.bindValue(":ver", version);
+    if (!q.exec()) {
+        if (errorMsg) *errorMsg = q.lastError().text();
+        return false;
+    }
+    if (!q.next()) return false;                    // a base: no stored delta
+    out = QJsonDocument::fromJson(q.value(0).toString().toUtf8()).array();
+    return true;
+}
@@ -0,0 +1,142 @@
+#ifndef EXPERIMENTSTORE_H
+#define EXPERIMENTSTORE_H
+
+#include <QDate>
+#include <QJsonArray>
+#include <QDateTime>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * Access to the `experiments` table (default DB connection).
+ *
+ * The payload lives in `data` (JSONB, see sql/migrations); project, code,
+ * author, compound names and dates are plain or generated columns, so
+ * listing never reads the payload. Payloads are fetched only when an
+ * experiment is opened or generated.
+ */
+class ExperimentStore
+{
+public:
+    struct Summary {
+        int       experimentId = -1;
+        QString   experimentCode;
+        QString   projectCode;
+        QString   createdBy;
+        QDateTime dateCreated;
+        QString   dateKey;          // date_created as text, full precision (paging)
+    };
+
+    /** Server-side filters; empty fields are ignored, text matches are
+        case-insensitive substrings. */
+    struct Filter {
+        QString code;
+        QString project;
+        QString user;
+        QString compound;
+        QDate   from;               // inclusive
+        QDate   to;                 // inclusive
+
+        bool operator==(const Filter &o) const {
+            return code == o.code && project == o.project && user == o.user
+                && compound == o.compound && from == o.from && to == o.to;
+        }
+        bool operator!=(const Filter &o) const { return !(*this == o); }
+    };
+
+    /** Position after the last row of a page (newest first): the sort key
+        itself, so paging goes on when that row is deleted or re-saved. The
+        date is kept as the server's text, so it keeps its full precision. */
+    struct Cursor {
+        QString dateKey;
+        int     experimentId = -1;
+
+        bool isValid() const { return experimentId >= 0 && !dateKey.isEmpty(); }
+        static Cursor after(const Summary &s) { return Cursor{ s.dateKey, s.experimentId }; }
+    };
+
+    struct Payload {
+        int         experimentId = -1;
+        QString     experimentCode;
+        QJsonObject json;           // empty if the stored data is not an object
+        int         version = 0;    // latest experiment_versions.version, 0 if none
+    };
+
+    /** SQL for the metadata columns, in Summary order. */
+    static QString summaryColumns();
+
+    /** One page ordered by (date_created, experiment_id) DESC, starting
+        after `after` (keyset: cost does not grow with the page number). */
+    static bool listPage(const Filter &filter,
+                         const Cursor &after,
+                         int limit,
+                         QVector<Summary> &out,
+                         bool *hasMore = nullptr,
+                         QString *errorMsg = nullptr);
+
+    static bool loadPayload(int experimentId,
+                            Payload &out,
+                            QString *errorMsg = nullptr);
+
+    /** All payloads in one query; unknown ids are skipped. */
+    static bool loadPayloads(const QList<int> &experimentIds,
+                             QVector<Payload> &out,
+                             QString *errorMsg = nullptr);
+
+    /**
+     * Insert or replace (by experiment_code) an experiment and link it in
+     * experiment_requests to the request_ids in `json["test_requests"]`;
+     * existing links are kept. One statement in one transaction: either
+     * everything is written or nothing is. Saving the same experiment again
+     * rewrites the row (date_created moves) but adds no links or version.
+     *
+     * A changed payload also adds a row to experiment_versions. When
+     * `previous` is the snapshot the user started from, `previousVersion`
+     * its version, and that is still the latest version with the same
+     * content hash, only the delta to it is stored (with parent_version);
+     * otherwise, and every kVersionsPerBase versions, a full base. A save
+     * that loses the race for the next version number to a concurrent one
+     * is retried and stores a base. `version` receives the latest version.
+     */
+    static bool save(const QString &experimentCode,
+                     const QJsonObject &json,
+                     const QJsonObject *previous = nullptr,
+                     int previousVersion = 0,
+                     int *experimentId = nullptr,
+                     int *version = nullptr,
+                     QString *errorMsg = nullptr);
+
+    /* ---- version history (sql/migrations/003) ---- */
+    static constexpr int kVersionsPerBase = 20;
+
+    struct VersionInfo {
+        int       version = 0;
+        QDateTime createdAt;
+        QString   createdBy;
+        QString   contentHash;
+        bool      isBase = false;
+        int       storedBytes = 0;  // base or delta, as stored
+    };
+
+    /** Newest first. */
+    static bool listVersions(int experimentId,
+                             QVector<VersionInfo> &out,
+                             QString *errorMsg = nullptr);
+
+    /** Payload of one version, rebuilt on the server. */
+    static bool loadVersion(int experimentId,
+                            int version,
+                            QJsonObject &out,
+                            QString *errorMsg = nullptr);
+
+    /** The stored delta from version-1 to `version`; false for a base. */
+    static bool loadVersionDelta(int experimentId,
+                                 int version,
+                                 QJsonArray &out,
+                                 QString *errorMsg = nullptr);
+};
+
+#endif // EXPERIMENTSTORE_H
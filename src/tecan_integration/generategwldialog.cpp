@@ -18,6 +18,21 @@ GenerateGwlDialog::GenerateGwlDialog(QWidget *parent)
     fluentCheck_->setChecked(true); // default Fluent
     layout->addWidget(fluentCheck_);
 
+    channelCheck_ = new QCheckBox("Parallel 8-channel pipetting (Fluent LiHa)", this);
+    channelCheck_->setChecked(true);
+    layout->addWidget(channelCheck_);
+    connect(fluentCheck_, &QCheckBox::toggled, channelCheck_, &QCheckBox::setEnabled);
+
+    mcaCheck_ = new QCheckBox("Use MCA96 head for whole-plate / whole-column steps", this);
+    mcaCheck_->setChecked(false);
+    layout->addWidget(mcaCheck_);
+    connect(fluentCheck_, &QCheckBox::toggled, mcaCheck_, &QCheckBox::setEnabled);
+
+    travelCheck_ = new QCheckBox("Order transfers to minimise arm travel", this);
+    travelCheck_->setChecked(true);
+    layout->addWidget(travelCheck_);
+    connect(fluentCheck_, &QCheckBox::toggled, travelCheck_, &QCheckBox::setEnabled);
+
     auto *btns = new QHBoxLayout();
     ok_ = new QPushButton("Generate", this);
     cancel_ = new QPushButton("Cancel", this);
@@ -34,3 +49,18 @@ bool GenerateGwlDialog::useFluent() const
 {
     return fluentCheck_ && fluentCheck_->isChecked();
 }
+
+bool GenerateGwlDialog::useChannelBatching() const
+{
+    return useFluent() && channelCheck_ && channelCheck_->isChecked();
+}
+
+bool GenerateGwlDialog::useMcaStamping() const
+{
+    return useFluent() && mcaCheck_ && mcaCheck_->isChecked();
+}
+
+bool GenerateGwlDialog::useTravelOptimisation() const
+{
+    return useFluent() && travelCheck_ && travelCheck_->isChecked();
+}
@@ -12,9 +12,15 @@ class GenerateGwlDialog : public QDialog
 public:
     explicit GenerateGwlDialog(QWidget *parent = nullptr);
     bool useFluent() const;
+    bool useChannelBatching() const;
+    bool useMcaStamping() const;
+    bool useTravelOptimisation() const;
 
 private:
     QCheckBox *fluentCheck_{nullptr};
+    QCheckBox *channelCheck_{nullptr};
+    QCheckBox *mcaCheck_{nullptr};
+    QCheckBox *travelCheck_{nullptr};
     QPushButton *ok_{nullptr};
     QPushButton *cancel_{nullptr};
 };
@@ -1,7 +1,12 @@
 #include "gwlgenerator.h"
+#include "channelscheduler.h"
+#include "travelorderer.h"
+#include "gwlregistry.h"
+#include "daughterlayout.h"
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <memory>
 
 #include <QObject>
@@ -37,6 +42,44 @@ GWLGenerator::GWLGenerator(double dilutionFactor,
 
 GWLGenerator::~GWLGenerator() = default;
 
+std::unique_ptr<GWLGenerator> GWLGenerator::forExperiment(const QJsonObject &exp)
+{
+    // JSON from the editor carries no `_instrument`; the Fluent is the only
+    // backend that writes worklists
+    const QString name = exp.value("_instrument").toString();
+    return forExperiment(exp, name.isEmpty() ? Instrument::FLUENT1080 : instrumentFromName(name));
+}
+
+std::unique_ptr<GWLGenerator> GWLGenerator::forExperiment(const QJsonObject &exp,
+                                                          Instrument instrument)
+{
+    // Dilution factor (some JSONs store the number as text; fallback 3.16)
+    double dilutionFactor = 3.16;
+    QString testId;
+    const QJsonArray trArr = exp.value("test_requests").toArray();
+    if (!trArr.isEmpty()) {
+        const auto tr0 = trArr.at(0).toObject();
+        bool ok = false;
+        const double df = tr0.value("dilution_steps_unit").toString().toDouble(&ok);
+        if (ok && df > 0.0) dilutionFactor = df;
+        testId = tr0.value("requested_tests").toString();
+    }
+
+    // Stock concentration of the first compound (mM -> µM)
+    double stockConcMicroM = 0.0;
+    const QJsonArray cmpArr = exp.value("compounds").toArray();
+    if (!cmpArr.isEmpty()) {
+        const auto cmp0  = cmpArr.at(0).toObject();
+        const double sc  = cmp0.value("concentration").toDouble();
+        const QString cu = cmp0.value("concentration_unit").toString();
+        stockConcMicroM = (cu.compare("mM", Qt::CaseInsensitive) == 0) ? sc * 1000.0 : sc;
+    }
+
+    auto gen = std::make_unique<GWLGenerator>(dilutionFactor, testId, stockConcMicroM, instrument);
+    gen->setOptions(optionsFromJson(exp));
+    return gen;
+}
+
 bool GWLGenerator::generate(const QJsonObject &root,
                             QVector<FileOut> &outs,
                             QString *err) const
@@ -60,7 +103,7 @@ bool GWLGenerator::Evo150Backend::generate(const QJsonObject &,
                                            QString *err) const
 {
     if (err) *err = "EVO150 backend not implemented yet.";
-    return true;
+    return false;
 }
 
 bool GWLGenerator::Evo150Backend::generateAux(const QJsonObject &,
@@ -74,56 +117,79 @@ bool GWLGenerator::Evo150Backend::generateAux(const QJsonObject &,
 
 namespace {
 
-// normalize "A01"/"a1" -> "A1"
+// normalize "A01"/"a1" -> "A1" (two-letter rows on 1536: "ab07" -> "AB7")
 static QString normWell(const QString &s) {
     if (s.isEmpty()) return s;
     QString t = s.trimmed().toUpper();
-    if (t.size() < 2) return t;
-    QChar row = t.at(0);
-    bool ok=false; int col = t.mid(1).toInt(&ok);
+    int n = 0;
+    while (n < t.size() && t.at(n) >= 'A' && t.at(n) <= 'Z') ++n;
+    if (n == 0 || n == t.size()) return t;
+    bool ok=false; int col = t.mid(n).toInt(&ok);
     if (!ok) return t;
-    return QString("%1%2").arg(row).arg(col);
+    return t.left(n) + QString::number(col);
 }
 
 // "A1" -> "A01" for CSV
 static QString toA01(const QString &s) {
     const QString n = normWell(s);
-    if (n.size() < 2) return n;
-    const QChar row = n.at(0);
-    bool ok=false; int col = n.mid(1).toInt(&ok);
+    int r = 0;
+    while (r < n.size() && n.at(r) >= 'A' && n.at(r) <= 'Z') ++r;
+    if (r == 0 || r == n.size()) return n;
+    bool ok=false; int col = n.mid(r).toInt(&ok);
     if (!ok) return n;
-    return QString("%1%2").arg(row).arg(col, 2, 10, QChar('0'));
+    return QString("%1%2").arg(n.left(r)).arg(col, 2, 10, QChar('0'));
 }
 
-// A1..H12 <-> 1..96 (column-major: down A..H then next column)
-static int wellNameToIndex96(const QString &w) {
-    const QString n = normWell(w);
-    if (n.size() < 2) return -1;
-    const QChar rowCh = n.at(0);
-    bool ok=false; int col = n.mid(1).toInt(&ok);
-    if (!ok || col < 1 || col > 12) return -1;
-    int row = rowCh.unicode() - QChar('A').unicode();
-    if (row < 0 || row > 7) return -1;
-    return (col - 1) * 8 + row + 1; // 1..96
-}
+// Plate geometry for 1-based, column-major positions (down the rows, then the
+// next column: A1=1, B1=2 … H12=96 on 8 x 12). Daughter plates take their
+// format from the plate JSON (96, 384 or 1536 wells); matrix racks and the
+// standard rack are always 8 x 12.
+struct PlateGeometry {
+    int rows = 8;
+    int cols = 12;
+
+    static PlateGeometry of(const QJsonObject &plate) {
+        const DaughterLayoutEngine::Format f = DaughterLayoutEngine::formatOfPlate(plate);
+        return PlateGeometry{ f.rows, f.columns };
+    }
 
-static QString indexToWellName96(int idx) {
-    if (idx < 1 || idx > 96) return {};
-    const int zero = idx - 1;
-    const int row  = zero % 8;           // 0..7 -> A..H
-    const int col  = zero / 8 + 1;       // 1..12
-    const QChar rowCh = QChar('A' + row);
-    return QString("%1%2").arg(rowCh).arg(col);
-}
+    int wells() const { return rows * cols; }
 
-static QSet<int> fullPlate96Indices() {
-    QSet<int> s; for (int i=1;i<=96;++i) s.insert(i); return s;
-}
+    // "B3" -> position, -1 if not on this plate
+    int index(const QString &w) const {
+        int r = 0, c = 0;
+        if (!DaughterLayoutEngine::parseWell(w, r, c) || r >= rows || c >= cols) return -1;
+        return c * rows + r + 1;
+    }
+
+    QString name(int idx) const {
+        if (idx < 1 || idx > wells()) return {};
+        return DaughterLayoutEngine::wellName(rowOf(idx), colOf(idx) - 1);
+    }
+
+    int rowOf(int idx) const { return (idx - 1) % rows; }      // 0-based (A = 0)
+    int colOf(int idx) const { return (idx - 1) / rows + 1; }  // 1-based
+
+    // Neighbour `step` away: +-rows is the next/previous column (along the
+    // row), +-1 the next/previous row (down the column, never wrapping into
+    // the next column). -1 if that leaves the plate.
+    int step(int idx, int step) const {
+        const int nxt = idx + step;
+        if (idx < 1 || nxt < 1 || nxt > wells()) return -1;
+        if ((step == 1 || step == -1) && colOf(nxt) != colOf(idx)) return -1;
+        return nxt;
+    }
+
+    // tip / MCA channel pitch (9 mm) in wells: 1 on 96, 2 on 384, 4 on 1536
+    int pitch() const { return std::max(1, rows / 8); }
+};
 
-static QSet<int> namesToIndices(const QSet<QString> &wells) {
+const PlateGeometry kRack96;    // matrix tubes, standard rack
+
+static QSet<int> namesToIndices(const QSet<QString> &wells, const PlateGeometry &geo) {
     QSet<int> out;
     for (const auto &w : wells) {
-        int idx = wellNameToIndex96(w);
+        int idx = geo.index(w);
         if (idx >= 1) out.insert(idx);
     }
     return out;
@@ -165,6 +231,37 @@ static void appendADFluentOneShot(QStringList &out,
     out << "W;";
 }
 
+// MCA records carry the head in the tip type field and the head columns
+// they use in the tip mask (bit n = head column n+1), e.g. "…;MCA96;4095"
+// for a whole MCA96 stamp, so readers find them without the comments
+static QString mcaTipFields(GWLGenerator::McaHead head, bool wholeHead)
+{
+    const int headCols = (head == GWLGenerator::McaHead::MCA384) ? 24 : 12;
+    return QString("%1;%2").arg(GWLGenerator::mcaHeadName(head))
+                           .arg(wholeHead ? (1 << headCols) - 1 : 1);
+}
+
+void GWLGenerator::appendTransfer(QStringList &out,
+                                  const QString &srcLabel, int srcPos,
+                                  const QString &dstLabel, int dstPos,
+                                  double volUL, const QString &liqClass)
+{
+    appendADFluentOneShot(out, srcLabel, srcPos, dstLabel, dstPos, volUL, liqClass);
+}
+
+// One MCA aspirate + dispense + wash
+void GWLGenerator::appendMcaTransfer(QStringList &out, McaHead head, bool wholeHead,
+                                     const QString &srcLabel, int srcPos,
+                                     const QString &dstLabel, int dstPos,
+                                     double volUL, const QString &liqClass)
+{
+    const QString vStr = QString::number(roundUp01(volUL), 'f', 1);
+    const QString tip  = mcaTipFields(head, wholeHead);
+    out << QString("A;%1;;;%2;;%3;%4;%5").arg(srcLabel).arg(srcPos).arg(vStr, liqClass, tip);
+    out << QString("D;%1;;;%2;;%3;%4;%5").arg(dstLabel).arg(dstPos).arg(vStr, liqClass, tip);
+    out << "W;";
+}
+
 // One aspirate, many dispenses (for DMSO multi-dispense)
 static void appendAThenManyD(QStringList &out,
                              const QString &srcLabel, int srcPos,
@@ -213,8 +310,10 @@ static double readDouble(const QJsonObject &o, const char *key, double def = 0.0
     return v;
 }
 
-// Build standard chains from layout (contiguous "Standard" along +8 or +1)
-static QVector<QStringList> buildStandardChainsFromLayout(const QJsonObject &wellsObj)
+// Build standard chains from layout (contiguous "Standard" along a row or
+// down a column)
+static QVector<QStringList> buildStandardChainsFromLayout(const QJsonObject &wellsObj,
+                                                          const PlateGeometry &geo)
 {
     QSet<QString> stdSet;
     for (auto it = wellsObj.begin(); it != wellsObj.end(); ++it) {
@@ -224,11 +323,11 @@ static QVector<QStringList> buildStandardChainsFromLayout(const QJsonObject &wel
     if (stdSet.isEmpty()) return {};
 
     QStringList sorted = QStringList(stdSet.values());
-    std::sort(sorted.begin(), sorted.end(), [](const QString &a, const QString &b){
-        return wellNameToIndex96(a) < wellNameToIndex96(b);
+    std::sort(sorted.begin(), sorted.end(), [&](const QString &a, const QString &b){
+        return geo.index(a) < geo.index(b);
     });
 
-    auto isStd = [&](const QString &w)->bool { return stdSet.contains(normWell(w)); };
+    auto isStd = [&](const QString &w)->bool { return !w.isEmpty() && stdSet.contains(normWell(w)); };
 
     QSet<QString> visited;
     QVector<QStringList> chains;
@@ -236,21 +335,22 @@ static QVector<QStringList> buildStandardChainsFromLayout(const QJsonObject &wel
     for (const QString &start : sorted) {
         if (visited.contains(start)) continue;
 
-        const int startIdx = wellNameToIndex96(start);
-        const QString prev8 = indexToWellName96(startIdx - 8);
-        const QString prev1 = indexToWellName96(startIdx - 1);
-        if (isStd(prev8) || isStd(prev1)) continue; // not a chain start
+        const int startIdx = geo.index(start);
+        if (startIdx < 1) continue;
+        const QString prevCol = geo.name(geo.step(startIdx, -geo.rows));
+        const QString prevRow = geo.name(geo.step(startIdx, -1));
+        if (isStd(prevCol) || isStd(prevRow)) continue; // not a chain start
 
         int step = 0;
-        if (isStd(indexToWellName96(startIdx + 8))) step = 8;
-        else if (isStd(indexToWellName96(startIdx + 1))) step = 1;
+        if (isStd(geo.name(geo.step(startIdx, geo.rows)))) step = geo.rows;
+        else if (isStd(geo.name(geo.step(startIdx, 1)))) step = 1;
 
         QStringList chain; chain << start; visited.insert(start);
         if (step != 0) {
             int cur = startIdx;
             while (true) {
-                const int nxt = cur + step;
-                const QString wn = indexToWellName96(nxt);
+                const int nxt = geo.step(cur, step);
+                const QString wn = geo.name(nxt);
                 if (!isStd(wn)) break;
                 chain << wn;
                 visited.insert(wn);
@@ -354,10 +454,6 @@ static bool dmsoDispenseRightToLeft(const QJsonObject& exp) {
     return false;
 }
 
-// Row/Col from 1..96 index
-static inline int rowFromIndex96(int idx) { return (idx - 1) % 8; }     // 0..7 (A..H)
-static inline int colFromIndex96(int idx) { return (idx - 1) / 8 + 1; } // 1..12
-
 // One aspirate, many dispenses (varying per-dispense volumes)
 static void appendAThenManyD_Vary(QStringList &out,
                                   const QString &srcLabel, int srcPos,
@@ -377,19 +473,41 @@ static void appendAThenManyD_Vary(QStringList &out,
     }
 }
 
+// 8-channel batch: every tip aspirates (tip mask per record), then every tip dispenses
+static void appendBatchFluent(QStringList &out,
+                              const QString &srcLabel,
+                              const QString &dstLabel,
+                              const ChannelScheduler::Batch &batch,
+                              const QString &liqClass)
+{
+    for (const auto &slot : batch) {
+        const QString vStr = QString::number(roundUp01(slot.transfer.volUL), 'f', 1);
+        out << QString("A;%1;;;%2;;%3;%4;;%5")
+                   .arg(srcLabel).arg(slot.transfer.srcPos).arg(vStr).arg(liqClass)
+                   .arg(1 << slot.channel);
+    }
+    for (const auto &slot : batch) {
+        const QString vStr = QString::number(roundUp01(slot.transfer.volUL), 'f', 1);
+        out << QString("D;%1;;;%2;;%3;%4;;%5")
+                   .arg(dstLabel).arg(slot.transfer.dstPos).arg(vStr).arg(liqClass)
+                   .arg(1 << slot.channel);
+    }
+}
+
 } // namespace
 
 // ========================== Standards Matrix Loading ==========================
 
 bool GWLGenerator::loadStandardsMatrix(QVector<StandardSource>& standards, QString* err) const
 {
-    QFile f(":/data/resources/data/standards_matrix.json");
-    if (!f.open(QIODevice::ReadOnly)) {
-        if (err) *err = "Cannot open standards_matrix.json";
-        return false;
-    }
+    return registry()->standards(standards, err);
+}
 
-    const auto doc = QJsonDocument::fromJson(f.readAll());
+bool GWLGenerator::parseStandardsMatrix(const QByteArray &json,
+                                        QVector<StandardSource>& standards,
+                                        QString* err)
+{
+    const auto doc = QJsonDocument::fromJson(json);
     if (!doc.isArray()) {
         if (err) *err = "standards_matrix.json is not an array";
         return false;
@@ -476,6 +594,17 @@ bool GWLGenerator::FluentBackend::generate(const QJsonObject &exp,
         return false;
     }
 
+    // the MCA384 head needs a plate with at least its 16 x 24 channels
+    if (outer_.options_.mcaHead == McaHead::MCA384) {
+        for (const QJsonValue &pv : plates) {
+            if (PlateGeometry::of(pv.toObject()).rows < 16) {
+                if (err) *err = QObject::tr("MCA384 cannot stamp 96-well daughter plates; "
+                                            "use MCA96 or 384/1536-well plates.");
+                return false;
+            }
+        }
+    }
+
     // ---- Audit collectors (across ALL daughter plates) ----
     QList<SeedAuditRow>     seedAudit;
     QList<DilutionAuditRow> dilutionAudit;
@@ -524,13 +653,32 @@ bool GWLGenerator::FluentBackend::generate(const QJsonObject &exp,
     double stdConc = useMatrixStandard ? selectedStandard.concentration
                                        : readDouble(stdObj, "Concentration", 20000.0);
 
-    const int stdSrcPos = wellNameToIndex96(stdSrcWell);
+    const int stdSrcPos = kRack96.index(stdSrcWell);
     const QString standardMatrixLabel = "Standard_Matrix";
 
+    const McaHead mcaHead    = outer_.options_.mcaHead;
+    const bool optimiseTravel = outer_.options_.optimiseTravel;
     const double df          = (outer_.dilutionFactor_ > 0.0) ? outer_.dilutionFactor_ : 3.16;
     const QString testId     = outer_.testId_;
     const double stockMicroM = outer_.stockConc_;
 
+    // Every start, dilution and control well ends at volMother. The plans are
+    // written for 96-well plates, so on denser plates volMother and the seed
+    // DMSO are scaled by one factor (concentrations unchanged) to fit the
+    // smallest daughter well, keeping 0.2 µL for the 0.1 µL round-ups.
+    double wellCapUL = std::numeric_limits<double>::max();
+    for (const QJsonValue &pv : plates)
+        wellCapUL = std::min(wellCapUL, DaughterLayoutEngine::wellCapacityUL(
+                                            DaughterLayoutEngine::formatOfPlate(pv.toObject())));
+    auto fitToWell = [wellCapUL](VolumePlanEntry &v) {
+        const double room = wellCapUL - 0.2;
+        if (v.volMother <= room) return;
+        const double k = room / v.volMother;
+        qDebug() << "[INFO] volume plan scaled by" << k << "to fit" << wellCapUL << "µL wells";
+        v.volMother *= k;
+        v.dmso      *= k;
+    };
+
     // Volume plans (global defaults)
     VolumePlanEntry vpe;
     QString verr;
@@ -539,11 +687,13 @@ bool GWLGenerator::FluentBackend::generate(const QJsonObject &exp,
         vpe.volMother = 30.0;
         vpe.dmso = 0.0;
     }
+    fitToWell(vpe);
 
     VolumePlanEntry stdVpe = vpe;
     if (useMatrixStandard && !testId.isEmpty()) {
         VolumePlanEntry tempVpe;
         if (outer_.loadVolumePlan(testId, stdConc, &tempVpe, &verr)) {
+            fitToWell(tempVpe);
             stdVpe = tempVpe;
             qDebug() << "[INFO] Using specific volume plan for standard at" << stdConc << "µM";
         }
@@ -601,6 +751,7 @@ bool GWLGenerator::FluentBackend::generate(const QJsonObject &exp,
         // Try to load a volume plan for this compound's stock conc
         VolumePlanEntry cvp; QString cvpErr;
         if (outer_.loadVolumePlan(testId, cStock, &cvp, &cvpErr)) {
+            fitToWell(cvp);
             p.volMother   = roundUp01(cvp.volMother);
             p.dmsoStart   = roundUp01(cvp.dmso);
             p.df          = (cDf > 0.0 ? cDf : p.df);
@@ -680,51 +831,13 @@ bool GWLGenerator::FluentBackend::generate(const QJsonObject &exp,
         const QString dghtBarcode = QString("Daughter_%1").arg(di+1);
         const QString projectCode = exp.value("project_code").toString();
         const QJsonObject wells   = plate.value("wells").toObject();
+        const PlateGeometry geo   = PlateGeometry::of(plate);
         const int nDilGlob = std::max(1, numberOfDilutionsFromJson(exp));
 
-        auto labelOf = [&](const QString& wn)->QString {
-            return wells.value(wn).toString().trimmed();
-        };
-
         QList<DaughterPlateEntry> rows;
 
-        // Standard wells (layout-driven)
-        QSet<QString> stdSet;
-        for (auto it = wells.begin(); it != wells.end(); ++it)
-            if (it.value().toString().trimmed().compare("Standard", Qt::CaseInsensitive)==0)
-                stdSet.insert(normWell(it.key()));
-
-        // split into chains
-        QStringList sortedStd = QStringList(stdSet.values());
-        std::sort(sortedStd.begin(), sortedStd.end(), [](const QString &a, const QString &b){
-            return wellNameToIndex96(a) < wellNameToIndex96(b);
-        });
-        auto isStd = [&](const QString &w)->bool { return stdSet.contains(normWell(w)); };
-        QSet<QString> visitedStd;
-        for (const QString &start : sortedStd) {
-            if (visitedStd.contains(start)) continue;
-            const int startIdx = wellNameToIndex96(start);
-            const QString prev8 = indexToWellName96(startIdx - 8);
-            const QString prev1 = indexToWellName96(startIdx - 1);
-            if (isStd(prev8) || isStd(prev1)) continue;
-
-            int step = 0;
-            if (isStd(indexToWellName96(startIdx + 8))) step = 8;
-            else if (isStd(indexToWellName96(startIdx + 1))) step = 1;
-
-            QStringList chain; chain << start; visitedStd.insert(start);
-            if (step != 0) {
-                int cur = startIdx;
-                while (true) {
-                    const int nxt = cur + step;
-                    const QString wn = indexToWellName96(nxt);
-                    if (!isStd(wn)) break;
-                    chain << wn;
-                    visitedStd.insert(wn);
-                    cur = nxt;
-                }
-            }
-
+        // Standard wells (layout-driven), chain by chain
+        for (const QStringList &chain : buildStandardChainsFromLayout(wells, geo)) {
             for (int i=0;i<chain.size();++i) {
                 DaughterPlateEntry r;
                 r.containerBarcode = dghtBarcode;
@@ -768,11 +881,11 @@ bool GWLGenerator::FluentBackend::generate(const QJsonObject &exp,
             if (step == 0) continue;
 
             const QString lab = wells.value(dst).toString().trimmed();
-            int cur = wellNameToIndex96(dst);
+            int cur = geo.index(dst);
             for (int s=1;s<nDilGlob;++s) {
-                const int nxt = cur + step;
-                if (nxt < 1 || nxt > 96) break;
-                const QString wn = indexToWellName96(nxt);
+                const int nxt = geo.step(cur, step);
+                if (nxt < 1) break;
+                const QString wn = geo.name(nxt);
                 if (wells.value(wn).toString().trimmed() != lab) break;
 
                 DaughterPlateEntry rd;
@@ -824,6 +937,10 @@ bool GWLGenerator::FluentBackend::generate(const QJsonObject &exp,
     for (int di = 0; di < plates.size(); ++di) {
         const QJsonObject plate  = plates.at(di).toObject();
         const QJsonObject wells  = plate.value("wells").toObject();
+        const PlateGeometry geo  = PlateGeometry::of(plate);
+        DeckLayout deck = DeckLayout::fluentDefault();
+        deck.setFamilyFormat(QStringLiteral("Daughter"), geo.rows, geo.cols);
+        const TravelOrderer orderer(deck);
         const QString dghtLabel  = QString("Daughter[%1]").arg(QString("%1").arg(di+1, 3, 10, QChar('0')));
         const QString dghtBarcodeStr = QString("Daughter_%1").arg(di+1);
         const int nDilGlob = std::max(1, numberOfDilutionsFromJson(exp));
@@ -847,7 +964,7 @@ bool GWLGenerator::FluentBackend::generate(const QJsonObject &exp,
         for (const auto &h : hits) byMatrix[h.srcBarcode].push_back(h);
 
         // Build standard chains from layout
-        const auto stdChains = buildStandardChainsFromLayout(wells);
+        const auto stdChains = buildStandardChainsFromLayout(wells, geo);
 
         // ------------------ SAME-LABEL chain discovery for compounds ------------------
         QSet<QString> startWells, diluteWells, controlDmsoWells;
@@ -859,8 +976,8 @@ bool GWLGenerator::FluentBackend::generate(const QJsonObject &exp,
         };
 
         QVector<Hit> hitsSorted = hits;
-        std::sort(hitsSorted.begin(), hitsSorted.end(), [](const Hit& a, const Hit& b){
-            return wellNameToIndex96(a.dstWell) < wellNameToIndex96(b.dstWell);
+        std::sort(hitsSorted.begin(), hitsSorted.end(), [&](const Hit& a, const Hit& b){
+            return geo.index(a.dstWell) < geo.index(b.dstWell);
         });
 
         QSet<QString> visited;
@@ -869,20 +986,20 @@ bool GWLGenerator::FluentBackend::generate(const QJsonObject &exp,
             if (visited.contains(start)) continue;
 
             const QString lab = labelOf(start);
-            const int startIdx = wellNameToIndex96(start);
+            const int startIdx = geo.index(start);
             if (startIdx < 1) continue;
 
-            const QString plus8 = indexToWellName96(startIdx + 8);
-            const QString plus1 = indexToWellName96(startIdx + 1);
-            const bool canAcross = (!plus8.isEmpty() && labelOf(plus8) == lab);
-            const bool canDown   = (!plus1.isEmpty() && labelOf(plus1) == lab);
+            const QString nextCol = geo.name(geo.step(startIdx, geo.rows));
+            const QString nextRow = geo.name(geo.step(startIdx, 1));
+            const bool canAcross = (!nextCol.isEmpty() && labelOf(nextCol) == lab);
+            const bool canDown   = (!nextRow.isEmpty() && labelOf(nextRow) == lab);
 
             int step = 0;
-            if (canAcross) step = 8;
+            if (canAcross) step = geo.rows;
             else if (canDown) step = 1;
 
             if (step != 0) {
-                const QString prev = indexToWellName96(startIdx - step);
+                const QString prev = geo.name(geo.step(startIdx, -step));
                 if (!prev.isEmpty() && labelOf(prev) == lab) {
                     visited.insert(start);
                     continue;
@@ -897,9 +1014,9 @@ bool GWLGenerator::FluentBackend::generate(const QJsonObject &exp,
             if (step != 0) {
                 int cur = startIdx;
                 for (int s=1; s<nDilGlob; ++s) {
-                    const int nxt = cur + step;
-                    if (nxt < 1 || nxt > 96) break;
-                    const QString wn = indexToWellName96(nxt);
+                    const int nxt = geo.step(cur, step);
+                    if (nxt < 1) break;
+                    const QString wn = geo.name(nxt);
                     if (labelOf(wn) != lab) break;
                     diluteWells.insert(wn);
                     visited.insert(wn);
@@ -940,16 +1057,16 @@ bool GWLGenerator::FluentBackend::generate(const QJsonObject &exp,
 
             auto addVolAt = [&](int destIdx, double v){
                 const double vv = roundUp01(v);
-                if (vv <= 0.0) return;
-                row2pos2vol[rowFromIndex96(destIdx)][destIdx] += vv;
+                if (vv <= 0.0 || destIdx < 1) return;
+                row2pos2vol[geo.rowOf(destIdx)][destIdx] += vv;
             };
 
             // Standards per their own plan
             for (const auto& chain : stdChains) {
                 if (chain.isEmpty()) continue;
-                addVolAt(wellNameToIndex96(chain.first()), stdDmsoStart);
+                addVolAt(geo.index(chain.first()), stdDmsoStart);
                 for (int i = 1; i < chain.size(); ++i)
-                    addVolAt(wellNameToIndex96(chain.at(i)), stdDmsoDilute);
+                    addVolAt(geo.index(chain.at(i)), stdDmsoDilute);
             }
 
             // Compounds: per-chain using perPlan of THAT product
@@ -961,14 +1078,14 @@ bool GWLGenerator::FluentBackend::generate(const QJsonObject &exp,
                     const int step = perHitStep.value(start, 0);
                     const int nDilC = std::max(1, plan.nDil);
 
-                    int cur = wellNameToIndex96(start);
+                    int cur = geo.index(start);
                     addVolAt(cur, plan.dmsoStart); // start
 
                     if (step != 0) {
                         for (int s=1; s<nDilC; ++s) {
-                            const int nxt = cur + step;
-                            if (nxt < 1 || nxt > 96) break;
-                            const QString wn = indexToWellName96(nxt);
+                            const int nxt = geo.step(cur, step);
+                            if (nxt < 1) break;
+                            const QString wn = geo.name(nxt);
                             if (wells.value(wn).toString().trimmed() != prod) break;
                             addVolAt(nxt, plan.dmsoDilute);
                             cur = nxt;
@@ -978,13 +1095,89 @@ bool GWLGenerator::FluentBackend::generate(const QJsonObject &exp,
             }
 
             // DMSO controls use full mother volume (global)
-            for (int idx : namesToIndices(controlDmsoWells)) addVolAt(idx, volMother);
+            for (int idx : namesToIndices(controlDmsoWells, geo)) addVolAt(idx, volMother);
+
+            // MCA: head columns with one uniform volume go to the head instead of
+            // the LiHa. On 384/1536 plates a head column is every pitch-th well of
+            // a plate column (one stamp per row offset), and a whole plate takes
+            // one stamp per quadrant.
+            if (mcaHead != McaHead::None) {
+                const int headRows = (mcaHead == McaHead::MCA384) ? 16 : 8;
+                const int unitRows = headRows;
+                const int offsets  = std::max(1, geo.rows / headRows);   // checked above: >= 1
+
+                auto unitWell = [&](int col, int off, int i) {   // col 1-based
+                    return (col - 1) * geo.rows + off + i * offsets + 1;
+                };
+
+                struct Unit { int col; int off; double vol; };
+                QVector<Unit> units;                            // uniform head columns
+                for (int c = 1; c <= geo.cols; ++c) {
+                    for (int off = 0; off < offsets; ++off) {
+                        double v = -1.0;
+                        bool uniform = true;
+                        for (int i = 0; i < unitRows && uniform; ++i) {
+                            const int idx = unitWell(c, off, i);
+                            const auto rowIt = row2pos2vol.constFind(geo.rowOf(idx));
+                            if (rowIt == row2pos2vol.cend() || !rowIt->contains(idx)) { uniform = false; break; }
+                            const double rv = roundUp01(rowIt->value(idx));
+                            if (v < 0.0) v = rv;
+                            else if (std::fabs(rv - v) > 1e-9) uniform = false;
+                        }
+                        if (uniform && v > 0.0) units.push_back(Unit{ c, off, v });
+                    }
+                }
+
+                bool wholePlate = (units.size() == geo.cols * offsets);
+                for (const auto &u : std::as_const(units))
+                    if (wholePlate && std::fabs(u.vol - units.first().vol) > 1e-9) wholePlate = false;
+
+                if (!units.isEmpty()) {
+                    const QString head = mcaHeadName(mcaHead);
+                    const QString mcaClass = QStringLiteral("DMSO MCA Invenesis");
+                    QStringList M;
+                    M << QString("C;%1 DMSO backfill — position = well under head channel A1, volumes per tip").arg(head);
+                    M << "B;";
+
+                    if (wholePlate) {
+                        for (int qc = 0; qc < offsets; ++qc) {
+                            for (int qr = 0; qr < offsets; ++qr) {
+                                M << QString("C;%1 plate").arg(head);
+                                appendMcaTransfer(M, mcaHead, true, QStringLiteral("100ml_Higher"), 1,
+                                                  dghtLabel, qc * geo.rows + qr + 1,
+                                                  units.first().vol, mcaClass);
+                            }
+                        }
+                    } else {
+                        for (const auto &u : std::as_const(units)) {
+                            M << QString("C;%1 column").arg(head);
+                            appendMcaTransfer(M, mcaHead, false, QStringLiteral("100ml_Higher"), 1,
+                                              dghtLabel, unitWell(u.col, u.off, 0), u.vol, mcaClass);
+                        }
+                    }
+                    M << "B;";
+
+                    for (const auto &u : std::as_const(units))
+                        for (int i = 0; i < unitRows; ++i) {
+                            const int idx = unitWell(u.col, u.off, i);
+                            row2pos2vol[geo.rowOf(idx)].remove(idx);
+                        }
+
+                    FileOut fm;
+                    fm.relativePath = QString("dght_%1/MCA_DMSO.gwl").arg(di);
+                    fm.lines = M;
+                    outs.push_back(std::move(fm));
+                }
+            }
+
+            // Per row: (destIdx, roundedVol) in column order, split into
+            // aspirates of at most ~340 µL (350 µL tips)
+            const double CHUNK_LIMIT = 340.0;
+            QVector<QList<QList<QPair<int,double>>>> rowChunks(geo.rows);
 
-            // Emit per row
-            for (int r = 0; r < 8; ++r) {
+            for (int r = 0; r < geo.rows; ++r) {
                 if (!row2pos2vol.contains(r) || row2pos2vol[r].isEmpty()) continue;
 
-                // sorted list of (destIdx, roundedVol) in column order
                 QList<QPair<int,double>> posVols;
                 posVols.reserve(row2pos2vol[r].size());
                 for (auto it = row2pos2vol[r].cbegin(); it != row2pos2vol[r].cend(); ++it)
@@ -992,37 +1185,94 @@ bool GWLGenerator::FluentBackend::generate(const QJsonObject &exp,
 
                 std::sort(posVols.begin(), posVols.end(),
                           [&](const QPair<int,double>& a, const QPair<int,double>& b){
-                              const int ca = colFromIndex96(a.first);
-                              const int cb = colFromIndex96(b.first);
+                              const int ca = geo.colOf(a.first);
+                              const int cb = geo.colOf(b.first);
                               return rtl ? (ca > cb) : (ca < cb);
                           });
 
-                // Optional safety: split if total > ~340 µL (350 µL tips)
-                const double CHUNK_LIMIT = 340.0;
                 QList<QPair<int,double>> chunk;
                 double chunkSum = 0.0;
-
-                auto flushChunk = [&](){
-                    if (chunk.isEmpty()) return;
-                    appendAThenManyD_Vary(L,
-                                          QStringLiteral("100ml_Higher"), 1,
-                                          dghtLabel,
-                                          chunk,
-                                          QStringLiteral("DMSO Contact Dry Multi Invenesis"));
-                    chunk.clear();
-                    chunkSum = 0.0;
-                    L << "W;"; // close this aspirate
-                };
-
                 for (const auto &pv : posVols) {
                     const double v = pv.second; // already rounded
                     if (chunkSum + v > CHUNK_LIMIT && !chunk.isEmpty()) {
-                        flushChunk();
+                        rowChunks[r].push_back(chunk);
+                        chunk.clear();
+                        chunkSum = 0.0;
                     }
                     chunk.push_back(pv);
                     chunkSum += v;
                 }
-                flushChunk(); // last chunk
+                if (!chunk.isEmpty()) rowChunks[r].push_back(chunk);
+            }
+
+            const QString dmsoClass = QStringLiteral("DMSO Contact Dry Multi Invenesis");
+
+            if (!outer_.options_.channelBatching) {
+                // Emit per row, one tip at a time
+                for (int r = 0; r < geo.rows; ++r) {
+                    for (const auto &chunk : std::as_const(rowChunks[r])) {
+                        appendAThenManyD_Vary(L,
+                                              QStringLiteral("100ml_Higher"), 1,
+                                              dghtLabel,
+                                              chunk,
+                                              dmsoClass);
+                        L << "W;"; // close this aspirate
+                    }
+                }
+            } else {
+                // One tip per row: wave k = k-th aspirate of every tip, then all
+                // dispenses column by column (each tip stays on its own row).
+                // Denser plates have more rows than tips: tip n serves rows
+                // n*pitch … n*pitch+pitch-1, one row after the other.
+                const int pitch = geo.pitch();
+                L << (pitch == 1 ? QStringLiteral("C;8-channel mode: tip n serves row n, trough position n")
+                                 : QString("C;8-channel mode: tip n serves rows %1n-%1n+%2, trough position n")
+                                       .arg(pitch).arg(pitch - 1));
+
+                struct Chunk { QList<QPair<int,double>> posVols; int row; };
+                QVector<QList<Chunk>> tipChunks(ChannelScheduler::kChannels);
+                for (int r = 0; r < geo.rows; ++r) {
+                    const int tip = std::min(r / pitch, ChannelScheduler::kChannels - 1);
+                    for (const auto &chunk : std::as_const(rowChunks[r]))
+                        tipChunks[tip].push_back(Chunk{ chunk, r });
+                }
+
+                int waves = 0;
+                for (const auto &chunks : std::as_const(tipChunks))
+                    waves = std::max(waves, static_cast<int>(chunks.size()));
+
+                for (int w = 0; w < waves; ++w) {
+                    struct Disp { int pos; double vol; int row; int tip; };
+                    QVector<Disp> disps;
+
+                    for (int t = 0; t < tipChunks.size(); ++t) {
+                        if (w >= tipChunks[t].size()) continue;
+                        const auto &chunk = tipChunks[t].at(w);
+                        double total = 0.0;
+                        for (const auto &pv : chunk.posVols) {
+                            total += pv.second;
+                            disps.push_back({ pv.first, pv.second, chunk.row, t });
+                        }
+                        L << QString("A;%1;;;%2;;%3;%4;;%5")
+                                 .arg(QStringLiteral("100ml_Higher")).arg(t + 1)
+                                 .arg(QString::number(roundUp01(total), 'f', 1))
+                                 .arg(dmsoClass).arg(1 << t);
+                    }
+
+                    std::stable_sort(disps.begin(), disps.end(), [&](const Disp &a, const Disp &b){
+                        const int ca = geo.colOf(a.pos);
+                        const int cb = geo.colOf(b.pos);
+                        if (ca != cb) return rtl ? (ca > cb) : (ca < cb);
+                        return a.row < b.row;
+                    });
+                    for (const auto &d : std::as_const(disps)) {
+                        L << QString("D;%1;;;%2;;%3;%4;;%5")
+                                 .arg(dghtLabel).arg(d.pos)
+                                 .arg(QString::number(d.vol, 'f', 1))
+                                 .arg(dmsoClass).arg(1 << d.tip);
+                    }
+                    L << "W;";
+                }
             }
 
             L << "B;";
@@ -1055,7 +1305,7 @@ bool GWLGenerator::FluentBackend::generate(const QJsonObject &exp,
                     if (volStartStandard > 1e-6) {
                         for (const auto &chain : stdChains) {
                             if (chain.isEmpty()) continue;
-                            const int startPos = wellNameToIndex96(chain.first());
+                            const int startPos = geo.index(chain.first());
                             appendADFluentOneShot(L, standardMatrixLabel, stdSrcPos, dghtLabel, startPos,
                                                   volStartStandard, "DMSO Matrix");
                             // Audit: standard seeding
@@ -1080,30 +1330,67 @@ bool GWLGenerator::FluentBackend::generate(const QJsonObject &exp,
                     }
 
                     std::sort(startSeeds.begin(), startSeeds.end(),
-                              [](const Hit& a, const Hit& b){
-                                  return wellNameToIndex96(a.dstWell) < wellNameToIndex96(b.dstWell);
+                              [&](const Hit& a, const Hit& b){
+                                  return geo.index(a.dstWell) < geo.index(b.dstWell);
                               });
 
-                    for (const auto &h : startSeeds) {
+                    QVector<ChannelScheduler::Transfer> seeds;
+                    seeds.reserve(startSeeds.size());
+                    for (int si = 0; si < startSeeds.size(); ++si) {
+                        const auto &h = startSeeds.at(si);
                         const auto plan = perPlan.value(h.product, makeDefaultPlan());
                         const double volCompound = roundUp01(std::max(0.0, plan.volMother - plan.dmsoStart));
                         if (volCompound <= 0.0) continue;
 
-                        const int srcPos = wellNameToIndex96(h.srcWell);
-                        const int dstPos = wellNameToIndex96(h.dstWell);
-                        appendADFluentOneShot(L, matrixLabel, srcPos, dghtLabel, dstPos,
-                                              volCompound, "DMSO Matrix");
+                        ChannelScheduler::Transfer t;
+                        t.srcPos = kRack96.index(h.srcWell);
+                        t.dstPos = geo.index(h.dstWell);
+                        t.volUL  = volCompound;
+                        t.tag    = si;
+                        seeds.push_back(t);
+                    }
 
-                        // Audit: compound seeding
+                    auto auditSeed = [&](const ChannelScheduler::Transfer &t) {
+                        const auto &h = startSeeds.at(t.tag);
                         SeedAuditRow ar;
                         ar.daughterBarcode = dghtBarcodeStr;
                         ar.analyte         = h.product;
                         ar.matrixBarcode   = h.srcBarcode;
                         ar.matrixWell      = h.srcWell;
                         ar.startWell       = h.dstWell;
-                        ar.seedVolumeUL    = volCompound;
+                        ar.seedVolumeUL    = t.volUL;
                         ar.notes           = "compound";
                         seedAudit.push_back(ar);
+                    };
+
+                    if (outer_.options_.channelBatching) {
+                        auto batches = ChannelScheduler(geo.rows, kRack96.rows).batchIndependent(seeds);
+                        if (optimiseTravel) {
+                            QVector<TravelOrderer::Job> jobs;
+                            jobs.reserve(batches.size());
+                            for (const auto &b : std::as_const(batches))
+                                jobs.push_back(orderer.job(matrixLabel, b.first().transfer.srcPos,
+                                                           dghtLabel, b.last().transfer.dstPos));
+                            batches = TravelOrderer::permuted(batches, orderer.order(jobs));
+                        }
+                        for (const auto &b : batches) {
+                            appendBatchFluent(L, matrixLabel, dghtLabel, b, "DMSO Matrix");
+                            L << "W;";
+                            for (const auto &slot : b) auditSeed(slot.transfer);
+                        }
+                    } else {
+                        if (optimiseTravel) {
+                            QVector<TravelOrderer::Job> jobs;
+                            jobs.reserve(seeds.size());
+                            for (const auto &t : std::as_const(seeds))
+                                jobs.push_back(orderer.job(matrixLabel, t.srcPos, dghtLabel, t.dstPos));
+                            seeds = TravelOrderer::permuted(seeds, orderer.order(jobs));
+                        }
+                        for (const auto &t : std::as_const(seeds)) {
+                            appendADFluentOneShot(L, matrixLabel, t.srcPos, dghtLabel, t.dstPos,
+                                                  t.volUL, "DMSO Matrix");
+                            auditSeed(t);
+                        }
                     }
                 }
 
@@ -1134,31 +1421,77 @@ bool GWLGenerator::FluentBackend::generate(const QJsonObject &exp,
                 L << "W;";
             };
 
+            // Chains are collected first and then emitted, either one tip per chain
+            // or (8-channel mode) chains of the same shape in lock-step. With travel
+            // optimisation the chains/blocks are reordered; steps inside a chain
+            // keep their order.
+            const bool batching = outer_.options_.channelBatching;
+            auto emitChains = [&](const QVector<ChannelScheduler::Chain>& cs){
+                if (batching) {
+                    auto blocks = ChannelScheduler(geo.rows).batchChains(cs);
+                    if (optimiseTravel) {
+                        QVector<TravelOrderer::Job> jobs;
+                        jobs.reserve(blocks.size());
+                        for (const auto& blk : std::as_const(blocks))
+                            jobs.push_back(orderer.job(dghtLabel, blk.steps.first().first().transfer.srcPos,
+                                                       dghtLabel, blk.steps.last().last().transfer.dstPos));
+                        blocks = TravelOrderer::permuted(blocks, orderer.order(jobs));
+                    }
+                    for (const auto& blk : std::as_const(blocks)) {
+                        for (const auto& b : blk.steps)
+                            appendBatchFluent(L, dghtLabel, dghtLabel, b,
+                                              "DMSO Contact Wet Single Invenesis");
+                        L << "W;";
+                    }
+                    return;
+                }
+
+                QVector<ChannelScheduler::Chain> ordered = cs;
+                if (optimiseTravel) {
+                    QVector<TravelOrderer::Job> jobs;
+                    jobs.reserve(cs.size());
+                    for (const auto& c : cs)
+                        jobs.push_back(orderer.job(dghtLabel, c.pos.first(), dghtLabel, c.pos.last()));
+                    ordered = TravelOrderer::permuted(cs, orderer.order(jobs));
+                }
+                for (const auto& c : std::as_const(ordered)) emitChain(c.pos, c.volUL);
+            };
+            auto collectChain = [&](QVector<ChannelScheduler::Chain>& cs,
+                                    const QList<int>& pos, double volUL){
+                if (pos.size() < 2 || roundUp01(volUL) <= 0.0) return;
+                ChannelScheduler::Chain c;
+                c.pos   = pos;
+                c.volUL = volUL;
+                cs.push_back(c);
+            };
+
             // ---------------- Standards first (sorted by start index) ----------------
             if (stdTransferVol > 1e-6 && !stdChains.isEmpty()) {
                 QVector<QStringList> stdSorted = stdChains;
                 std::sort(stdSorted.begin(), stdSorted.end(),
                           [&](const QStringList& a, const QStringList& b){
-                              return wellNameToIndex96(a.first()) < wellNameToIndex96(b.first());
+                              return geo.index(a.first()) < geo.index(b.first());
                           });
 
+                QVector<ChannelScheduler::Chain> stdBatch;
                 for (const auto& chain : stdSorted) {
                     QList<int> pos;
-                    for (const auto& wn : chain) pos.push_back(wellNameToIndex96(wn));
-                    emitChain(pos, stdTransferVol);
+                    for (const auto& wn : chain) pos.push_back(geo.index(wn));
+                    collectChain(stdBatch, pos, stdTransferVol);
 
                     // Audit: standard dilution steps
                     for (int i = 0; i + 1 < pos.size(); ++i) {
                         DilutionAuditRow dr;
                         dr.daughterBarcode = dghtBarcodeStr;
                         dr.analyte         = (stdName.isEmpty() ? "Standard" : stdName);
-                        dr.srcWell         = indexToWellName96(pos[i]);
-                        dr.dstWell         = indexToWellName96(pos[i+1]);
+                        dr.srcWell         = geo.name(pos[i]);
+                        dr.dstWell         = geo.name(pos[i+1]);
                         dr.transferUL      = stdTransferVol;
                         dr.notes           = "standard";
                         dilutionAudit.push_back(dr);
                     }
                 }
+                emitChains(stdBatch);
             }
 
             // ---------------- Compounds (sorted by the first A; index), PER-COMPOUND plan ----------------
@@ -1177,20 +1510,20 @@ bool GWLGenerator::FluentBackend::generate(const QJsonObject &exp,
                     const int nDilC = std::max(1, plan.nDil);
 
                     QList<int> pos;
-                    int cur = wellNameToIndex96(start);
+                    int cur = geo.index(start);
                     pos.push_back(cur);
 
                     for (int s = 1; s < nDilC; ++s) {
-                        const int nxt = cur + step;
-                        if (nxt < 1 || nxt > 96) break;
-                        const QString wn = indexToWellName96(nxt);
+                        const int nxt = geo.step(cur, step);
+                        if (nxt < 1) break;
+                        const QString wn = geo.name(nxt);
                         if (labelOf(wn) != prod) break;
                         pos.push_back(nxt);
                         cur = nxt;
                     }
 
                     if (pos.size() >= 2) {
-                        CChain c; c.startIdx = wellNameToIndex96(start); c.pos = std::move(pos);
+                        CChain c; c.startIdx = geo.index(start); c.pos = std::move(pos);
                         chains.push_back(std::move(c));
                     }
                 }
@@ -1200,25 +1533,27 @@ bool GWLGenerator::FluentBackend::generate(const QJsonObject &exp,
                           [](const CChain& a, const CChain& b){ return a.startIdx < b.startIdx; });
 
                 // emit with per-compound transfer volume + audit
+                QVector<ChannelScheduler::Chain> cmpBatch;
                 for (const auto& c : chains){
-                    const QString startWellName = indexToWellName96(c.startIdx);
+                    const QString startWellName = geo.name(c.startIdx);
                     const QString analyteName   = startWell2Product.value(startWellName,
                                                                         QString("Compound_%1").arg(startWellName));
                     const auto plan = perPlan.value(analyteName, makeDefaultPlan());
 
-                    emitChain(c.pos, plan.transferVol);
+                    collectChain(cmpBatch, c.pos, plan.transferVol);
 
                     for (int i = 0; i + 1 < c.pos.size(); ++i) {
                         DilutionAuditRow dr;
                         dr.daughterBarcode = dghtBarcodeStr;
                         dr.analyte         = analyteName;
-                        dr.srcWell         = indexToWellName96(c.pos[i]);
-                        dr.dstWell         = indexToWellName96(c.pos[i+1]);
+                        dr.srcWell         = geo.name(c.pos[i]);
+                        dr.dstWell         = geo.name(c.pos[i+1]);
                         dr.transferUL      = plan.transferVol;
                         dr.notes           = "compound";
                         dilutionAudit.push_back(dr);
                     }
                 }
+                emitChains(cmpBatch);
             }
 
             L << "B;";
@@ -1277,6 +1612,45 @@ bool GWLGenerator::FluentBackend::generateAux(const QJsonObject &,
 
 // ============================= Shared helpers (class) ============================
 
+QString GWLGenerator::mcaHeadName(McaHead head)
+{
+    switch (head) {
+    case McaHead::MCA96:  return QStringLiteral("MCA96");
+    case McaHead::MCA384: return QStringLiteral("MCA384");
+    case McaHead::None:
+    default:              return QString();
+    }
+}
+
+GWLGenerator::McaHead GWLGenerator::mcaHeadFromName(const QString &name)
+{
+    if (name.compare("MCA96", Qt::CaseInsensitive) == 0)  return McaHead::MCA96;
+    if (name.compare("MCA384", Qt::CaseInsensitive) == 0) return McaHead::MCA384;
+    return McaHead::None;
+}
+
+QString GWLGenerator::instrumentName(Instrument instrument)
+{
+    return instrument == Instrument::FLUENT1080 ? QStringLiteral("FLUENT1080")
+                                                : QStringLiteral("EVO150");
+}
+
+GWLGenerator::Instrument GWLGenerator::instrumentFromName(const QString &name)
+{
+    return name.compare("FLUENT1080", Qt::CaseInsensitive) == 0
+               ? Instrument::FLUENT1080
+               : Instrument::EVO150;
+}
+
+GWLGenerator::Options GWLGenerator::optionsFromJson(const QJsonObject &exp)
+{
+    Options o;
+    o.channelBatching = exp.value("_channel_batching").toBool();
+    o.mcaHead         = mcaHeadFromName(exp.value("_mca_head").toString());
+    o.optimiseTravel  = exp.value("_optimise_travel").toBool();
+    return o;
+}
+
 QMap<QString, GWLGenerator::CompoundSrc>
 GWLGenerator::buildCompoundIndex(const QJsonArray &compounds) const
 {
@@ -1331,37 +1705,12 @@ bool GWLGenerator::loadVolumePlan(const QString &testId,
                                   VolumePlanEntry *out,
                                   QString *err) const
 {
-    QFile f(":/data/resources/data/volumeMap.json");
-    if (!f.open(QIODevice::ReadOnly)) {
-        if (err) *err = "Cannot open volumeMap.json";
-        return false;
-    }
-    const auto doc  = QJsonDocument::fromJson(f.readAll());
-    const auto root = doc.object();
-    const auto test = root.value(testId).toObject();
-    if (test.isEmpty()) { if (err) *err = "Test id not in volumeMap"; return false; }
-
-    QString bestKey;
-    double bestDiff = 1e300;
-    for (const auto &k : test.keys()) {
-        bool ok=false; const double v = k.toDouble(&ok);
-        if (!ok) continue;
-        const double d = std::fabs(v - stockConc);
-        if (d < bestDiff) { bestDiff = d; bestKey = k; }
-    }
-    const auto arr = test.value(bestKey).toArray();
-    if (arr.isEmpty()) { if (err) *err = "Empty volumeMap entry"; return false; }
-
-    const auto o = arr.first().toObject();
-    VolumePlanEntry vp;
-    vp.volMother  = o.value("VolMother").toDouble();
-    vp.dmso       = o.value("DMSO").toDouble();
-    vp.volDght    = o.value("volDght").toDouble();
-    vp.volFinal   = o.value("volFinal").toDouble();
-    vp.finalConc  = o.value("FinalConc").toDouble();
-    vp.concMother = o.value("ConcMother").toDouble();
-    if (out) *out = vp;
-    return true;
+    return registry()->volumePlan(testId, stockConc, out, err);
+}
+
+std::shared_ptr<const GWLRegistry> GWLGenerator::registry() const
+{
+    return registry_ ? registry_ : GWLRegistry::shared();
 }
 
 int GWLGenerator::tubePosFromWell(const QString &well)
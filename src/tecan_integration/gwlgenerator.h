@@ -8,6 +8,8 @@
 #include <QVector>
 #include <QMap>
 
+class GWLRegistry;
+
 class GWLGenerator
 {
 public:
@@ -52,6 +54,30 @@ public:
         QString solutionId;
     };
 
+    /** Multi-channel arm head used for stamping, if any. */
+    enum class McaHead {
+        None,
+        MCA96,
+        MCA384
+    };
+
+    /** Optional worklist optimisations; the defaults reproduce the classic
+        one-tip-at-a-time output. */
+    struct Options {
+        bool channelBatching = false;   // group transfers into 8-channel LiHa batches
+        McaHead mcaHead = McaHead::None; // stamp whole-plate / whole-column steps with the MCA
+        bool optimiseTravel = false;    // order independent transfers by arm travel
+    };
+
+    static QString mcaHeadName(McaHead head);
+    static McaHead mcaHeadFromName(const QString &name);
+    static QString instrumentName(Instrument instrument);
+    static Instrument instrumentFromName(const QString &name);   // EVO150 if unknown
+
+    /** Options carried in the experiment JSON (`_channel_batching`,
+        `_mca_head`, `_optimise_travel`). */
+    static Options optionsFromJson(const QJsonObject &experimentJson);
+
     GWLGenerator();
     GWLGenerator(double dilutionFactor,
                  const QString &testId,
@@ -59,6 +85,15 @@ public:
                  Instrument instrument = Instrument::EVO150);
     ~GWLGenerator();
 
+    /** Generator set up from an experiment JSON: dilution factor and test ID
+        from the first test request, stock concentration (µM) from the first
+        compound, instrument from `_instrument` (FLUENT1080 when absent, or
+        `instrument` when given)
+        and the JSON options. Shared by TecanWindow and the command-line tool. */
+    static std::unique_ptr<GWLGenerator> forExperiment(const QJsonObject &experimentJson);
+    static std::unique_ptr<GWLGenerator> forExperiment(const QJsonObject &experimentJson,
+                                                       Instrument instrument);
+
     bool generate(const QJsonObject &experimentJson,
                   QVector<FileOut> &outputs,
                   QString *errorMsg = nullptr) const;
@@ -67,10 +102,26 @@ public:
                            QVector<FileOut> &outputs,
                            QString *errorMsg = nullptr) const;
 
+    void setOptions(const Options &options) { options_ = options; }
+    const Options &options() const { return options_; }
+
     static bool saveMany(const QString &rootDir,
                          const QVector<FileOut> &outputs,
                          QString *errorMsg = nullptr);
 
+    /** Worklist records shared with other writers (PlateReformatter): one
+        LiHa aspirate + dispense + wash, and the same as an MCA stamp with
+        the tip type / tip mask fields (whole head or its first column).
+        Volumes are rounded up to 0.1 µL. */
+    static void appendTransfer(QStringList &out,
+                               const QString &srcLabel, int srcPos,
+                               const QString &dstLabel, int dstPos,
+                               double volUL, const QString &liqClass);
+    static void appendMcaTransfer(QStringList &out, McaHead head, bool wholeHead,
+                                  const QString &srcLabel, int srcPos,
+                                  const QString &dstLabel, int dstPos,
+                                  double volUL, const QString &liqClass);
+
     // Helper methods
     bool loadVolumePlan(const QString &testId,
                         double stockConc,
@@ -80,6 +131,15 @@ public:
     bool loadStandardsMatrix(QVector<StandardSource>& standards,
                              QString* err = nullptr) const;
 
+    static bool parseStandardsMatrix(const QByteArray &json,
+                                     QVector<StandardSource>& standards,
+                                     QString* err = nullptr);
+
+    /** Read-only volume map / standards shared between generators; defaults
+        to GWLRegistry::shared(). */
+    void setRegistry(std::shared_ptr<const GWLRegistry> registry) { registry_ = std::move(registry); }
+    std::shared_ptr<const GWLRegistry> registry() const;
+
     StandardSource selectBestStandard(const QString& standardName,
                                       double targetConc,
                                       const QVector<StandardSource>& available) const;
@@ -136,6 +196,8 @@ private:
     QString testId_;
     double stockConc_ = 0.0;
     Instrument instrument_ = Instrument::EVO150;
+    Options options_;
+    std::shared_ptr<const GWLRegistry> registry_;
     std::unique_ptr<Backend> backend_;
 };
 
@@ -0,0 +1,77 @@
+#include "gwljob.h"
+#include "daughterlayout.h"
+
+#include <QDebug>
+
+#include <algorithm>
+
+bool GwlJob::run(const QJsonObject &experimentJson, Result &result, QString *errorMsg)
+{
+    const auto generator = GWLGenerator::forExperiment(experimentJson);
+    return run(*generator, experimentJson, result, errorMsg);
+}
+
+bool GwlJob::run(const GWLGenerator &generator,
+                 const QJsonObject &experimentJson,
+                 Result &result,
+                 QString *errorMsg)
+{
+    result = Result();
+    QString err;
+
+    // 0) Headless input may only list compounds: lay the daughter plates out
+    //    the same way the editor does
+    QJsonObject exp = experimentJson;
+    if (exp.value("daughter_plates").toArray().isEmpty()) {
+        QJsonArray plates;
+        if (!DaughterLayoutEngine::layoutExperiment(exp, plates, &err)) {
+            if (errorMsg) *errorMsg = err;
+            return false;
+        }
+        exp.insert("daughter_plates", plates);
+    }
+
+    // 1) Worklists (per-daughter / per-matrix)
+    if (!generator.generate(exp, result.outs, &err)) {
+        if (errorMsg) *errorMsg = err;
+        return false;
+    }
+    const bool anyWorklist = std::any_of(result.outs.cbegin(), result.outs.cend(),
+        [](const GWLGenerator::FileOut &fo) {
+            return fo.relativePath.endsWith(QLatin1String(".gwl"), Qt::CaseInsensitive);
+        });
+    if (!anyWorklist) {
+        if (errorMsg) *errorMsg = QStringLiteral("No worklist was generated.");
+        return false;
+    }
+
+    // 2) Auxiliary files (plate maps, etc.) — non-fatal
+    if (!generator.generateAuxiliary(exp, result.outs, &err))
+        qWarning() << "[WARN] generator.generateAuxiliary:" << err;
+
+    // 3) Dry-run against the deck
+    result.validation = WorklistSimulator::fromExperiment(exp).run(result.outs);
+    {
+        GWLGenerator::FileOut fo;
+        fo.relativePath = QStringLiteral("Audit/WorklistValidation.csv");
+        fo.lines        = result.validation.toCsv();
+        fo.isAux        = true;
+        result.outs.push_back(std::move(fo));
+    }
+
+    // 4) Run-time estimate, with the daughter plates in their real format
+    //    (as the generator's travel ordering uses them)
+    DeckLayout deck = DeckLayout::fluentDefault();
+    const auto fmt = DaughterLayoutEngine::formatOfPlate(
+        exp.value("daughter_plates").toArray().first().toObject());
+    deck.setFamilyFormat(QStringLiteral("Daughter"), fmt.rows, fmt.columns);
+    result.runTime = RunTimeEstimator(deck).estimate(result.outs);
+    {
+        GWLGenerator::FileOut fo;
+        fo.relativePath = QStringLiteral("Audit/RunTimeEstimate.csv");
+        fo.lines        = result.runTime.toCsv();
+        fo.isAux        = true;
+        result.outs.push_back(std::move(fo));
+    }
+    return true;
+}
@@ -0,0 +1,41 @@
+#ifndef GWLJOB_H
+#define GWLJOB_H
+
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+
+#include "gwlgenerator.h"
+#include "runtimeestimator.h"
+#include "worklistsimulator.h"
+
+/**
+ * Everything that turns one experiment JSON into the files written to the
+ * robot folder: worklists, auxiliary files, the simulator report and the
+ * run-time estimate. No widgets and no database, so the GUI, the command
+ * line tool and the batch runners produce identical output.
+ *
+ * An experiment without daughter_plates is laid out with
+ * DaughterLayoutEngine first. A run that produces no .gwl file fails.
+ */
+class GwlJob
+{
+public:
+    struct Result {
+        QVector<GWLGenerator::FileOut> outs;
+        WorklistSimulator::Report      validation;
+        RunTimeEstimator::Estimate     runTime;
+    };
+
+    /** Generate with the generator configured from the JSON itself. */
+    static bool run(const QJsonObject &experimentJson,
+                    Result &result,
+                    QString *errorMsg = nullptr);
+
+    static bool run(const GWLGenerator &generator,
+                    const QJsonObject &experimentJson,
+                    Result &result,
+                    QString *errorMsg = nullptr);
+};
+
+#endif // GWLJOB_H
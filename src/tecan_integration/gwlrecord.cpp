@@ -0,0 +1,50 @@
+#include "gwlrecord.h"
+
+bool GwlRecord::parse(QStringView line, GwlRecord &rec)
+{
+    rec = GwlRecord();
+    line = line.trimmed();
+    if (line.size() < 2 || line.at(1) != u';') return false;
+
+    switch (line.at(0).unicode()) {
+    case 'A': rec.kind = Aspirate; break;
+    case 'D': rec.kind = Dispense; break;
+    case 'W': rec.kind = Wash;     return true;
+    case 'B': rec.kind = Break;    return true;
+    case 'S': rec.kind = TipType;  rec.tipType = line.mid(2).toInt(); return true;
+    case 'C': rec.kind = Comment;  rec.label = line.mid(2).toString(); return true;
+    default:  return false;
+    }
+
+    // A/D fields: 1 label, 4 position, 6 volume, 8 tip type, 9 tip mask
+    int field = 1;
+    qsizetype start = 2;
+    while (start <= line.size()) {
+        qsizetype end = line.indexOf(u';', start);
+        if (end < 0) end = line.size();
+        const QStringView f = line.mid(start, end - start);
+
+        switch (field) {
+        case 1: rec.label    = f.toString(); break;
+        case 4: rec.position = f.toInt();    break;
+        case 6: rec.volumeUL = f.toDouble(); break;
+        case 8:
+            if (f.startsWith(u"MCA")) rec.mcaHead = f.mid(3).toInt();
+            break;
+        case 9: rec.tipMask  = f.toInt();    break;
+        default: break;
+        }
+
+        if (field >= 9) break;
+        ++field;
+        start = end + 1;
+    }
+    return !rec.label.isEmpty() && rec.position > 0;
+}
+
+int GwlRecord::mcaColumns() const
+{
+    int n = 0;
+    for (int m = tipMask; m; m >>= 1) n += m & 1;
+    return qMax(1, n);
+}
@@ -0,0 +1,47 @@
+#ifndef GWLRECORD_H
+#define GWLRECORD_H
+
+#include <QString>
+#include <QStringView>
+
+/**
+ * One parsed worklist line, as written by GWLGenerator:
+ *
+ *   A;RackLabel;RackID;RackType;Position;TubeID;Volume;LiquidClass;TipType;TipMask
+ *   D;…same fields…
+ *   W;  B;  S;<tip type>  C;<comment>
+ *
+ * MCA records name the head in TipType ("MCA96", "MCA384") and the head
+ * columns they use in TipMask; LiHa records leave TipType empty.
+ *
+ * Parsing walks the line once and only allocates for the rack label.
+ */
+struct GwlRecord
+{
+    enum Kind {
+        Invalid,
+        Aspirate,
+        Dispense,
+        Wash,
+        Break,
+        TipType,
+        Comment
+    };
+
+    Kind    kind     = Invalid;
+    QString label;            // rack label (A/D) or comment text (C)
+    int     position = 0;     // 1-based well / tube position
+    double  volumeUL = 0.0;
+    int     tipMask  = 0;     // 0 = not given (tip 1); MCA: head columns
+    int     mcaHead  = 0;     // 96 / 384 for MCA records, 0 = LiHa
+    int     tipType  = 0;     // S;<n>
+
+    static bool parse(QStringView line, GwlRecord &rec);
+
+    bool isMca() const { return mcaHead > 0; }
+    int  mcaRows() const { return mcaHead == 384 ? 16 : 8; }
+    /** Head columns used, from the tip mask (at least one). */
+    int  mcaColumns() const;
+};
+
+#endif // GWLRECORD_H
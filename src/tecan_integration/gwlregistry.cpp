@@ -0,0 +1,94 @@
+#include "gwlregistry.h"
+
+#include <cmath>
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+std::shared_ptr<const GWLRegistry> GWLRegistry::shared()
+{
+    static const std::shared_ptr<const GWLRegistry> reg =
+        fromFiles(QStringLiteral(":/data/resources/data/volumeMap.json"),
+                  QStringLiteral(":/data/resources/data/standards_matrix.json"));
+    return reg;
+}
+
+std::shared_ptr<const GWLRegistry> GWLRegistry::fromFiles(const QString &volumeMapPath,
+                                                          const QString &standardsPath)
+{
+    std::shared_ptr<GWLRegistry> reg(new GWLRegistry);
+
+    // volumeMap.json : { testId: { "<stock>": [ {VolMother, DMSO, …}, … ], … }, … }
+    QFile vf(volumeMapPath);
+    if (!vf.open(QIODevice::ReadOnly)) {
+        reg->volumeMapError_ = "Cannot open volumeMap.json";
+    } else {
+        const QJsonObject root = QJsonDocument::fromJson(vf.readAll()).object();
+        for (auto tit = root.constBegin(); tit != root.constEnd(); ++tit) {
+            const QJsonObject test = tit.value().toObject();
+            if (test.isEmpty()) continue;
+
+            QVector<StockRow> &rows = reg->volumeMap_[tit.key()];
+            for (auto sit = test.constBegin(); sit != test.constEnd(); ++sit) {
+                bool ok = false;
+                const double stock = sit.key().toDouble(&ok);
+                if (!ok) continue;
+
+                StockRow row;
+                row.stock = stock;
+                const QJsonArray arr = sit.value().toArray();
+                if (!arr.isEmpty()) {
+                    const QJsonObject o = arr.first().toObject();
+                    row.hasPlan         = true;
+                    row.plan.volMother  = o.value("VolMother").toDouble();
+                    row.plan.dmso       = o.value("DMSO").toDouble();
+                    row.plan.volDght    = o.value("volDght").toDouble();
+                    row.plan.volFinal   = o.value("volFinal").toDouble();
+                    row.plan.finalConc  = o.value("FinalConc").toDouble();
+                    row.plan.concMother = o.value("ConcMother").toDouble();
+                }
+                rows.push_back(row);
+            }
+        }
+    }
+
+    QFile sf(standardsPath);
+    if (!sf.open(QIODevice::ReadOnly))
+        reg->standardsError_ = "Cannot open standards_matrix.json";
+    else
+        GWLGenerator::parseStandardsMatrix(sf.readAll(), reg->standards_, &reg->standardsError_);
+
+    return reg;
+}
+
+bool GWLRegistry::volumePlan(const QString &testId,
+                             double stockConc,
+                             GWLGenerator::VolumePlanEntry *out,
+                             QString *err) const
+{
+    if (!volumeMapError_.isEmpty()) { if (err) *err = volumeMapError_; return false; }
+
+    auto it = volumeMap_.constFind(testId);
+    if (it == volumeMap_.cend()) { if (err) *err = "Test id not in volumeMap"; return false; }
+
+    // closest stock; first one wins on ties (same as the key order of the file)
+    const StockRow *best = nullptr;
+    double bestDiff = 1e300;
+    for (const StockRow &row : it.value()) {
+        const double d = std::fabs(row.stock - stockConc);
+        if (d < bestDiff) { bestDiff = d; best = &row; }
+    }
+    if (!best || !best->hasPlan) { if (err) *err = "Empty volumeMap entry"; return false; }
+
+    if (out) *out = best->plan;
+    return true;
+}
+
+bool GWLRegistry::standards(QVector<GWLGenerator::StandardSource> &out, QString *err) const
+{
+    if (!standardsError_.isEmpty()) { if (err) *err = standardsError_; return false; }
+    out += standards_;
+    return true;
+}
@@ -0,0 +1,53 @@
+#ifndef GWLREGISTRY_H
+#define GWLREGISTRY_H
+
+#include <memory>
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include "gwlgenerator.h"
+
+/**
+ * Parsed, read-only copies of volumeMap.json and standards_matrix.json.
+ *
+ * Built once and shared by every GWLGenerator (and every worker thread of
+ * a batch run); nothing is mutated after construction, so lookups need no
+ * locking.
+ */
+class GWLRegistry
+{
+public:
+    /** Registry over the bundled resources, loaded on first use. */
+    static std::shared_ptr<const GWLRegistry> shared();
+
+    static std::shared_ptr<const GWLRegistry> fromFiles(const QString &volumeMapPath,
+                                                        const QString &standardsPath);
+
+    /** Volume plan of the stock closest to stockConc for testId. */
+    bool volumePlan(const QString &testId,
+                    double stockConc,
+                    GWLGenerator::VolumePlanEntry *out,
+                    QString *err = nullptr) const;
+
+    /** Appends the standards (concentrations in µM, ppm entries dropped). */
+    bool standards(QVector<GWLGenerator::StandardSource> &out,
+                   QString *err = nullptr) const;
+
+private:
+    GWLRegistry() = default;
+
+    struct StockRow {
+        double stock   = 0.0;
+        bool   hasPlan = false;
+        GWLGenerator::VolumePlanEntry plan;
+    };
+
+    QHash<QString, QVector<StockRow>>     volumeMap_;   // test id -> stocks (key order)
+    QString                               volumeMapError_;
+    QVector<GWLGenerator::StandardSource> standards_;
+    QString                               standardsError_;
+};
+
+#endif // GWLREGISTRY_H
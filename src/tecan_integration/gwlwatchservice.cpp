@@ -0,0 +1,272 @@
+#include "gwlwatchservice.h"
+#include "gwljob.h"
+#include "gwlregistry.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QThread>
+
+GwlWatchService::GwlWatchService(const Config &config, QObject *parent)
+    : QObject(parent)
+    , cfg_(config)
+{
+    if (cfg_.outbox.isEmpty())
+        cfg_.outbox = QDir(cfg_.inbox).absoluteFilePath(QStringLiteral("../outbox"));
+    cfg_.inbox  = QDir::cleanPath(QDir(cfg_.inbox).absolutePath());
+    cfg_.outbox = QDir::cleanPath(cfg_.outbox);
+
+    pool_.setMaxThreadCount(cfg_.maxThreads > 0 ? cfg_.maxThreads : QThread::idealThreadCount());
+
+    debounce_.setSingleShot(true);
+    debounce_.setInterval(qMax(0, cfg_.debounceMs));
+    connect(&debounce_, &QTimer::timeout, this, &GwlWatchService::scanInbox);
+    connect(&watcher_, &QFileSystemWatcher::directoryChanged,
+            this, &GwlWatchService::onInboxChanged);
+
+    statusTimer_.setInterval(10000);
+    connect(&statusTimer_, &QTimer::timeout, this, [this]{ writeStatus(); });
+}
+
+GwlWatchService::~GwlWatchService()
+{
+    stop();
+}
+
+QString GwlWatchService::inboxSub(const QString &sub) const
+{
+    return QDir(cfg_.inbox).filePath(sub);
+}
+
+QString GwlWatchService::outboxSub(const QString &sub) const
+{
+    return QDir(cfg_.outbox).filePath(sub);
+}
+
+bool GwlWatchService::start(QString *errorMsg)
+{
+    for (const QString &dir : { cfg_.inbox, inboxSub("processing"), inboxSub("done"),
+                                inboxSub("failed"), cfg_.outbox,
+                                outboxSub("worklists"), outboxSub("errors") }) {
+        if (!QDir().mkpath(dir)) {
+            if (errorMsg) *errorMsg = QString("Cannot create %1").arg(dir);
+            return false;
+        }
+    }
+    if (!watcher_.addPath(cfg_.inbox)) {
+        if (errorMsg) *errorMsg = QString("Cannot watch %1").arg(cfg_.inbox);
+        return false;
+    }
+
+    GWLRegistry::shared();           // parse the resources once, up front
+    stopping_ = false;
+
+    // Files left in processing/ by an interrupted run are queued again
+    const QDir proc(inboxSub("processing"));
+    for (const QString &name : proc.entryList({ "*.json" }, QDir::Files, QDir::Name))
+        pending_ << name;
+
+    startedAt_ = QDateTime::currentDateTimeUtc();
+    uptime_.start();
+    statusTimer_.start();
+    qInfo() << "[WATCH] inbox" << cfg_.inbox << "outbox" << cfg_.outbox;
+
+    dispatch();
+    scanInbox();                     // pick up what is already there
+    return true;
+}
+
+void GwlWatchService::stop()
+{
+    if (stopping_) return;
+    stopping_ = true;
+
+    // no new intake; queued names stay in processing/ and are picked up
+    // again by the next start()
+    if (!watcher_.directories().isEmpty())
+        watcher_.removePaths(watcher_.directories());
+    debounce_.stop();
+    statusTimer_.stop();
+    pending_.clear();
+
+    pool_.waitForDone();
+
+    // deliver the queued finish() calls so inputs land in done/ or failed/
+    QCoreApplication::sendPostedEvents(this, QEvent::MetaCall);
+    if (uptime_.isValid()) writeStatus();
+}
+
+void GwlWatchService::onInboxChanged()
+{
+    debounce_.start();               // coalesce bursts of notifications
+}
+
+void GwlWatchService::scanInbox()
+{
+    if (stopping_) return;
+
+    const QDir in(cfg_.inbox);
+    const QFileInfoList files = in.entryInfoList({ "*.json" }, QDir::Files, QDir::Time | QDir::Reversed);
+
+    bool unsettled = false;
+    QSet<QString> present;
+    for (const QFileInfo &fi : files) {
+        const QString name = fi.fileName();
+        present.insert(name);
+
+        // ready once two consecutive scans see the same size and mtime
+        Seen &s = seen_[name];
+        if (s.size != fi.size() || s.modified != fi.lastModified()) {
+            s.size     = fi.size();
+            s.modified = fi.lastModified();
+            unsettled  = true;
+            continue;
+        }
+        if (running_.contains(name) || pending_.contains(name)) {
+            unsettled = true;        // newer copy waits for the current run
+            continue;
+        }
+
+        const QString target = QDir(inboxSub("processing")).filePath(name);
+        QFile::remove(target);
+        if (!QFile::rename(fi.absoluteFilePath(), target)) {
+            unsettled = true;        // still locked by the writer
+            continue;
+        }
+        seen_.remove(name);
+        pending_ << name;
+    }
+
+    // forget files that vanished before settling
+    for (auto it = seen_.begin(); it != seen_.end();) {
+        if (!present.contains(it.key())) it = seen_.erase(it);
+        else ++it;
+    }
+
+    if (unsettled) debounce_.start();
+    dispatch();
+    writeStatus();
+}
+
+void GwlWatchService::dispatch()
+{
+    while (!stopping_ && !pending_.isEmpty() && running_.size() < pool_.maxThreadCount()) {
+        const QString name = pending_.takeFirst();
+        running_.insert(name);
+
+        const QString input  = QDir(inboxSub("processing")).filePath(name);
+        const QString outDir = QDir(outboxSub("worklists")).filePath(QFileInfo(name).completeBaseName());
+        const QJsonObject overrides = cfg_.overrides;
+        const bool strict = cfg_.strict;
+
+        pool_.start([this, name, input, outDir, overrides, strict]() {
+            QElapsedTimer t;
+            t.start();
+
+            QString err;
+            bool ok = false;
+
+            QFile f(input);
+            if (!f.open(QIODevice::ReadOnly)) {
+                err = QString("Cannot open %1").arg(input);
+            } else {
+                QJsonParseError pe{};
+                const QJsonDocument doc = QJsonDocument::fromJson(f.readAll(), &pe);
+                f.close();
+                if (pe.error != QJsonParseError::NoError || !doc.isObject()) {
+                    err = QString("Invalid JSON: %1").arg(pe.errorString());
+                } else {
+                    QJsonObject exp = doc.object();
+                    for (auto o = overrides.constBegin(); o != overrides.constEnd(); ++o)
+                        exp.insert(o.key(), o.value());
+
+                    GwlJob::Result job;
+                    if (!GwlJob::run(exp, job, &err)) {
+                        // err set by the generator
+                    } else if (strict && !job.validation.ok()) {
+                        err = job.validation.summary(50);
+                    } else {
+                        // drop what a previous run of this input left behind
+                        QDir old(outDir);
+                        if (old.exists() && !old.removeRecursively())
+                            err = QString("Cannot clear %1").arg(outDir);
+                        else if (GWLGenerator::saveMany(outDir, job.outs, &err))
+                            ok = true;
+                    }
+                }
+            }
+
+            const qint64 ms = t.elapsed();
+            QMetaObject::invokeMethod(this, [this, name, ok, err, ms]{
+                finish(name, ok, err, ms);
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void GwlWatchService::finish(const QString &name, bool ok, const QString &error, qint64 elapsedMs)
+{
+    running_.remove(name);
+    busyMs_  += elapsedMs;
+    lastName_ = name;
+
+    const QString from = QDir(inboxSub("processing")).filePath(name);
+    const QString to   = QDir(inboxSub(ok ? "done" : "failed")).filePath(name);
+    QFile::remove(to);
+    QFile::rename(from, to);
+
+    if (ok) {
+        ++processed_;
+        qInfo() << "[WATCH] generated" << name << "in" << elapsedMs << "ms";
+    } else {
+        ++failed_;
+        lastError_ = error;
+        qWarning() << "[WATCH] failed" << name << ":" << error;
+
+        QFile ef(QDir(outboxSub("errors")).filePath(QFileInfo(name).completeBaseName() + ".txt"));
+        if (ef.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            QTextStream ts(&ef);
+            ts << QDateTime::currentDateTimeUtc().toString(Qt::ISODate) << "\n"
+               << name << "\n\n" << error << "\n";
+        }
+    }
+
+    emit fileFinished(name, ok, error);
+    if (stopping_) return;           // stop() writes the final status
+    dispatch();
+    writeStatus();
+}
+
+void GwlWatchService::writeStatus() const
+{
+    const double minutes = uptime_.isValid() ? uptime_.elapsed() / 60000.0 : 0.0;
+    const int    done    = processed_ + failed_;
+
+    QJsonObject st;
+    st["inbox"]            = cfg_.inbox;
+    st["outbox"]           = cfg_.outbox;
+    st["started"]          = startedAt_.toString(Qt::ISODate);
+    st["updated"]          = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    st["queue_depth"]      = queueDepth();
+    st["pending"]          = pending_.size();
+    st["running"]          = running_.size();
+    st["workers"]          = pool_.maxThreadCount();
+    st["processed"]        = processed_;
+    st["failed"]           = failed_;
+    st["per_minute"]       = minutes > 0.0 ? done / minutes : 0.0;
+    st["avg_generate_ms"]  = done > 0 ? double(busyMs_) / done : 0.0;
+    st["last_file"]        = lastName_;
+    st["last_error"]       = lastError_;
+
+    // atomic replace so readers never see a half-written file
+    QSaveFile f(QDir(cfg_.outbox).filePath("status.json"));
+    if (f.open(QIODevice::WriteOnly)) {
+        f.write(QJsonDocument(st).toJson(QJsonDocument::Indented));
+        f.commit();
+    }
+}
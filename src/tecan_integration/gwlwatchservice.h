@@ -0,0 +1,93 @@
+#ifndef GWLWATCHSERVICE_H
+#define GWLWATCHSERVICE_H
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QJsonObject>
+#include <QObject>
+#include <QSet>
+#include <QThreadPool>
+#include <QTimer>
+
+/**
+ * Watch-folder service: experiment JSON files dropped into the inbox are
+ * turned into worklists without the GUI.
+ *
+ *   inbox/<name>.json          picked up once its size/mtime is stable
+ *   inbox/processing/          while a worker generates it
+ *   inbox/done/, inbox/failed/ input after the run
+ *   outbox/worklists/<name>/   generated files (same layout as the GUI),
+ *                              replaced on every run of <name>
+ *   outbox/errors/<name>.txt   why a file failed
+ *   outbox/status.json         throughput and queue depth
+ *
+ * Directory notifications are debounced; a file rewritten several times
+ * inside the debounce window is generated once.
+ *
+ * stop() stops taking new files, waits for the running jobs and files
+ * their inputs; queued inputs stay in processing/ for the next start().
+ */
+class GwlWatchService : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Config {
+        QString     inbox;
+        QString     outbox;                 // default: <inbox>/../outbox
+        int         debounceMs   = 1500;
+        int         maxThreads   = 0;       // 0 = ideal thread count
+        bool        strict       = false;   // validation issues fail the file
+        QJsonObject overrides;              // `_instrument`, options…
+    };
+
+    explicit GwlWatchService(const Config &config, QObject *parent = nullptr);
+    ~GwlWatchService() override;
+
+    bool start(QString *errorMsg = nullptr);
+    void stop();
+
+    int queueDepth() const { return pending_.size() + running_.size(); }
+
+signals:
+    void fileFinished(const QString &name, bool ok, const QString &error);
+
+private slots:
+    void onInboxChanged();
+    void scanInbox();
+
+private:
+    struct Seen {
+        qint64    size = -1;
+        QDateTime modified;
+    };
+
+    void dispatch();
+    void finish(const QString &name, bool ok, const QString &error, qint64 elapsedMs);
+    void writeStatus() const;
+    QString inboxSub(const QString &sub) const;
+    QString outboxSub(const QString &sub) const;
+
+    Config             cfg_;
+    QFileSystemWatcher watcher_;
+    QTimer             debounce_;
+    QTimer             statusTimer_;
+    QThreadPool        pool_;
+
+    QHash<QString, Seen> seen_;      // inbox file -> last observed size/mtime
+    QStringList          pending_;   // names ready to generate (in processing/)
+    QSet<QString>        running_;
+    bool                 stopping_ = false;
+
+    QDateTime     startedAt_;
+    QElapsedTimer uptime_;
+    int           processed_  = 0;
+    int           failed_     = 0;
+    qint64        busyMs_     = 0;
+    QString       lastName_;
+    QString       lastError_;
+};
+
+#endif // GWLWATCHSERVICE_H
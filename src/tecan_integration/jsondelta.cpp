@@ -0,0 +1,203 @@
+#include "jsondelta.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace {
+
+QJsonObject setOp(const QJsonArray &path, const QJsonValue &v)
+{
+    return QJsonObject{ { "op", "set" }, { "p", path }, { "v", v } };
+}
+
+QJsonObject delOp(const QJsonArray &path)
+{
+    return QJsonObject{ { "op", "del" }, { "p", path } };
+}
+
+QJsonArray child(const QJsonArray &path, const QString &key)
+{
+    QJsonArray p = path;
+    p.append(key);
+    return p;
+}
+
+void diffInto(const QJsonValue &a, const QJsonValue &b, const QJsonArray &path, QJsonArray &ops)
+{
+    if (a == b) return;
+
+    if (a.isObject() && b.isObject()) {
+        const QJsonObject oa = a.toObject(), ob = b.toObject();
+        for (auto it = oa.constBegin(); it != oa.constEnd(); ++it)
+            if (!ob.contains(it.key())) ops.append(delOp(child(path, it.key())));
+        for (auto it = ob.constBegin(); it != ob.constEnd(); ++it) {
+            const auto old = oa.constFind(it.key());
+            if (old == oa.constEnd()) ops.append(setOp(child(path, it.key()), it.value()));
+            else                      diffInto(old.value(), it.value(), child(path, it.key()), ops);
+        }
+        return;
+    }
+
+    if (a.isArray() && b.isArray()) {
+        const QJsonArray aa = a.toArray(), ab = b.toArray();
+        const int common = qMin(aa.size(), ab.size());
+
+        QJsonArray sub;
+        for (int i = aa.size() - 1; i >= ab.size(); --i)            // shrink from the end
+            sub.append(delOp(child(path, QString::number(i))));
+        for (int i = 0; i < common; ++i)
+            diffInto(aa.at(i), ab.at(i), child(path, QString::number(i)), sub);
+        for (int i = common; i < ab.size(); ++i)                    // then grow
+            sub.append(setOp(child(path, QString::number(i)), ab.at(i)));
+
+        // an insertion near the front shifts every element; one replacement is smaller
+        if (sub.size() > 1 && sub.size() >= ab.size()) {
+            ops.append(setOp(path, b));
+            return;
+        }
+        for (const QJsonValue &op : std::as_const(sub)) ops.append(op);
+        return;
+    }
+
+    ops.append(setOp(path, b));
+}
+
+// same semantics as jsonb_set(…, create_missing => true): only the last path
+// element is created, an index past the end appends
+QJsonValue setAt(const QJsonValue &node, const QJsonArray &p, int i, const QJsonValue &v)
+{
+    if (i == p.size()) return v;
+    const QString key  = p.at(i).toString();
+    const bool    last = i + 1 == p.size();
+
+    if (node.isArray()) {
+        QJsonArray arr = node.toArray();
+        bool ok = false;
+        const int idx = key.toInt(&ok);
+        if (!ok || idx < 0) return node;
+        if (idx >= arr.size()) {
+            if (last) arr.append(v);
+            return arr;
+        }
+        arr[idx] = setAt(arr.at(idx), p, i + 1, v);
+        return arr;
+    }
+    if (!node.isObject()) return node;
+
+    QJsonObject obj = node.toObject();
+    if (!last && !obj.contains(key)) return node;
+    obj.insert(key, setAt(obj.value(key), p, i + 1, v));
+    return obj;
+}
+
+// same semantics as jsonb #- path
+QJsonValue deleteAt(const QJsonValue &node, const QJsonArray &p, int i)
+{
+    if (i >= p.size()) return node;
+    const QString key  = p.at(i).toString();
+    const bool    last = i + 1 == p.size();
+
+    if (node.isArray()) {
+        QJsonArray arr = node.toArray();
+        bool ok = false;
+        const int idx = key.toInt(&ok);
+        if (!ok || idx < 0 || idx >= arr.size()) return node;
+        if (last) arr.removeAt(idx);
+        else      arr[idx] = deleteAt(arr.at(idx), p, i + 1);
+        return arr;
+    }
+    if (!node.isObject()) return node;
+
+    QJsonObject obj = node.toObject();
+    if (!obj.contains(key)) return node;
+    if (last) obj.remove(key);
+    else      obj.insert(key, deleteAt(obj.value(key), p, i + 1));
+    return obj;
+}
+
+QJsonValue valueAt(const QJsonValue &doc, const QJsonArray &p)
+{
+    QJsonValue cur = doc;
+    for (const QJsonValue &k : p) {
+        if (cur.isArray()) {
+            bool ok = false;
+            const int idx = k.toString().toInt(&ok);
+            const QJsonArray arr = cur.toArray();
+            if (!ok || idx < 0 || idx >= arr.size()) return QJsonValue(QJsonValue::Undefined);
+            cur = arr.at(idx);
+        } else if (cur.isObject()) {
+            cur = cur.toObject().value(k.toString());
+        } else {
+            return QJsonValue(QJsonValue::Undefined);
+        }
+    }
+    return cur;
+}
+
+QString preview(const QJsonValue &v, int maxChars)
+{
+    QString s;
+    if (v.isObject())      s = QString::fromUtf8(QJsonDocument(v.toObject()).toJson(QJsonDocument::Compact));
+    else if (v.isArray())  s = QString::fromUtf8(QJsonDocument(v.toArray()).toJson(QJsonDocument::Compact));
+    else if (v.isString()) s = '"' + v.toString() + '"';
+    else if (v.isDouble()) s = QString::number(v.toDouble(), 'g', 16);
+    else if (v.isBool())   s = v.toBool() ? "true" : "false";
+    else                   s = "null";
+    if (maxChars > 1 && s.size() > maxChars) s = s.left(maxChars - 1) + QChar(0x2026);
+    return s;
+}
+
+QString pathText(const QJsonArray &p)
+{
+    QStringList parts;
+    for (const QJsonValue &k : p) parts << k.toString();
+    return parts.isEmpty() ? QStringLiteral("/") : parts.join('/');
+}
+
+} // namespace
+
+QJsonArray JsonDelta::diff(const QJsonValue &from, const QJsonValue &to)
+{
+    QJsonArray ops;
+    diffInto(from, to, QJsonArray(), ops);
+    return ops;
+}
+
+QJsonValue JsonDelta::apply(const QJsonValue &doc, const QJsonArray &delta)
+{
+    QJsonValue out = doc;
+    for (const QJsonValue &opv : delta) {
+        const QJsonObject op   = opv.toObject();
+        const QJsonArray  path = op.value("p").toArray();
+        if (op.value("op").toString() == QLatin1String("del"))
+            out = deleteAt(out, path, 0);
+        else
+            out = setAt(out, path, 0, op.value("v"));
+    }
+    return out;
+}
+
+QStringList JsonDelta::describe(const QJsonArray &delta, const QJsonValue &from, int maxValueChars)
+{
+    QStringList lines;
+    lines.reserve(delta.size());
+    for (const QJsonValue &opv : delta) {
+        const QJsonObject op   = opv.toObject();
+        const QJsonArray  path = op.value("p").toArray();
+        const QJsonValue  old  = from.isUndefined() ? from : valueAt(from, path);
+
+        if (op.value("op").toString() == QLatin1String("del")) {
+            lines << (old.isUndefined() ? QString("- %1").arg(pathText(path))
+                                        : QString("- %1 (was %2)").arg(pathText(path), preview(old, maxValueChars)));
+        } else if (!from.isUndefined() && old.isUndefined()) {
+            lines << QString("+ %1 = %2").arg(pathText(path), preview(op.value("v"), maxValueChars));
+        } else if (!old.isUndefined()) {
+            lines << QString("~ %1: %2 → %3").arg(pathText(path),
+                                                       preview(old, maxValueChars),
+                                                       preview(op.value("v"), maxValueChars));
+        } else {
+            lines << QString("~ %1 = %2").arg(pathText(path), preview(op.value("v"), maxValueChars));
+        }
+    }
+    return lines;
+}
@@ -0,0 +1,37 @@
+#ifndef JSONDELTA_H
+#define JSONDELTA_H
+
+#include <QJsonArray>
+#include <QJsonValue>
+#include <QString>
+#include <QStringList>
+
+/**
+ * Structural deltas between two JSON documents, as stored in
+ * experiment_versions.delta (sql/migrations/003). A delta is an array of
+ *
+ *   {"op":"set","p":["compounds","3","weight"],"v":12.5}
+ *   {"op":"del","p":["daughter_plates","7"]}
+ *
+ * applied in order. Path elements are strings; array indices are written
+ * as decimal strings so the same path feeds jsonb_set / #- on the server.
+ * Array elements are removed from the end first, and appended in order, so
+ * indices stay valid while the ops are applied.
+ */
+class JsonDelta
+{
+public:
+    /** Ops turning `from` into `to` (empty when they are identical). */
+    static QJsonArray diff(const QJsonValue &from, const QJsonValue &to);
+
+    /** `doc` with `delta` applied. */
+    static QJsonValue apply(const QJsonValue &doc, const QJsonArray &delta);
+
+    /** One human-readable line per op, e.g. "~ compounds/3/weight = 12.5".
+        With `from` given, replaced values show as "old → new". */
+    static QStringList describe(const QJsonArray &delta,
+                                const QJsonValue &from = QJsonValue(QJsonValue::Undefined),
+                                int maxValueChars = 80);
+};
+
+#endif // JSONDELTA_H
@@ -0,0 +1,160 @@
+#include "jsonhash.h"
+
+#include <QJsonArray>
+#include <QStringView>
+#include <cstring>
+
+namespace {
+
+constexpr quint64 kSeedLo = 0x9e3779b97f4a7c15ull;
+constexpr quint64 kSeedHi = 0xc2b2ae3d27d4eb4full;
+
+enum Tag : quint64 { TagNull = 1, TagBool = 2, TagText = 3, TagArray = 4, TagObject = 5,
+                     TagNumber = 6 };
+
+// splitmix64 finaliser
+inline quint64 mix(quint64 x)
+{
+    x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27; x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+inline quint64 rotl(quint64 x, int r) { return (x << r) | (x >> (64 - r)); }
+
+inline JsonHash leaf(Tag tag, quint64 payload = 0)
+{
+    return JsonHash{ mix(kSeedLo ^ tag ^ mix(payload)), mix(kSeedHi + tag + rotl(payload, 23)) };
+}
+
+// order-dependent step: h = f(h, x)
+inline void step(JsonHash &h, const JsonHash &x)
+{
+    h.lo = mix(h.lo ^ x.lo) + rotl(x.hi, 17);
+    h.hi = mix(h.hi + x.hi) ^ rotl(x.lo, 41);
+}
+
+JsonHash textHash(QStringView s)
+{
+    // 4 UTF-16 units per 64-bit word; two lanes with different mixing
+    quint64 a = kSeedLo ^ (quint64(s.size()) * 0xff51afd7ed558ccdull);
+    quint64 b = kSeedHi + quint64(s.size());
+
+    const char *p   = reinterpret_cast<const char *>(s.utf16());
+    qsizetype bytes = s.size() * qsizetype(sizeof(char16_t));
+    while (bytes >= 8) {
+        quint64 w;
+        std::memcpy(&w, p, 8);
+        a = mix(a ^ w);
+        b = rotl(b + w * 0x9fb21c651e98df25ull, 31);
+        p += 8; bytes -= 8;
+    }
+    if (bytes > 0) {
+        quint64 w = 0;
+        std::memcpy(&w, p, size_t(bytes));
+        a = mix(a ^ w ^ 0x80);
+        b = rotl(b + w * 0x9fb21c651e98df25ull, 31);
+    }
+
+    JsonHash h = leaf(TagText);
+    step(h, JsonHash{ a, mix(b) });
+    return h;
+}
+
+// `topLevel`: a direct value of the root object, where a number equals the
+// same number written as a string
+JsonHash hashValue(const QJsonValue &v, JsonHash::ArrayMode mode, bool topLevel = false);
+
+JsonHash hashArray(const QJsonArray &arr, JsonHash::ArrayMode mode)
+{
+    JsonHash h = leaf(TagArray, quint64(arr.size()));
+    if (mode == JsonHash::OrderedArrays) {
+        for (const QJsonValue &e : arr) step(h, hashValue(e, mode));
+        return h;
+    }
+
+    // multiset: sum of (re-mixed) element hashes does not depend on order
+    quint64 sumLo = 0, sumHi = 0;
+    for (const QJsonValue &e : arr) {
+        const JsonHash eh = hashValue(e, mode);
+        sumLo += mix(eh.lo ^ kSeedHi);
+        sumHi += mix(eh.hi + kSeedLo);
+    }
+    step(h, JsonHash{ sumLo, sumHi });
+    return h;
+}
+
+JsonHash hashObject(const QJsonObject &obj, JsonHash::ArrayMode mode, bool root = false)
+{
+    // keys paired with their values and summed, so key order is irrelevant
+    JsonHash h = leaf(TagObject, quint64(obj.size()));
+    quint64 sumLo = 0, sumHi = 0;
+    for (auto it = obj.constBegin(); it != obj.constEnd(); ++it) {
+        JsonHash kv = textHash(it.key());
+        step(kv, hashValue(it.value(), mode, root));
+        sumLo += mix(kv.lo ^ kSeedHi);
+        sumHi += mix(kv.hi + kSeedLo);
+    }
+    step(h, JsonHash{ sumLo, sumHi });
+    return h;
+}
+
+JsonHash hashValue(const QJsonValue &v, JsonHash::ArrayMode mode, bool topLevel)
+{
+    switch (v.type()) {
+    case QJsonValue::Object:
+        return hashObject(v.toObject(), mode);
+    case QJsonValue::Array:
+        return hashArray(v.toArray(), mode);
+    case QJsonValue::String: {
+        const QString s = v.toString();
+        if (QStringView(s).trimmed().isEmpty()) return leaf(TagNull);   // "" == null
+        return textHash(s);
+    }
+    case QJsonValue::Double: {
+        const QString n = QString::number(v.toDouble(), 'g', 16);
+        if (topLevel) return textHash(n);                               // 5 == "5"
+        JsonHash h = leaf(TagNumber);
+        step(h, textHash(n));
+        return h;
+    }
+    case QJsonValue::Bool:
+        return leaf(TagBool, v.toBool() ? 1 : 0);
+    default:                                                            // Null / Undefined
+        return leaf(TagNull);
+    }
+}
+
+} // namespace
+
+JsonHash JsonHash::of(const QJsonValue &v, ArrayMode mode)
+{
+    return v.isObject() ? hashObject(v.toObject(), mode, true) : hashValue(v, mode);
+}
+
+JsonHash JsonHash::of(const QJsonObject &o, ArrayMode mode)
+{
+    return hashObject(o, mode, true);
+}
+
+QStringList JsonHash::changedKeys(const QJsonObject &a, const QJsonObject &b, ArrayMode mode)
+{
+    QStringList keys = a.keys();
+    for (auto it = b.constBegin(); it != b.constEnd(); ++it)
+        if (!a.contains(it.key())) keys << it.key();
+
+    // a key on one side only changes the object hash even with a null value
+    QStringList changed;
+    for (const QString &k : std::as_const(keys))
+        if (a.contains(k) != b.contains(k)
+            || hashValue(a.value(k), mode, true) != hashValue(b.value(k), mode, true))
+            changed << k;
+    return changed;
+}
+
+QString JsonHash::toHex() const
+{
+    return QStringLiteral("%1%2").arg(hi, 16, 16, QLatin1Char('0'))
+                                 .arg(lo, 16, 16, QLatin1Char('0'));
+}
@@ -0,0 +1,48 @@
+#ifndef JSONHASH_H
+#define JSONHASH_H
+
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QString>
+#include <QStringList>
+#include <QtGlobal>
+
+/**
+ * 128-bit structural hash of a JSON value, computed bottom-up in one pass.
+ *
+ * Equal hashes mean "the same experiment" in the sense the UI has always
+ * used for dirty-checking:
+ *   - object key order is irrelevant (keys are hashed with their values);
+ *   - arrays are multisets by default (element order is irrelevant);
+ *   - an empty / whitespace-only string equals null;
+ *   - a top-level field holding a number equals one holding the same number
+ *     as a string ("5" == 5); deeper down they differ, as they always did.
+ *
+ * The mixing is fixed (no per-process seed), so hashes are stable across
+ * runs and can be stored.
+ */
+struct JsonHash
+{
+    quint64 lo = 0;
+    quint64 hi = 0;
+
+    enum ArrayMode {
+        UnorderedArrays,        // [a,b] == [b,a]
+        OrderedArrays
+    };
+
+    static JsonHash of(const QJsonValue &v, ArrayMode mode = UnorderedArrays);
+    static JsonHash of(const QJsonObject &o, ArrayMode mode = UnorderedArrays);
+
+    /** Top-level keys present on one side only or whose values hash
+        differently; empty exactly when the two objects hash equal. */
+    static QStringList changedKeys(const QJsonObject &a, const QJsonObject &b,
+                                   ArrayMode mode = UnorderedArrays);
+
+    QString toHex() const;
+
+    bool operator==(const JsonHash &o) const { return lo == o.lo && hi == o.hi; }
+    bool operator!=(const JsonHash &o) const { return !(*this == o); }
+};
+
+#endif // JSONHASH_H
@@ -0,0 +1,223 @@
+#include "platereformatter.h"
+#include "gwlgenerator.h"
+
+#include <QJsonObject>
+#include <QObject>
+
+namespace {
+
+QString rackLabel(const QString &label, int index)
+{
+    return QString("%1[%2]").arg(label).arg(index + 1, 3, 10, QChar('0'));
+}
+
+// rows/8 for 96/384/1536-style formats (2:3 aspect, rows a multiple of 8)
+int headStride(const PlateReformatter::Format &f)
+{
+    if (f.rows <= 0 || f.rows % 8 != 0 || f.columns * 2 != f.rows * 3) return 0;
+    return f.rows / 8;
+}
+
+} // namespace
+
+bool PlateReformatter::plan(const Format &source, Mode mode, Plan &out, QString *errorMsg)
+{
+    if (source.rows <= 0 || source.columns <= 0 || source.rows > 127 || source.columns > 127) {
+        if (errorMsg) *errorMsg = QObject::tr("Invalid source plate format %1 x %2.")
+                                      .arg(source.rows).arg(source.columns);
+        return false;
+    }
+
+    out = Plan();
+    out.source       = source;
+    out.destination  = Format{ source.rows * 2, source.columns * 2 };
+    out.sourcePlates = 4;
+
+    const int n = out.sourceWells();
+    out.fromDestination.fill(-1, out.destinationWells());
+    out.toDestination.resize(4 * n);
+
+    for (int k = 0; k < 4; ++k) {
+        const int qr = k / 2, qc = k % 2;
+        for (int r = 0; r < source.rows; ++r) {
+            for (int c = 0; c < source.columns; ++c) {
+                const int dr = mode == Interleaved ? 2 * r + qr : r + qr * source.rows;
+                const int dc = mode == Interleaved ? 2 * c + qc : c + qc * source.columns;
+                const int slot = k * n + r * source.columns + c;
+                const int d    = dr * out.destination.columns + dc;
+                out.toDestination[slot] = d;
+                out.fromDestination[d]  = slot;
+            }
+        }
+    }
+    return true;
+}
+
+bool PlateReformatter::compose(const Plan &first, const Plan &second, Plan &out, QString *errorMsg)
+{
+    if (!first.isValid() || !second.isValid()
+        || first.destination.rows != second.source.rows
+        || first.destination.columns != second.source.columns) {
+        if (errorMsg) *errorMsg = QObject::tr("The reformatting steps do not fit together.");
+        return false;
+    }
+
+    Plan p;
+    p.source       = first.source;
+    p.destination  = second.destination;
+    p.sourcePlates = first.sourcePlates * second.sourcePlates;
+    p.fromDestination.fill(-1, p.destinationWells());
+    p.toDestination.resize(p.sourcePlates * p.sourceWells());
+
+    // combined source plate = intermediate plate * first.sourcePlates + its source plate
+    const int n = first.sourceWells();
+    const int m = second.sourceWells();
+    for (int slot = 0; slot < p.toDestination.size(); ++slot) {
+        const int plate = slot / n, well = slot % n;
+        const int mid   = first.toDestination.at((plate % first.sourcePlates) * n + well);
+        const int d     = second.toDestination.at((plate / first.sourcePlates) * m + mid);
+        p.toDestination[slot] = d;
+        p.fromDestination[d]  = slot;
+    }
+    out = p;
+    return true;
+}
+
+bool PlateReformatter::reformatPlates(const Plan &plan, const QJsonArray &sourcePlates,
+                                      QJsonArray &out, QString *errorMsg)
+{
+    out = QJsonArray();
+    if (!plan.isValid()) {
+        if (errorMsg) *errorMsg = QObject::tr("No reformatting plan.");
+        return false;
+    }
+
+    const int n = plan.sourceWells();
+    const int groups = (sourcePlates.size() + plan.sourcePlates - 1) / plan.sourcePlates;
+    for (int g = 0; g < groups; ++g) {
+        QJsonObject wellsOut;
+        QJsonArray  used;
+        QJsonValue  steps;
+        for (int k = 0; k < plan.sourcePlates; ++k) {
+            const int idx = g * plan.sourcePlates + k;
+            if (idx >= sourcePlates.size()) break;
+
+            const QJsonObject src = sourcePlates.at(idx).toObject();
+            const int number = src.value("plate_number").toInt(idx + 1);
+            used.append(number);
+            if (steps.isUndefined()) steps = src.value("dilution_steps");
+
+            const QJsonObject wells = src.value("wells").toObject();
+            for (auto it = wells.constBegin(); it != wells.constEnd(); ++it) {
+                int r = 0, c = 0;
+                if (!DaughterLayoutEngine::parseWell(it.key(), r, c)
+                    || r >= plan.source.rows || c >= plan.source.columns) {
+                    if (errorMsg) *errorMsg = QObject::tr("Plate %1: well %2 is not on a %3-well plate.")
+                                                  .arg(number).arg(it.key()).arg(n);
+                    return false;
+                }
+                const int d = plan.toDestination.at(k * n + r * plan.source.columns + c);
+                wellsOut[DaughterLayoutEngine::wellName(d / plan.destination.columns,
+                                                        d % plan.destination.columns)] = it.value();
+            }
+        }
+
+        QJsonObject plateObj;
+        plateObj["plate_number"]  = g + 1;
+        plateObj["rows"]          = plan.destination.rows;
+        plateObj["columns"]       = plan.destination.columns;
+        plateObj["source_plates"] = used;
+        if (!steps.isUndefined()) plateObj["dilution_steps"] = steps;
+        plateObj["wells"]         = wellsOut;
+        out.append(plateObj);
+    }
+    return true;
+}
+
+bool PlateReformatter::worklist(const Plan &plan, const QVector<QVector<bool>> &used,
+                                const TransferOptions &options, QStringList &lines,
+                                QString *errorMsg)
+{
+    lines.clear();
+    if (!plan.isValid()) {
+        if (errorMsg) *errorMsg = QObject::tr("No reformatting plan.");
+        return false;
+    }
+
+    const Format &sf = plan.source;
+    const Format &df = plan.destination;
+    const int n = plan.sourceWells();
+    auto isUsed = [&](int p, int w) { return w < used.at(p).size() && used.at(p).at(w); };
+
+    lines << QString("C;Reformat %1 x %2 -> %3 wells, %4 uL per well%5")
+                 .arg(plan.sourcePlates).arg(n).arg(plan.destinationWells())
+                 .arg(QString::number(options.volumeUL), options.mca96 ? QStringLiteral(" (MCA96)") : QString());
+    lines << "B;";
+
+    if (!options.mca96) {
+        for (int p = 0; p < used.size(); ++p) {
+            const QString src = rackLabel(options.sourceLabel, p);
+            const QString dst = rackLabel(options.destinationLabel, p / plan.sourcePlates);
+            const int base = (p % plan.sourcePlates) * n;
+            for (int c = 0; c < sf.columns; ++c) {
+                for (int r = 0; r < sf.rows; ++r) {
+                    const int w = r * sf.columns + c;
+                    if (!isUsed(p, w)) continue;
+                    const int d = plan.toDestination.at(base + w);
+                    GWLGenerator::appendTransfer(lines, src, position(sf, r, c),
+                                                 dst, position(df, d / df.columns, d % df.columns),
+                                                 options.volumeUL, options.liquidClass);
+                }
+            }
+        }
+        lines << "B;";
+        return true;
+    }
+
+    // MCA 96: the head covers 8 x 12 wells at 9 mm, i.e. every stride-th well
+    const int ss = headStride(sf), ds = headStride(df);
+    if (ss == 0 || ds == 0) {
+        if (errorMsg) *errorMsg = QObject::tr("The 96 head cannot address %1- or %2-well plates.")
+                                      .arg(n).arg(plan.destinationWells());
+        return false;
+    }
+
+    for (int p = 0; p < used.size(); ++p) {
+        const QString src = rackLabel(options.sourceLabel, p);
+        const QString dst = rackLabel(options.destinationLabel, p / plan.sourcePlates);
+        const int base = (p % plan.sourcePlates) * n;
+
+        for (int qc = 0; qc < ss; ++qc) {
+            for (int qr = 0; qr < ss; ++qr) {
+                bool any = false;
+                int d0r = -1, d0c = -1;
+                for (int i = 0; i < 8; ++i) {
+                    for (int j = 0; j < 12; ++j) {
+                        const int w = (qr + i * ss) * sf.columns + (qc + j * ss);
+                        any = any || isUsed(p, w);
+                        const int d = plan.toDestination.at(base + w);
+                        const int dr = d / df.columns, dc = d % df.columns;
+                        if (i == 0 && j == 0) { d0r = dr; d0c = dc; }
+                        if (dr != d0r + i * ds || dc != d0c + j * ds) {
+                            if (errorMsg) *errorMsg = QObject::tr(
+                                "This mapping cannot be stamped with the 96 head; use single tips.");
+                            lines.clear();
+                            return false;
+                        }
+                    }
+                }
+                if (!any) continue;
+
+                lines << QString("C;MCA96 %1 %2 -> %3 %4")
+                             .arg(src, DaughterLayoutEngine::wellName(qr, qc),
+                                  dst, DaughterLayoutEngine::wellName(d0r, d0c));
+                GWLGenerator::appendMcaTransfer(lines, GWLGenerator::McaHead::MCA96, true,
+                                                src, position(sf, qr, qc),
+                                                dst, position(df, d0r, d0c),
+                                                options.volumeUL, options.mcaLiquidClass);
+            }
+        }
+    }
+    lines << "B;";
+    return true;
+}
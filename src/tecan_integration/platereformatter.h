@@ -0,0 +1,112 @@
+#ifndef PLATEREFORMATTER_H
+#define PLATEREFORMATTER_H
+
+#include <QJsonArray>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "daughterlayout.h"
+
+/**
+ * Widget-free compression of plates into a denser format: four 96-well
+ * plates into one 384, four 384s into one 1536, or both steps at once
+ * (sixteen 96s into one 1536).
+ *
+ * A Plan is a pair of index tables between "source slot" (source plate *
+ * source wells + well, row-major) and destination well, so laying out the
+ * destination and writing the transfers are plain lookups. Two mappings:
+ *   - Interleaved: source plate k lands on the wells offset by
+ *     (k / 2, k % 2) with a stride of two (the quadrant pattern a 96 head
+ *     produces, A1 of plate 1 ➜ A1, of plate 2 ➜ A2, of plate 3 ➜ B1…);
+ *   - Blocks: source plate k fills one contiguous quadrant (top left, top
+ *     right, bottom left, bottom right).
+ * compose() chains two plans, e.g. 96 ➜ 384 then 384 ➜ 1536.
+ *
+ * worklist() writes the transfers with the LiHa (occupied wells only) or,
+ * where the tables allow it, as MCA 96 stamps: one head movement per
+ * source plate quadrant instead of one tip per well.
+ */
+class PlateReformatter
+{
+public:
+    using Format = DaughterLayoutEngine::Format;
+
+    enum Mode {
+        Interleaved,
+        Blocks
+    };
+
+    struct Plan {
+        Format source;
+        Format destination;
+        int    sourcePlates = 0;               // per destination plate
+        QVector<qint32> fromDestination;       // destination well ➜ source slot, -1 = unused
+        QVector<qint32> toDestination;         // source slot ➜ destination well
+
+        int sourceWells()      const { return source.rows * source.columns; }
+        int destinationWells() const { return destination.rows * destination.columns; }
+        bool isValid() const { return sourcePlates > 0 && !toDestination.isEmpty(); }
+    };
+
+    /** Four `source` plates into one plate with twice the rows and columns. */
+    static bool plan(const Format &source, Mode mode, Plan &out, QString *errorMsg = nullptr);
+
+    /** `first` then `second` (second.source must be first.destination). */
+    static bool compose(const Plan &first, const Plan &second, Plan &out,
+                        QString *errorMsg = nullptr);
+
+    /** Destination contents of one destination plate; `sources` holds up to
+        sourcePlates row-major well vectors, missing plates count as empty. */
+    template <typename T>
+    static QVector<T> apply(const Plan &plan, const QVector<QVector<T>> &sources,
+                            const T &empty = T())
+    {
+        QVector<T> out(plan.destinationWells(), empty);
+        const int n = plan.sourceWells();
+        for (int d = 0; d < out.size(); ++d) {
+            const int slot = plan.fromDestination.at(d);
+            if (slot < 0) continue;
+            const int p = slot / n, w = slot % n;
+            if (p < sources.size() && w < sources.at(p).size()) out[d] = sources.at(p).at(w);
+        }
+        return out;
+    }
+
+    /**
+     * `daughter_plates` (wells: name ➜ label) reformatted in groups of
+     * sourcePlates. Each destination object gets plate_number, rows,
+     * columns, source_plates (plate_numbers used) and the remapped wells;
+     * dilution_steps is taken from the first source.
+     */
+    static bool reformatPlates(const Plan &plan, const QJsonArray &sourcePlates,
+                               QJsonArray &out, QString *errorMsg = nullptr);
+
+    struct TransferOptions {
+        double  volumeUL         = 1.0;
+        QString sourceLabel      = QStringLiteral("Daughter");     // Daughter[001], …
+        QString destinationLabel = QStringLiteral("Reformat");
+        QString liquidClass      = QStringLiteral("DMSO Contact Wet Single Invenesis");
+        QString mcaLiquidClass   = QStringLiteral("DMSO Contact Wet MCA Invenesis");
+        bool    mca96            = false;
+    };
+
+    /**
+     * Worklist lines for `used` source plates (per plate, row-major; a plate
+     * missing from `used` is skipped). LiHa: one A/D/W per used well, in
+     * source column order. MCA 96: one stamp per source quadrant holding a
+     * used well, written as whole-head MCA96 records (tip type and mask
+     * fields, see GWLGenerator::appendMcaTransfer). Fails if the plan does
+     * not keep the head's 9 mm grid (Blocks into a denser plate), so the
+     * caller can fall back to the LiHa.
+     */
+    static bool worklist(const Plan &plan, const QVector<QVector<bool>> &used,
+                         const TransferOptions &options, QStringList &lines,
+                         QString *errorMsg = nullptr);
+
+    /** Tecan position of (row, column): column-major, 1-based. */
+    static int position(const Format &format, int row, int column)
+    { return column * format.rows + row + 1; }
+};
+
+#endif // PLATEREFORMATTER_H
@@ -0,0 +1,135 @@
+#include "runtimeestimator.h"
+#include "gwlrecord.h"
+
+#include <QObject>
+
+RunTimeEstimator::RunTimeEstimator(const DeckLayout &deck, const Costs &costs)
+    : deck_(deck)
+    , costs_(costs)
+{
+}
+
+double RunTimeEstimator::travelSeconds(double mm) const
+{
+    if (mm <= 0.0) return 0.0;
+    return costs_.travelSettleS + mm / qMax(1.0, costs_.travelMMPerS);
+}
+
+RunTimeEstimator::Estimate
+RunTimeEstimator::estimate(const QVector<GWLGenerator::FileOut> &outs) const
+{
+    Estimate est;
+
+    QPointF arm(0.0, 0.0);                 // arm parks at the deck origin
+
+    for (const auto &fo : outs) {
+        if (fo.isAux || !fo.relativePath.endsWith(QLatin1String(".gwl"), Qt::CaseInsensitive))
+            continue;
+
+        FileEstimate fe;
+        fe.file = fo.relativePath;
+
+        bool    needTip = true;
+        // previous liquid record, for merging multi-channel moves
+        GwlRecord::Kind prevKind = GwlRecord::Invalid;
+        QString prevLabel;
+        int     prevCol  = -1;
+        int     prevMask = 0;
+
+        GwlRecord rec;
+        for (const QString &line : fo.lines) {
+            if (!GwlRecord::parse(line, rec)) continue;
+
+            switch (rec.kind) {
+            case GwlRecord::Wash:
+                fe.seconds += costs_.washS;
+                ++fe.washes;
+                needTip  = true;
+                prevKind = GwlRecord::Invalid;
+                continue;
+            case GwlRecord::Aspirate:
+            case GwlRecord::Dispense:
+                break;
+            default:
+                continue;
+            }
+
+            const bool aspirate = (rec.kind == GwlRecord::Aspirate);
+            const bool mca      = rec.isMca();
+            if (aspirate) ++fe.aspirates; else ++fe.dispenses;
+            fe.seconds += rec.volumeUL * costs_.perUlS;
+
+            const int rows = qMax(1, deck_.siteFor(rec.label).rows);
+            const int col  = (rec.position - 1) / rows;
+            const int mask = rec.tipMask > 0 ? rec.tipMask : 1;
+
+            const bool merged = !mca
+                             && rec.kind == prevKind
+                             && rec.label == prevLabel
+                             && col == prevCol
+                             && (mask & prevMask) == 0;
+            if (merged) {
+                prevMask |= mask;
+                continue;
+            }
+
+            if (aspirate && needTip) {
+                fe.seconds += costs_.tipPickS;
+                needTip = false;
+            }
+
+            const QPointF to = deck_.wellPosition(rec.label, rec.position);
+            const double  mm = DeckLayout::distance(arm, to);
+            fe.travelMM += mm;
+            fe.seconds  += travelSeconds(mm);
+            arm = to;
+
+            if (mca) fe.seconds += aspirate ? costs_.mcaAspirateS : costs_.mcaDispenseS;
+            else     fe.seconds += aspirate ? costs_.aspirateS    : costs_.dispenseS;
+
+            prevKind  = rec.kind;
+            prevLabel = rec.label;
+            prevCol   = col;
+            prevMask  = mask;
+        }
+
+        est.totalSeconds += fe.seconds;
+        est.travelMM     += fe.travelMM;
+        est.files.push_back(fe);
+    }
+    return est;
+}
+
+QString RunTimeEstimator::formatDuration(double seconds)
+{
+    const qint64 s = qRound64(seconds);
+    if (s < 60) return QObject::tr("%1 s").arg(s);
+    const qint64 h = s / 3600;
+    const qint64 m = (s % 3600) / 60;
+    if (h == 0) return QObject::tr("%1 min %2 s").arg(m).arg(s % 60, 2, 10, QChar('0'));
+    return QObject::tr("%1 h %2 min").arg(h).arg(m, 2, 10, QChar('0'));
+}
+
+QString RunTimeEstimator::Estimate::summary() const
+{
+    return QObject::tr("Estimated run time: %1 (%2 worklists, %3 m arm travel)")
+        .arg(formatDuration(totalSeconds))
+        .arg(files.size())
+        .arg(travelMM / 1000.0, 0, 'f', 1);
+}
+
+QStringList RunTimeEstimator::Estimate::toCsv() const
+{
+    QStringList L;
+    L << "File,Seconds,Travel_mm,Aspirates,Dispenses,Washes";
+    for (const auto &f : files)
+        L << QString("%1,%2,%3,%4,%5,%6")
+                 .arg(f.file)
+                 .arg(QString::number(f.seconds, 'f', 1))
+                 .arg(QString::number(f.travelMM, 'f', 0))
+                 .arg(f.aspirates).arg(f.dispenses).arg(f.washes);
+    L << QString("TOTAL,%1,%2,,,")
+             .arg(QString::number(totalSeconds, 'f', 1))
+             .arg(QString::number(travelMM, 'f', 0));
+    return L;
+}
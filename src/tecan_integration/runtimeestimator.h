@@ -0,0 +1,66 @@
+#ifndef RUNTIMEESTIMATOR_H
+#define RUNTIMEESTIMATOR_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "decklayout.h"
+#include "gwlgenerator.h"
+
+/**
+ * Wall-clock estimate for a set of generated worklists.
+ *
+ * Every A;/D; record costs a fixed base time plus a per-µL term, W; costs a
+ * wash / tip drop and the next aspirate a tip pick. The arm travels between
+ * the deck positions of consecutive records; records of the same kind on
+ * the same labware column with different tips are executed by the arm in
+ * one move (8-channel batching) and only pay the liquid time.
+ */
+class RunTimeEstimator
+{
+public:
+    struct Costs {
+        double aspirateS      = 4.0;
+        double dispenseS      = 3.0;
+        double perUlS         = 0.02;
+        double washS          = 8.0;   // W; (wash or tip drop)
+        double tipPickS       = 6.0;
+        double mcaAspirateS   = 7.0;
+        double mcaDispenseS   = 6.0;
+        double travelMMPerS   = 400.0;
+        double travelSettleS  = 0.6;   // Z up/down around each move
+    };
+
+    struct FileEstimate {
+        QString file;
+        double  seconds   = 0.0;
+        double  travelMM  = 0.0;
+        int     aspirates = 0;
+        int     dispenses = 0;
+        int     washes    = 0;
+    };
+
+    struct Estimate {
+        QVector<FileEstimate> files;
+        double totalSeconds = 0.0;
+        double travelMM     = 0.0;
+
+        QString summary() const;
+        QStringList toCsv() const;
+    };
+
+    explicit RunTimeEstimator(const DeckLayout &deck = DeckLayout::fluentDefault(),
+                              const Costs &costs = Costs());
+
+    Estimate estimate(const QVector<GWLGenerator::FileOut> &outs) const;
+
+    double travelSeconds(double mm) const;
+    static QString formatDuration(double seconds);
+
+private:
+    DeckLayout deck_;
+    Costs      costs_;
+};
+
+#endif // RUNTIMEESTIMATOR_H
@@ -25,122 +25,29 @@
 #include <QJsonObject>
 #include <QDebug>
 #include <QSet>
+#include <QHash>
+#include <QApplication>
+#include <QStatusBar>
+#include <QSignalBlocker>
+#include <QProgressDialog>
 
 // Project
-#include "plate_management/daughterplatewidget.h"
+#include "plate_management/daughterplatelist.h"
 #include "standardselectiondialog.h"
 #include "ui/loadexperimentdialog.h"
 #include "gwlgenerator.h"
-
-/* ============================================================
- *  Canonical JSON  – deterministic order for objects & arrays
- *  (place once in tecanwindow.cpp, after #includes)
- * ============================================================ */
-#include <algorithm>
-#include <QJsonDocument>
-
-/* ----- helper: convert ANY QJsonValue to stable compact bytes ----- */
-static QByteArray jBytes(const QJsonValue &v)
-{
-    switch (v.type()) {
-    case QJsonValue::Object:
-        return QJsonDocument(v.toObject()).toJson(QJsonDocument::Compact);
-    case QJsonValue::Array:
-        return QJsonDocument(v.toArray()).toJson(QJsonDocument::Compact);
-    case QJsonValue::String:
-        return v.toString().toUtf8();
-    case QJsonValue::Double:
-        return QByteArray::number(v.toDouble(), 'g', 16);
-    case QJsonValue::Bool:
-        return v.toBool() ? "true" : "false";
-    default:                         /* Null / Undefined */
-        return "null";
-    }
-}
-
-/* forward decl */
-static QJsonValue canonJson(const QJsonValue &v);
-
-/* ----- key‑sorted object -------------------------------------------- */
-static QJsonObject canonObject(const QJsonObject &in)
-{
-    QJsonObject out;
-    QStringList keys = in.keys();
-    std::sort(keys.begin(), keys.end(),
-              [](const QString &a, const QString &b){
-                  return a.localeAwareCompare(b) < 0;
-              });
-    for (const QString &k : keys)
-        out.insert(k, canonJson(in.value(k)));
-    return out;
-}
-
-/* ----- array sorted by canonical byte string ------------------------ */
-static QJsonArray canonArray(const QJsonArray &in)
-{
-    QList<QJsonValue> lst;
-    lst.reserve(in.size());
-    for (const QJsonValue &v : in)
-        lst.append(canonJson(v));
-
-    std::sort(lst.begin(), lst.end(),
-              [](const QJsonValue &a, const QJsonValue &b){
-                  return jBytes(a) < jBytes(b);
-              });
-
-    QJsonArray out;
-    for (const QJsonValue &v : std::as_const(lst))
-        out.append(v);
-    return out;
-}
-
-/* ----- dispatch ----------------------------------------------------- */
-static QJsonValue canonJson(const QJsonValue &v)
-{
-    if (v.isObject()) return canonObject(v.toObject());
-    if (v.isArray())  return canonArray(v.toArray());
-    /* treat empty string and null as equivalent */
-    if (v.isString() && v.toString().trimmed().isEmpty()) return QJsonValue();
-    return v;              // primitive number/bool/null or undefined
-}
-
-/* public helpers ----------------------------------------------------- */
-static QJsonObject canonicalise(const QJsonObject &obj)
-{
-    return canonObject(obj);
-}
-
-/* deep equality, ignoring order & numeric‑string mismatch */
-static bool jsonEqual(const QJsonValue &a, const QJsonValue &b)
-{
-    const QJsonValue ca = canonJson(a), cb = canonJson(b);
-
-    if (ca.type() != cb.type()) {
-        /* tolerate number <-> string if content matches */
-        if ((ca.isDouble() && cb.isString()) ||
-            (ca.isString() && cb.isDouble()))
-            return ca.toString() == cb.toString();
-        return false;
-    }
-    return jBytes(ca) == jBytes(cb);
-}
-
-
-
-
+#include "gwljob.h"
+#include "batchgenerator.h"
+#include "experimentstore.h"
+#include "jsonhash.h"
+#include "experimenthistorydialog.h"
+#include "daughterlayout.h"
+#include "platereformatter.h"
 
 using SqlModelUPtr = std::unique_ptr<QSqlQueryModel>;
 
 
 
-namespace                       /* ====== file‑local helpers / constants ====== */
-{
-static constexpr int  kMaxColumns    = 12;
-static const QStringList kPlateRows  = {"A","B","C","D","E","F","G","H"};
-
-
-} // unnamed namespace
-
 /* ======= static QMessageBox wrappers (header declared) ======= */
 void TecanWindow::showInfo(QWidget *parent, const QString &title,
                            const QString &msg)
@@ -179,12 +86,11 @@ TecanWindow::TecanWindow(QWidget *parent)
     matrixPlateContainer = new MatrixPlateContainer(this);
     ui->plateDisplayScrollArea->setWidget(matrixPlateContainer);
 
-    daughterPlatesContainerWidget = new QWidget(this);
-    daughterPlatesLayout = new QVBoxLayout(daughterPlatesContainerWidget);
-    daughterPlatesLayout->setAlignment(Qt::AlignTop);
-    ui->daughterPlateScrollArea->setWidgetResizable(true);
-    ui->daughterPlateScrollArea->setAlignment(Qt::AlignTop | Qt::AlignHCenter);
-    ui->daughterPlateScrollArea->setWidget(daughterPlatesContainerWidget);
+    daughterPlateList = new DaughterPlateList(ui->daughterPlateScrollArea);   // only visible plates get widgets
+
+    ui->daughterFormatComboBox->setItemData(0, 96);
+    ui->daughterFormatComboBox->setItemData(1, 384);
+    ui->daughterFormatComboBox->setItemData(2, 1536);
 }
 
 TecanWindow::~TecanWindow()                                          = default;
@@ -352,103 +258,169 @@ void TecanWindow::populateDaughterPlates(int dilutionSteps,
                                          const QStringList &compoundList,
                                          const QString &testType)
 {
-    /* ---- clear previous widgets ---- */
-    while (auto *item = daughterPlatesLayout->takeAt(0)) {
-        delete item->widget();
-        delete item;
-    }
-
-    /* ---- determine special (INV‑T‑031) layout? ---- */
-    const bool isINV_T_031  = testType.contains(QLatin1String("INV-T-031"));
-    const int  standardCol  = isINV_T_031 ? 11 : -1;
-    const int  dmsoCol      = isINV_T_031 ? 12 : -1;
-
-    /* ---- build list of fixed wells ---- */
-    QStringList standardWells, dmsoWells;
-    if (isINV_T_031) {
-        for (const QString &row : kPlateRows) {
-            standardWells << row + QString::number(standardCol);
-            dmsoWells     << row + QString::number(dmsoCol);
-        }
-    } else {
-        const int stdDilutions = qMax(dilutionSteps, 6);
-        for (int c = 1; c <= stdDilutions; ++c) standardWells << "A" + QString::number(c);
-        for (int c = 1; c <= kMaxColumns; ++c)  dmsoWells     << "H" + QString::number(c);
+    /* ---- placement (INV‑T‑031 column rules etc. live in the engine) ---- */
+    DaughterLayoutEngine::Request req;
+    req.compoundCount = compoundList.size();
+    req.dilutionSteps = dilutionSteps;
+    req.reservation   = DaughterLayoutEngine::reservationForTest(testType);
+    req.format        = daughterFormat;
+
+    // chains already on the plates stay put; only new compounds are placed
+    DaughterLayoutEngine::Layout layout;
+    QString err;
+    if (!DaughterLayoutEngine::relayout(req, compoundList,
+                                        daughterLayout, daughterLayoutNames,
+                                        handPlacedWells(), layout, &err)) {
+        showWarning(this, tr("Daughter Plates"), err);
+        return;
     }
 
-    /* ---------------------------------------------------------------------- */
-    QList<QMap<QString,QStringList>> plates(1);
-    plates[0]["Standard"] = standardWells;
-    plates[0]["DMSO"]     = dmsoWells;
-
-    int plateIdx   = 0;
-    int curRowIdx  = isINV_T_031 ? 0 : 1;     // skip row A if not special
-    int curColIdx  = 1;
+    // plates saved by the optimising packer (the old fill is cheap to run)
+    DaughterLayoutEngine::Request bandsReq = req;
+    bandsReq.packing = DaughterLayoutEngine::RowBands;
+    DaughterLayoutEngine::Layout bands;
+    const int saved = DaughterLayoutEngine::layout(bandsReq, bands)
+                          ? bands.plateCount - layout.plateCount : 0;
+    statusBar()->showMessage(saved > 0
+        ? tr("%1 daughter plate(s), %2 fewer than row-by-row filling").arg(layout.plateCount).arg(saved)
+        : tr("%1 daughter plate(s)").arg(layout.plateCount));
+
+    applyDaughterLayout(layout, compoundList);
+}
 
-    auto startNewPlate = [&]{
-        plates.append({{"Standard",standardWells}, {"DMSO",dmsoWells}});
-        ++plateIdx;
-        curRowIdx = isINV_T_031 ? 0 : 1;
-        curColIdx = 1;
+void TecanWindow::applyDaughterLayout(const DaughterLayoutEngine::Layout &layout,
+                                      const QStringList &names)
+{
+    const int steps = layout.dilutionSteps;
+    auto colours = [](const QMap<QString,QStringList> &wells) {
+        QMap<QString,QColor> map;
+        for (auto it = wells.cbegin(); it != wells.cend(); ++it)
+            map[it.key()] = DaughterPlateState::compoundColour(it.key());
+        return map;
     };
 
-    /* ---- place every compound, honouring dilution steps & reserved cols ---- */
-    for (const QString &cmpd : compoundList)
-    {
-        while (true)                              // find first valid region
-        {
-            const int lastCol = curColIdx + dilutionSteps - 1;
-            const bool overlapSpecial = isINV_T_031 && lastCol >= standardCol;
-            const bool exceedCols     = lastCol > (isINV_T_031 ? standardCol-1
-                                                           : kMaxColumns);
-            if (!overlapSpecial && !exceedCols) break;
-
-            if (++curRowIdx >= kPlateRows.size() - (isINV_T_031 ? 0 : 1))
-                startNewPlate();
+    const DaughterLayoutEngine::Diff diff =
+        DaughterLayoutEngine::diff(daughterLayout, daughterLayoutNames, layout, names);
+    const QStringList oldNames = daughterLayoutNames;
+    daughterLayout      = layout;
+    daughterLayoutNames = names;
+
+    /* ---- different frame (or plates loaded from JSON): rebuild the data ---- */
+    if (diff.rebuild || daughterPlateList->plateCount() == 0) {
+        QVector<DaughterPlateState> plates(layout.plateCount,
+                                           DaughterPlateState(layout.format.rows, layout.format.columns));
+        for (int p = 0; p < layout.plateCount; ++p) {
+            const QMap<QString,QStringList> wells = layout.plateWells(p, names);
+            plates[p].populate(wells, colours(wells), steps);
         }
+        daughterPlateList->setStandardInfo(QString(), QString());
+        daughterPlateList->setPlates(plates, /*acceptDrops=*/true);
+        return;
+    }
 
+    /* ---- same frame: touch only the chains that moved ---- */
+    const QMap<QString,QStringList> reserved = layout.plateWells(-1, QStringList());  // Standard + DMSO
+    DaughterPlateState blank(layout.format.rows, layout.format.columns);
+    blank.populate(reserved, colours(reserved), steps);
+    daughterPlateList->resizePlates(layout.plateCount, blank, /*acceptDrops=*/true);
+
+    QMap<int, DaughterPlateState> edited;
+    QMap<int, QVector<int>>       changed;
+    auto plate = [&](int p) -> DaughterPlateState & {
+        auto it = edited.find(p);
+        if (it == edited.end()) it = edited.insert(p, daughterPlateList->plate(p));
+        return *it;
+    };
+    auto chainWells = [](const DaughterLayoutEngine::Segment &s) {
         QStringList wells;
-        for (int d = 0; d < dilutionSteps; ++d)
-            wells << kPlateRows[curRowIdx] + QString::number(curColIdx + d);
-
-        plates[plateIdx][cmpd] = wells;
-
-        if (++curRowIdx >= kPlateRows.size() - (isINV_T_031 ? 0 : 1))
-        {
-            curRowIdx = isINV_T_031 ? 0 : 1;
-            curColIdx += dilutionSteps;
+        for (int d = 0; d < s.length; ++d)
+            wells << DaughterLayoutEngine::wellName(s.row, s.column + d);
+        return wells;
+    };
 
-            if (isINV_T_031 && curColIdx >= standardCol) curColIdx = 1;
-            if (curColIdx > (isINV_T_031 ? standardCol-1 : kMaxColumns))
-                startNewPlate();
+    for (const auto &s : diff.removed) {
+        if (s.plate >= layout.plateCount) continue;             // plate is gone
+        DaughterPlateState &st = plate(s.plate);
+        const QString name = oldNames.value(s.compound);
+        QVector<int> wells;                                     // skip wells edited by hand
+        for (const QString &w : chainWells(s)) {
+            const int idx = st.wellIndex(w);
+            if (idx >= 0 && st.compoundName(idx) == name) wells << idx;
         }
+        changed[s.plate] += st.clearWells(wells);
+    }
+    for (const auto &s : diff.added) {
+        const QString &name = names.at(s.compound);
+        changed[s.plate] += plate(s.plate).populate({{name, chainWells(s)}},
+                                                    {{name, DaughterPlateState::compoundColour(name)}},
+                                                    steps);
     }
+    for (auto it = edited.cbegin(); it != edited.cend(); ++it)
+        daughterPlateList->updatePlate(it.key(), it.value(), changed.value(it.key()));
+}
 
-    /* ---- render daughter plates ---- */
-    for (int i = 0; i < plates.size(); ++i)
-    {
-        auto *plateWidget = new DaughterPlateWidget(i+1, this);
-
-        /* assign colours */
-        QMap<QString,QColor> colours;
-        int hue = 0, hueStep = 360 / (plates[i].size() + 1);
-        for (auto it = plates[i].cbegin(); it != plates[i].cend(); ++it) {
-            if (it.key() == "DMSO")      colours[it.key()] = Qt::gray;
-            else if (it.key() == "Standard")
-                colours[it.key()] = QColor(0,122,204);
-            else {                       colours[it.key()] = QColor::fromHsv(hue,200,220);
-                hue += hueStep; }
+QVector<QVector<quint64>> TecanWindow::handPlacedWells() const
+{
+    // wells holding something other than what daughterLayout put there
+    QVector<QVector<quint64>> masks;
+    const auto &fmt = daughterLayout.format;
+    if (daughterLayout.segments.isEmpty()) return masks;     // relayout starts afresh
+
+    for (int p = 0; p < daughterPlateList->plateCount(); ++p) {
+        const DaughterPlateState &st = daughterPlateList->plate(p);
+        if (st.rows() != fmt.rows || st.columns() != fmt.columns) return {};
+
+        QHash<QString, QString> expected;                      // well -> name
+        const auto wells = daughterLayout.plateWells(p, daughterLayoutNames);
+        for (auto it = wells.cbegin(); it != wells.cend(); ++it)
+            for (const QString &w : it.value()) expected.insert(w, it.key());
+
+        QVector<quint64> mask(st.rows(), 0);
+        for (int i = 0; i < st.wellCount(); ++i) {
+            if (st.isEmpty(i) || expected.value(st.wellId(i)) == st.compoundName(i)) continue;
+            mask[i / st.columns()] |= quint64(1) << (i % st.columns());
         }
-
-        plateWidget->populatePlate(plates[i], colours, dilutionSteps);
-        plateWidget->enableCompoundDragDrop(dilutionSteps);
-        daughterPlatesLayout->addWidget(plateWidget);
+        masks.append(mask);
     }
+    return masks;
 }
 
 /* ========================================================================== */
 /*                             UI slot handlers                               */
 /* ========================================================================== */
+void TecanWindow::on_daughterFormatComboBox_currentIndexChanged(int index)
+{
+    const DaughterLayoutEngine::Format format =
+        DaughterLayoutEngine::formatForWells(ui->daughterFormatComboBox->itemData(index).toInt());
+    if (format.rows == daughterFormat.rows && format.columns == daughterFormat.columns) return;
+    daughterFormat = format;
+
+    if (testRequestModel->rowCount() == 0) {
+        daughterPlateList->clear();
+        daughterLayout      = DaughterLayoutEngine::Layout();
+        daughterLayoutNames.clear();
+        return;
+    }
+
+    // lay the shown compounds out again on the new plates
+    QStringList compounds = daughterLayoutNames;
+    for (int i = 0, rows = compoundQueryModel->rowCount(); i < rows; ++i)
+        compounds << compoundQueryModel->record(i).value("product_name").toString();
+    compounds.removeDuplicates();
+
+    const QSqlRecord tr0 = testRequestModel->record(0);
+    populateDaughterPlates(tr0.value("number_of_dilutions").toInt(), compounds,
+                           tr0.value("requested_tests").toString());
+}
+
+void TecanWindow::setDaughterFormat(const DaughterLayoutEngine::Format &format)
+{
+    daughterFormat = format;
+    const int i = ui->daughterFormatComboBox->findData(format.rows * format.columns);
+    const QSignalBlocker block(ui->daughterFormatComboBox);
+    ui->daughterFormatComboBox->setCurrentIndex(qMax(0, i));
+}
+
 void TecanWindow::on_clearPlatesButton_clicked()
 {
     if (QMessageBox::question(this, tr("Clear Plates"),
@@ -457,13 +429,9 @@ void TecanWindow::on_clearPlatesButton_clicked()
                               QMessageBox::Yes|QMessageBox::No) != QMessageBox::Yes)
         return;
 
-    for (int i = 0; i < daughterPlatesLayout->count(); ++i)
-        if (auto *plate = qobject_cast<DaughterPlateWidget*>(
-                daughterPlatesLayout->itemAt(i)->widget()))
-        {
-            plate->clearCompounds();
-            plate->setAcceptDrops(true);
-        }
+    daughterPlateList->clearCompounds();
+    daughterLayout      = DaughterLayoutEngine::Layout();   // the next layout starts afresh
+    daughterLayoutNames.clear();
 }
 
 /* =========================================================================
@@ -509,43 +477,29 @@ void TecanWindow::on_actionSave_triggered()
 
     qDebug() << QJsonDocument(expJson).toJson(QJsonDocument::Indented);
 
-    /* --- write to DB ------------------------------------------- */
-    QSqlQuery q;
-    q.prepare(R"(
-        INSERT INTO experiments (experiment_code, project_code, date_created, data)
-        VALUES (:code, :project, NOW(), :data)
-        ON CONFLICT (experiment_code) DO UPDATE
-          SET date_created = NOW(), data = EXCLUDED.data
-        RETURNING experiment_id)");
-    q.bindValue(":code",    expCode);
-    q.bindValue(":project", expJson["project_code"].toString());
-    q.bindValue(":data",    QString(QJsonDocument(expJson)
-                                     .toJson(QJsonDocument::Compact)));
-
-    if (!q.exec() || !q.next()) {
+    /* --- write experiment + request links (one transaction) ----- */
+    QString err;
+    int expId = -1, version = 0;
+    if (!ExperimentStore::save(expCode, expJson, &lastSavedExperimentJson, lastSavedExperimentVersion,
+                               &expId, &version, &err)) {
         showError(this, tr("Database Error"),
-                  tr("Failed to insert/update experiment:\n%1")
-                      .arg(q.lastError().text()));
+                  tr("Failed to insert/update experiment:\n%1").arg(err));
         return;
     }
-    const int expId = q.value(0).toInt();
-
-    /* --- link experiment to each test request ------------------ */
-    const QJsonArray trArr = expJson["test_requests"].toArray();
-    for (const QJsonValue &v : trArr) {
-        const QString reqId = v.toObject().value("request_id").toString();
-        QSqlQuery link;
-        link.prepare(R"(INSERT INTO experiment_requests (experiment_id, request_id)
-                        VALUES (:eid, :rid)
-                        ON CONFLICT DO NOTHING)");
-        link.bindValue(":eid", expId);
-        link.bindValue(":rid", reqId);
-        if (!link.exec())
-            qWarning() << "Failed to link request" << reqId << ":" << link.lastError();
-    }
 
     showInfo(this, tr("Success"), tr("Experiment saved successfully!"));
-    lastSavedExperimentJson = expJson;
+    setLastSavedExperiment(expJson, expId, version);
+}
+
+
+/* keep the snapshot and its hash together: the hash is computed once per
+   save / load, so dirty checks only hash the current state */
+void TecanWindow::setLastSavedExperiment(const QJsonObject &json, int experimentId, int version)
+{
+    lastSavedExperimentJson    = json;
+    lastSavedExperimentHash    = JsonHash::of(json);
+    lastSavedExperimentId      = experimentId;
+    lastSavedExperimentVersion = version;
 }
 
 
@@ -564,40 +518,60 @@ void TecanWindow::on_actionLoad_triggered()
         return;
     }
 
-    QSqlQuery q;
-    q.prepare("SELECT experiment_code, project_code, data "
-              "FROM   experiments WHERE experiment_id = :id");
-    q.bindValue(":id", expId);
-
-    if (!q.exec() || !q.next()) {
+    // payload is fetched only now, when the experiment is opened
+    ExperimentStore::Payload payload;
+    QString err;
+    if (!ExperimentStore::loadPayload(expId, payload, &err)) {
         showError(this, tr("Error"),
-                  tr("Failed to load experiment:\n%1").arg(q.lastError().text()));
+                  tr("Failed to load experiment:\n%1").arg(err));
         return;
     }
 
-    const QString expCode  = q.value("experiment_code").toString();
-    const QString jsonData = q.value("data").toString();
-
-    const QJsonDocument doc = QJsonDocument::fromJson(jsonData.toUtf8());
-    if (doc.isNull() || !doc.isObject()) {
+    const QString expCode = payload.experimentCode;
+    if (payload.json.isEmpty()) {
         showError(this, tr("Error"),
                   tr("Invalid JSON format in experiment."));
         return;
     }
 
-    lastSavedExperimentJson = doc.object();
-
-    /* ---- restore UI state ---- */
-    loadTestRequestsFromJson(lastSavedExperimentJson["test_requests"].toArray());
-    loadCompoundsFromJson   (lastSavedExperimentJson["compounds"].toArray());
-    loadMatrixPlatesFromJson(lastSavedExperimentJson["matrix_plates"].toObject());
-    loadDaughterPlatesFromJson(lastSavedExperimentJson["daughter_plates"].toArray(),
-                               readOnly);
+    setLastSavedExperiment(payload.json, expId, payload.version);
+    restoreExperimentUi(lastSavedExperimentJson, readOnly);
 
     showInfo(this, tr("Experiment Loaded"),
              tr("Experiment '%1' loaded successfully.").arg(expCode));
 }
 
+/* ---- restore UI state from an experiment payload ---- */
+void TecanWindow::restoreExperimentUi(const QJsonObject &json, bool readOnly)
+{
+    loadTestRequestsFromJson(json["test_requests"].toArray());
+    loadCompoundsFromJson   (json["compounds"].toArray());
+    loadMatrixPlatesFromJson(json["matrix_plates"].toObject());
+    loadDaughterPlatesFromJson(json["daughter_plates"].toArray(),
+                               readOnly);
+}
+
+/* ========================================================================= */
+void TecanWindow::on_actionExperiment_History_triggered()
+{
+    if (lastSavedExperimentId < 0) {
+        showWarning(this, tr("No Experiment"),
+                    tr("Save or load an experiment to see its history."));
+        return;
+    }
+
+    ExperimentHistoryDialog dlg(lastSavedExperimentId,
+                                lastSavedExperimentJson["experiment_code"].toString(), this);
+    if (dlg.exec() != QDialog::Accepted) return;
+
+    // the saved snapshot stays the latest version: saving now records the
+    // restored content as a new version on top of it
+    restoreExperimentUi(dlg.selectedVersionJson(), false);
+    showInfo(this, tr("Version Opened"),
+             tr("Version %1 opened. Save to make it the current version.")
+                 .arg(dlg.selectedVersion()));
+}
+
 /* =========================================================================
  *  JSON → model helpers
  * ========================================================================= */
@@ -676,11 +650,6 @@ void TecanWindow::loadMatrixPlatesFromJson(const QJsonObject &obj)
 void TecanWindow::loadDaughterPlatesFromJson(const QJsonArray &array,
                                              bool readOnly)
 {
-    while (auto *item = daughterPlatesLayout->takeAt(0)) {
-        delete item->widget();
-        delete item;
-    }
-
     /* extract standard info if available */
     QString stdLabel, stdNotes;
     const QJsonObject stdObj = lastSavedExperimentJson["standard"].toObject();
@@ -695,18 +664,25 @@ void TecanWindow::loadDaughterPlatesFromJson(const QJsonArray &array,
         stdNotes = QJsonDocument(stdObj).toJson(QJsonDocument::Indented);
     }
 
+    // one format per experiment: the first plate's (inferred for old files)
+    const DaughterLayoutEngine::Format format = array.isEmpty()
+        ? DaughterLayoutEngine::Format()
+        : DaughterLayoutEngine::formatOfPlate(array.first().toObject());
+    setDaughterFormat(format);
+
+    QVector<DaughterPlateState> plates;
+    plates.reserve(array.size());
     for (int i = 0; i < array.size(); ++i) {
         const QJsonObject plateObj = array[i].toObject();
         const int dilSteps = plateObj.value("dilution_steps").toInt(3);
-
-        auto *plate = new DaughterPlateWidget(i+1, this);
-        plate->fromJson(plateObj["wells"].toObject(), dilSteps);
-
-        if (!readOnly) plate->enableCompoundDragDrop(dilSteps);
-        if (hasStd)    plate->setStandardInfo(stdLabel, stdNotes);
-
-        daughterPlatesLayout->addWidget(plate);
+        plates.append(DaughterPlateState::fromJson(plateObj["wells"].toObject(), dilSteps,
+                                                   format.rows, format.columns));
     }
+
+    daughterLayout      = DaughterLayoutEngine::Layout();   // not made by the engine
+    daughterLayoutNames.clear();
+    daughterPlateList->setStandardInfo(hasStd ? stdLabel : QString(), stdNotes);
+    daughterPlateList->setPlates(plates, /*acceptDrops=*/!readOnly);
 }
 
 /* =======================================================================
@@ -798,34 +774,27 @@ QJsonObject TecanWindow::buildCurrentExperimentJson(const QString &experimentCod
         (dilCol >= 0) ? trModel->index(0, dilCol).data().toInt() : 3;
 
     QJsonArray dghtArray;
-    for (int i = 0; i < daughterPlatesLayout->count(); ++i) {
-        auto *plate = qobject_cast<DaughterPlateWidget *>(
-            daughterPlatesLayout->itemAt(i)->widget());
-        if (!plate) continue;
-
+    for (int i = 0; i < daughterPlateList->plateCount(); ++i) {
+        const DaughterPlateState &plate = daughterPlateList->plate(i);
         QJsonObject plateObj;
         plateObj["plate_number"]   = i + 1;
+        if (plate.rows() != DaughterPlateState::kRows || plate.columns() != DaughterPlateState::kColumns) {
+            plateObj["rows"]       = plate.rows();       // absent = 96 wells, as before
+            plateObj["columns"]    = plate.columns();
+        }
         plateObj["dilution_steps"] = dilutionSteps;
-        plateObj["wells"]          = plate->toJson();
+        plateObj["wells"]          = plate.toJson();
         dghtArray.append(plateObj);
     }
     root["daughter_plates"] = dghtArray;
+    if (daughterFormat.rows * daughterFormat.columns != 96)
+        root["daughter_plate_wells"] = daughterFormat.rows * daughterFormat.columns;
 
     return root;
 }
 
 
 
-// ==== small helpers (file-scope) =========================================
-static inline QString instrumentToString(GWLGenerator::Instrument ins) {
-    return ins == GWLGenerator::Instrument::FLUENT1080 ? "FLUENT1080" : "EVO150";
-}
-static inline GWLGenerator::Instrument instrumentFromString(const QString &s) {
-    return s.compare("FLUENT1080", Qt::CaseInsensitive) == 0
-               ? GWLGenerator::Instrument::FLUENT1080
-               : GWLGenerator::Instrument::EVO150;
-}
-
 /* =======================================================================
  * 1) on_actionGenerate_GWL_triggered()  — with instrument dialog
  * ======================================================================= */
@@ -861,16 +830,23 @@ void TecanWindow::on_actionGenerate_GWL_triggered()
                                     : GWLGenerator::Instrument::EVO150;
 
         QJsonObject json = jsonBase;
-        json["_instrument"] = instrumentToString(instrument); // carry instrument through the pipeline
+        json["_instrument"] = GWLGenerator::instrumentName(instrument); // carry instrument through the pipeline
+        json["_channel_batching"] = dlg.useChannelBatching();
+        json["_optimise_travel"] = dlg.useTravelOptimisation();
+        json["_mca_head"] = dlg.useMcaStamping()
+                                ? GWLGenerator::mcaHeadName(GWLGenerator::McaHead::MCA96)
+                                : QString();
         generateGWLFromJson(json);
     };
 
-    /* 2 – compare order-insensitively ---------------------------------- */
-    if (!jsonEqual(lastSavedExperimentJson, currentJson)) {
+    /* 2 – compare order-insensitively (saved side hashed once) --------- */
+    if (JsonHash::of(currentJson) != lastSavedExperimentHash) {
+        const QStringList changed = JsonHash::changedKeys(lastSavedExperimentJson, currentJson);
         const auto choice = QMessageBox::question(
             this, tr("Experiment Modified"),
-            tr("Changes have been made since last save.\n"
-               "Do you want to overwrite the saved experiment?"),
+            tr("Changes have been made since last save (%1).\n"
+               "Do you want to overwrite the saved experiment?")
+                .arg(changed.join(", ")),
             QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel);
 
         if (choice == QMessageBox::Cancel) return;
@@ -893,119 +869,284 @@ void TecanWindow::generateGWLFromJson(const QJsonObject &experimentJson)
 {
     qDebug() << "[TRACE] generateGWLFromJson()";
 
-    // 0) Instrument selection (defaults to EVO150 if unknown)
-    const auto instrStr  = experimentJson.value("_instrument").toString();
-    const auto instrument = instrumentFromString(instrStr);
-
-    // 1) Determine dilution factor (keep old fallback logic)
-    double dilutionFactor = 3.16;  // default
-    const QJsonArray trArr = experimentJson.value("test_requests").toArray();
-    if (!trArr.isEmpty()) {
-        const auto tr0 = trArr.at(0).toObject();
-        bool ok = false;
-        // NOTE: some JSONs store a number as text here; if it's not numeric we keep 3.16
-        const double df = tr0.value("dilution_steps_unit").toString().toDouble(&ok);
-        if (ok && df > 0.0) dilutionFactor = df;
-    }
-
-    // 2) Extract test ID for volumeMap lookup
-    QString testId;
-    if (!trArr.isEmpty()) {
-        testId = trArr.at(0).toObject().value("requested_tests").toString();
-    }
-
-    // 3) Extract the stock concentration (µM) of the first compound
-    double stockConcMicroM = 0.0;
-    const QJsonArray cmpArr = experimentJson.value("compounds").toArray();
-    if (!cmpArr.isEmpty()) {
-        const auto cmp0  = cmpArr.at(0).toObject();
-        const double sc  = cmp0.value("concentration").toDouble();
-        const QString cu = cmp0.value("concentration_unit").toString();
-        // convert mM → µM
-        stockConcMicroM = (cu.compare("mM", Qt::CaseInsensitive) == 0) ? sc * 1000.0 : sc;
-    }
-
-    // 4) Instantiate the new generator (EVO150/Fluent handled inside)
-    GWLGenerator generator(dilutionFactor, testId, stockConcMicroM, instrument);
-
-    // 5) Generate all files (per-daughter/per-matrix); no master experiment .gwl
-    QVector<GWLGenerator::FileOut> outs;
+    // 1) Generate worklists + aux files, validate and estimate (shared with the CLI).
+    //    Instrument, dilution factor, test ID and stock come from the JSON.
+    GwlJob::Result job;
     QString err;
-    if (!generator.generate(experimentJson, outs, &err)) {
+    if (!GwlJob::run(experimentJson, job, &err)) {
         showError(this, tr("GWL Generation"),
                   tr("Generator error: %1").arg(err));
         qCritical() << "[FATAL] generator.generate:" << err;
         return;
     }
 
-    // 6) Also ask the backend for auxiliary files (plate maps, etc.)
-    if (!generator.generateAuxiliary(experimentJson, outs, &err)) {
-        // Non-fatal; just warn
-        qWarning() << "[WARN] generator.generateAuxiliary:" << err;
+    // 2) Run-time estimate: in the status bar while the user decides, and in
+    //    the validation and final messages
+    const QString runTime = job.runTime.summary();
+    qDebug() << "[TIME]" << runTime;
+    statusBar()->showMessage(runTime);
+
+    // 3) Dry-run result: ask before writing worklists with volume problems
+    qDebug() << "[SIM]" << job.validation.records << "records replayed in"
+             << job.validation.elapsedMs << "ms," << job.validation.violations.size() << "issue(s)";
+    if (!job.validation.ok()) {
+        const auto answer = QMessageBox::question(
+            this, tr("Worklist Validation"),
+            tr("The simulated run found volume problems:\n\n%1\n\n%2\n\nWrite the worklists anyway?")
+                .arg(job.validation.summary(), runTime),
+            QMessageBox::Yes | QMessageBox::No, QMessageBox::No);
+        if (answer != QMessageBox::Yes) return;
     }
 
-    // 7) Choose an output folder (robot expects `dght_0/…`, `dght_1/…` inside)
+    // 4) Choose an output folder (robot expects `dght_0/…`, `dght_1/…` inside)
     const QString defaultDir = QStringLiteral("//Inv_syno_srv/INVENesis/Evo_pc/Fluent/Experiments");
     const QString outDir = QFileDialog::getExistingDirectory(
         this, tr("Select Output Folder"), defaultDir,
         QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks);
     if (outDir.isEmpty()) return; // user cancelled
 
-    // 8) Write everything (saveMany creates subfolders as needed)
-    if (!GWLGenerator::saveMany(outDir, outs, &err)) {
+    // 5) Write everything (saveMany creates subfolders as needed)
+    if (!GWLGenerator::saveMany(outDir, job.outs, &err)) {
         showError(this, tr("File Error"),
                   tr("Failed to write files:\n%1").arg(err));
         return;
     }
 
-    // 9) Done
+    // 6) Done
     showInfo(this, tr("Success"),
-             tr("Files written to:\n%1").arg(outDir));
+             tr("Files written to:\n%1\n\n%2").arg(outDir, runTime));
 }
 
 /* =======================================================================
- * 3) generateExperimentAuxiliaryFiles() — thin wrapper to backend
+ * 2b) on_actionBatch_Generate_GWL_triggered() — many saved experiments
  * ======================================================================= */
-void TecanWindow::generateExperimentAuxiliaryFiles(const QJsonObject &exp,
-                                                   const QString     &outputFolder)
+void TecanWindow::on_actionBatch_Generate_GWL_triggered()
 {
-    qDebug() << "[TRACE] generateExperimentAuxiliaryFiles() to" << outputFolder;
+    LoadExperimentDialog pick(this);
+    pick.setMultiSelection(true);
+    if (pick.exec() != QDialog::Accepted) return;
 
-    // Instrument (defaults to EVO150 if missing)
-    const auto instrStr   = exp.value("_instrument").toString();
-    const auto instrument = instrumentFromString(instrStr);
-
-    // Dilution factor (same fallback as above)
-    double dilutionFactor = 3.16;
-    const QJsonArray trArr = exp.value("test_requests").toArray();
-    if (!trArr.isEmpty()) {
-        const auto tr0 = trArr.at(0).toObject();
-        bool ok = false;
-        const double df = tr0.value("dilution_steps_unit").toString().toDouble(&ok);
-        if (ok && df > 0.0) dilutionFactor = df;
+    const QList<int> ids = pick.selectedExperimentIds();
+    if (ids.isEmpty()) {
+        showWarning(this, tr("No Selection"),
+                    tr("Please select at least one experiment."));
+        return;
     }
 
-    // Test ID
-    QString testId;
-    if (!trArr.isEmpty()) {
-        testId = trArr.at(0).toObject().value("requested_tests").toString();
+    // Same instrument / option choice as single generation, applied to all
+    GenerateGwlDialog dlg(this);
+    if (dlg.exec() != QDialog::Accepted) return;
+    const auto instrument = dlg.useFluent() ? GWLGenerator::Instrument::FLUENT1080
+                                            : GWLGenerator::Instrument::EVO150;
+    QJsonObject overrides;
+    overrides["_instrument"]       = GWLGenerator::instrumentName(instrument);
+    overrides["_channel_batching"] = dlg.useChannelBatching();
+    overrides["_optimise_travel"]  = dlg.useTravelOptimisation();
+    overrides["_mca_head"]         = dlg.useMcaStamping()
+                                         ? GWLGenerator::mcaHeadName(GWLGenerator::McaHead::MCA96)
+                                         : QString();
+
+    QVector<ExperimentStore::Payload> payloads;
+    QString err;
+    if (!ExperimentStore::loadPayloads(ids, payloads, &err)) {
+        showError(this, tr("Database Error"), err);
+        return;
     }
+    QVector<BatchGenerator::Input> inputs;
+    inputs.reserve(payloads.size());
+    for (const auto &p : std::as_const(payloads))
+        inputs.push_back({ p.experimentId, p.experimentCode, p.json });   // empty JSON is reported per item
+
+    const QString defaultDir = QStringLiteral("//Inv_syno_srv/INVENesis/Evo_pc/Fluent/Experiments");
+    const QString rootDir = QFileDialog::getExistingDirectory(
+        this, tr("Select Batch Output Folder"), defaultDir,
+        QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks);
+    if (rootDir.isEmpty()) return;
+
+    // runs in the background; the window stays usable and the batch can be cancelled
+    auto *batch    = new BatchGenerator(this);
+    auto *progress = new QProgressDialog(tr("Generating worklists…"), tr("Cancel"),
+                                         0, inputs.size(), this);
+    progress->setWindowTitle(tr("Batch Generation"));
+    progress->setWindowModality(Qt::WindowModal);
+    progress->setMinimumDuration(0);
+    progress->setAutoClose(false);
+    progress->setAutoReset(false);
+    batch->setOverrides(overrides);
+
+    connect(progress, &QProgressDialog::canceled, batch, [batch, progress] {
+        progress->setLabelText(tr("Cancelling, waiting for running experiments…"));
+        batch->cancel();
+    });
+    connect(batch, &BatchGenerator::itemFinished, progress,
+            [progress](int done, int total, const BatchGenerator::Item &item) {
+        progress->setValue(done);
+        progress->setLabelText(tr("%1 of %2 done (last: %3)").arg(done).arg(total)
+                                   .arg(item.experimentCode));
+    });
+    connect(batch, &BatchGenerator::finished, this,
+            [this, batch, progress, rootDir](const BatchGenerator::Summary &summary) {
+        progress->deleteLater();
+        batch->deleteLater();
+
+        qDebug() << "[BATCH]" << summary.succeeded() << "/" << summary.items.size()
+                 << "in" << summary.elapsedMs << "ms";
+        statusBar()->showMessage(tr("Batch: %1 of %2 experiment(s) generated")
+                                     .arg(summary.succeeded()).arg(summary.items.size()));
+
+        const QString text = summary.text()
+                           + tr("\n\nSummary written to %1").arg(QDir(rootDir).filePath("batch_summary.csv"));
+        if (summary.succeeded() == summary.items.size())
+            showInfo(this, tr("Batch Generation"), text);
+        else
+            showWarning(this, tr("Batch Generation"), text);
+    });
+
+    progress->show();
+    batch->start(inputs, rootDir);
+}
 
-    // Stock concentration (µM)
-    double stockConcMicroM = 0.0;
-    const QJsonArray cmpArr = exp.value("compounds").toArray();
-    if (!cmpArr.isEmpty()) {
-        const auto cmp0  = cmpArr.at(0).toObject();
-        const double sc  = cmp0.value("concentration").toDouble();
-        const QString cu = cmp0.value("concentration_unit").toString();
-        stockConcMicroM = (cu.compare("mM", Qt::CaseInsensitive) == 0) ? sc * 1000.0 : sc;
+/* =======================================================================
+ * 2c) on_actionReformat_Plates_triggered() — 96 / 384 ➜ 384 / 1536 compression
+ * ======================================================================= */
+void TecanWindow::on_actionReformat_Plates_triggered()
+{
+    if (daughterPlateList->plateCount() == 0) {
+        showWarning(this, tr("No Daughter Plates"),
+                    tr("Lay out the daughter plates before reformatting them."));
+        return;
+    }
+
+    const PlateReformatter::Format source{ daughterPlateList->plate(0).rows(),
+                                          daughterPlateList->plate(0).columns() };
+    QStringList targets;
+    if (source.rows * source.columns == 96)
+        targets << tr("384 wells (4 daughter plates each)")
+                << tr("1536 wells (16 daughter plates each)");
+    else if (source.rows * source.columns == 384)
+        targets << tr("1536 wells (4 daughter plates each)");
+    else {
+        showWarning(this, tr("Reformat Daughter Plates"),
+                    tr("%1-well daughter plates cannot be compressed further.")
+                        .arg(source.rows * source.columns));
+        return;
+    }
+
+    bool ok = false;
+    const int target = targets.indexOf(QInputDialog::getItem(
+        this, tr("Reformat Daughter Plates"), tr("Compress into:"), targets, 0, false, &ok));
+    if (!ok || target < 0) return;
+
+    const QStringList modes = { tr("Interleaved quadrants, MCA 96 stamping"),
+                                tr("Interleaved quadrants, single tips"),
+                                tr("Quadrant blocks, single tips") };
+    const int mode = modes.indexOf(QInputDialog::getItem(
+        this, tr("Reformat Daughter Plates"), tr("Mapping:"), modes, 0, false, &ok));
+    if (!ok || mode < 0) return;
+
+    const double volume = QInputDialog::getDouble(
+        this, tr("Reformat Daughter Plates"), tr("Volume per well (µL):"), 1.0, 0.1, 200.0, 1, &ok);
+    if (!ok) return;
+
+    // 96 ➜ 384, then 384 ➜ 1536 composed into one table
+    const auto plateMode = mode == 2 ? PlateReformatter::Blocks : PlateReformatter::Interleaved;
+    PlateReformatter::Plan plan;
+    QString err;
+    bool planned = PlateReformatter::plan(source, plateMode, plan, &err);
+    if (planned && target == 1) {
+        PlateReformatter::Plan second;
+        planned = PlateReformatter::plan(plan.destination, plateMode, second, &err)
+               && PlateReformatter::compose(plan, second, plan, &err);
+    }
+    if (!planned) {
+        showError(this, tr("Reformat Daughter Plates"), err);
+        return;
     }
 
-    // Delegate to backend
-    GWLGenerator generator(dilutionFactor, testId, stockConcMicroM, instrument);
+    QJsonArray sources;
+    QVector<QVector<bool>> used;
+    for (int i = 0; i < daughterPlateList->plateCount(); ++i) {
+        const QJsonObject wells = daughterPlateList->plate(i).toJson();
+        QVector<bool> u(plan.sourceWells(), false);
+        for (auto it = wells.constBegin(); it != wells.constEnd(); ++it) {
+            int r = 0, c = 0;
+            if (!it.value().toString().isEmpty() && DaughterLayoutEngine::parseWell(it.key(), r, c)
+                && r < plan.source.rows && c < plan.source.columns)
+                u[r * plan.source.columns + c] = true;
+        }
+        used.push_back(u);
+
+        QJsonObject plateObj;
+        plateObj["plate_number"] = i + 1;
+        plateObj["wells"]        = wells;
+        sources.append(plateObj);
+    }
+
+    QJsonArray destination;
+    if (!PlateReformatter::reformatPlates(plan, sources, destination, &err)) {
+        showError(this, tr("Reformat Daughter Plates"), err);
+        return;
+    }
+
+    PlateReformatter::TransferOptions opts;
+    opts.volumeUL         = volume;
+    opts.destinationLabel = QString("Plate%1").arg(plan.destinationWells());
+    opts.mca96            = (mode == 0);
+    QStringList lines;
+    QString note;
+    if (!PlateReformatter::worklist(plan, used, opts, lines, &err)) {
+        if (!opts.mca96) {
+            showError(this, tr("Reformat Daughter Plates"), err);
+            return;
+        }
+        note = tr("\n\n%1 Single tips were used instead.").arg(err);
+        opts.mca96 = false;
+        if (!PlateReformatter::worklist(plan, used, opts, lines, &err)) {
+            showError(this, tr("Reformat Daughter Plates"), err);
+            return;
+        }
+    }
+
+    const QString outDir = QFileDialog::getExistingDirectory(
+        this, tr("Select Output Folder"),
+        QStringLiteral("//Inv_syno_srv/INVENesis/Evo_pc/Fluent/Experiments"),
+        QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks);
+    if (outDir.isEmpty()) return;
+
+    QVector<GWLGenerator::FileOut> outs(2);
+    outs[0].relativePath = QString("reformat/Reformat_%1.gwl").arg(plan.destinationWells());
+    outs[0].lines        = lines;
+    outs[1].relativePath = QString("reformat/plates_%1.json").arg(plan.destinationWells());
+    outs[1].lines        = QString::fromUtf8(QJsonDocument(destination).toJson(QJsonDocument::Indented))
+                               .split('\n', Qt::SkipEmptyParts);
+    outs[1].isAux        = true;
+    if (!GWLGenerator::saveMany(outDir, outs, &err)) {
+        showError(this, tr("File Error"), tr("Failed to write files:\n%1").arg(err));
+        return;
+    }
+
+    const int transfers = int(std::count_if(lines.cbegin(), lines.cend(),
+                                            [](const QString &l) { return l.startsWith("A;"); }));
+    showInfo(this, tr("Reformat Daughter Plates"),
+             tr("%1 daughter plate(s) ➜ %2 plate(s) of %3 wells, %4 transfer(s).\n"
+                "Files written to:\n%5%6")
+                 .arg(sources.size()).arg(destination.size()).arg(plan.destinationWells())
+                 .arg(transfers).arg(QDir(outDir).filePath("reformat"), note));
+}
+
+/* =======================================================================
+ * 3) generateExperimentAuxiliaryFiles() — thin wrapper to backend
+ * ======================================================================= */
+void TecanWindow::generateExperimentAuxiliaryFiles(const QJsonObject &exp,
+                                                   const QString     &outputFolder)
+{
+    qDebug() << "[TRACE] generateExperimentAuxiliaryFiles() to" << outputFolder;
+
+    // Same parameter derivation as the worklists (instrument defaults to FLUENT1080)
+    const auto generator = GWLGenerator::forExperiment(exp);
     QVector<GWLGenerator::FileOut> aux;
     QString err;
-    if (!generator.generateAuxiliary(exp, aux, &err)) {
+    if (!generator->generateAuxiliary(exp, aux, &err)) {
         qWarning() << "[WARN] generateAuxiliary:" << err;
         return;
     }
@@ -12,12 +12,15 @@
 #include <QSet>
 #include <memory>          // std::unique_ptr
 #include "plate_management/matrixplatecontainer.h"
+#include "jsonhash.h"
+#include "daughterlayout.h"
 
 QT_BEGIN_NAMESPACE
 class QSqlQueryModel;
-class QVBoxLayout;
 QT_END_NAMESPACE
 
+class DaughterPlateList;
+
 namespace Ui { class TecanWindow; }
 
 /**
@@ -38,9 +41,13 @@ public:
 
 private slots:
     void on_clearPlatesButton_clicked();
+    void on_daughterFormatComboBox_currentIndexChanged(int index);
     void on_actionSave_triggered();
     void on_actionLoad_triggered();
     void on_actionGenerate_GWL_triggered();
+    void on_actionBatch_Generate_GWL_triggered();
+    void on_actionReformat_Plates_triggered();
+    void on_actionExperiment_History_triggered();
 
     void on_actionCreate_Plate_Map_triggered();
 
@@ -54,11 +61,18 @@ private:            /* ---------- helper GUI ----------
     SqlModelPtr            compoundQueryModel;
 
     MatrixPlateContainer  *matrixPlateContainer = nullptr;
-    QWidget               *daughterPlatesContainerWidget = nullptr;
-    QVBoxLayout           *daughterPlatesLayout = nullptr;
+    DaughterPlateList     *daughterPlateList = nullptr;
+    DaughterLayoutEngine::Layout daughterLayout;        // what the plates were laid out from,
+    QStringList            daughterLayoutNames;        // so a change only touches moved chains
+    DaughterLayoutEngine::Format daughterFormat;        // 96 / 384 / 1536 wells
 
     /* ---------- cached state ---------- */
     QJsonObject            lastSavedExperimentJson;
+    JsonHash               lastSavedExperimentHash;    // hash of the above, see setLastSavedExperiment()
+    int                    lastSavedExperimentId = -1;
+    int                    lastSavedExperimentVersion = 0;   // its experiment_versions.version
+
+    void setLastSavedExperiment(const QJsonObject &json, int experimentId, int version);
 
 private:            /* ---------- query helpers ---------- */
     void querySolutionsFromTestRequests();
@@ -71,12 +85,17 @@ private:            /* ---------- plate helpers ---------- */
     void populateDaughterPlates(int dilutionSteps,
                                 const QStringList& compoundList,
                                 const QString& testType);
+    void applyDaughterLayout(const DaughterLayoutEngine::Layout &layout,
+                             const QStringList &names);
+    QVector<QVector<quint64>> handPlacedWells() const;   // not from daughterLayout
+    void setDaughterFormat(const DaughterLayoutEngine::Format &format);   // without relayout
 
     /* ------ JSON (de)serialisation helpers ------ */
     void loadTestRequestsFromJson(const QJsonArray &array);
     void loadCompoundsFromJson(const QJsonArray &array);
     void loadMatrixPlatesFromJson(const QJsonObject &obj);
     void loadDaughterPlatesFromJson(const QJsonArray &array, bool readOnly);
+    void restoreExperimentUi(const QJsonObject &json, bool readOnly);
 
     QJsonObject buildCurrentExperimentJson(const QString &experimentCode,
                                            const QString &username);
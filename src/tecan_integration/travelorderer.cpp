@@ -0,0 +1,85 @@
+#include "travelorderer.h"
+
+#include <algorithm>
+
+TravelOrderer::TravelOrderer(const DeckLayout &deck)
+    : deck_(deck)
+{
+}
+
+TravelOrderer::Job TravelOrderer::job(const QString &srcLabel, int srcPos,
+                                      const QString &dstLabel, int dstPos) const
+{
+    return Job{ deck_.wellPosition(srcLabel, srcPos),
+                deck_.wellPosition(dstLabel, dstPos) };
+}
+
+QVector<int> TravelOrderer::order(const QVector<Job> &jobs, const QPointF &from) const
+{
+    const int n = jobs.size();
+    QVector<int> ord;
+    ord.reserve(n);
+    if (n == 0) return ord;
+
+    // 1) nearest neighbour (ties keep the incoming order)
+    QVector<bool> used(n, false);
+    QPointF at = from;
+    for (int k = 0; k < n; ++k) {
+        int best = -1;
+        double bestD = 0.0;
+        for (int j = 0; j < n; ++j) {
+            if (used[j]) continue;
+            const double d = DeckLayout::distance(at, jobs[j].start);
+            if (best < 0 || d < bestD - 1e-9) { best = j; bestD = d; }
+        }
+        used[best] = true;
+        ord.push_back(best);
+        at = jobs[best].end;
+    }
+
+    // 2) 2-opt: reverse the visiting order of ord[i..j] when that shortens
+    //    the open path. Jobs are directed, so the edges inside the segment
+    //    are re-costed in the reverse direction.
+    auto cost = [&](int a, int b) {
+        return DeckLayout::distance(jobs[a].end, jobs[b].start);
+    };
+    auto costFrom = [&](int b) {
+        return DeckLayout::distance(from, jobs[b].start);
+    };
+
+    for (int pass = 0; pass < maxPasses_; ++pass) {
+        bool improved = false;
+        for (int i = 0; i + 1 < n; ++i) {
+            const double inEdge = (i == 0) ? costFrom(ord[i]) : cost(ord[i - 1], ord[i]);
+            double inner = 0.0, innerRev = 0.0;
+            for (int j = i + 1; j < n; ++j) {
+                inner    += cost(ord[j - 1], ord[j]);
+                innerRev += cost(ord[j], ord[j - 1]);
+
+                const double outEdge = (j + 1 < n) ? cost(ord[j], ord[j + 1]) : 0.0;
+                const double newIn   = (i == 0) ? costFrom(ord[j]) : cost(ord[i - 1], ord[j]);
+                const double newOut  = (j + 1 < n) ? cost(ord[i], ord[j + 1]) : 0.0;
+
+                if (newIn + innerRev + newOut < inEdge + inner + outEdge - 1e-6) {
+                    std::reverse(ord.begin() + i, ord.begin() + j + 1);
+                    improved = true;
+                    break;
+                }
+            }
+        }
+        if (!improved) break;
+    }
+    return ord;
+}
+
+double TravelOrderer::pathLength(const QVector<Job> &jobs, const QVector<int> &order,
+                                 const QPointF &from)
+{
+    double len = 0.0;
+    QPointF at = from;
+    for (int i : order) {
+        len += DeckLayout::distance(at, jobs[i].start);
+        at = jobs[i].end;
+    }
+    return len;
+}
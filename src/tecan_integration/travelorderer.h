@@ -0,0 +1,54 @@
+#ifndef TRAVELORDERER_H
+#define TRAVELORDERER_H
+
+#include <QPointF>
+#include <QString>
+#include <QVector>
+
+#include "decklayout.h"
+
+/**
+ * Orders independent pipetting jobs so the arm travels as little as
+ * possible between them.
+ *
+ * A job is entered at its start point and left at its end point (aspirate
+ * well -> last dispense well); the steps inside a job, e.g. the transfers
+ * of one dilution chain, keep their order. The tour is built nearest
+ * neighbour first and then improved with 2-opt segment reversals.
+ */
+class TravelOrderer
+{
+public:
+    struct Job {
+        QPointF start;
+        QPointF end;
+    };
+
+    explicit TravelOrderer(const DeckLayout &deck = DeckLayout::fluentDefault());
+
+    const DeckLayout &deck() const { return deck_; }
+
+    Job job(const QString &srcLabel, int srcPos,
+            const QString &dstLabel, int dstPos) const;
+
+    /** Visiting order (indices into jobs), arm starting at `from`. */
+    QVector<int> order(const QVector<Job> &jobs, const QPointF &from = QPointF()) const;
+
+    static double pathLength(const QVector<Job> &jobs, const QVector<int> &order,
+                             const QPointF &from = QPointF());
+
+    template <typename T>
+    static QVector<T> permuted(const QVector<T> &items, const QVector<int> &order)
+    {
+        QVector<T> out;
+        out.reserve(order.size());
+        for (int i : order) out.push_back(items.at(i));
+        return out;
+    }
+
+private:
+    DeckLayout deck_;
+    int        maxPasses_ = 25;
+};
+
+#endif // TRAVELORDERER_H
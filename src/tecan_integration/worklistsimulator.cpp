@@ -0,0 +1,296 @@
+#include "worklistsimulator.h"
+#include "daughterlayout.h"
+#include "gwlrecord.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMap>
+#include <QObject>
+#include <QPair>
+
+namespace {
+
+constexpr double kEps = 1e-6;
+
+// "A01"/"a1" -> 1..96 column-major (same numbering as the Fluent backend)
+int wellToPos96(const QString &well)
+{
+    const QString t = well.trimmed().toUpper();
+    if (t.size() < 2) return -1;
+    const int row = t.at(0).unicode() - 'A';
+    bool ok = false;
+    const int col = t.mid(1).toInt(&ok);
+    if (!ok || row < 0 || row > 7 || col < 1 || col > 12) return -1;
+    return (col - 1) * 8 + row + 1;
+}
+
+bool isMicroLitre(const QString &unit)
+{
+    const QString u = unit.trimmed().toLower();
+    return u == "ul" || u == QStringLiteral("µl") || u == "microliter" || u.isEmpty();
+}
+
+double readNumber(const QJsonValue &v)
+{
+    if (v.isString()) return v.toString().toDouble();
+    return v.toDouble();
+}
+
+} // namespace
+
+WorklistSimulator::WorklistSimulator()
+{
+    tipCapacity_.insert(7, 50.0);     // S;7  -> 50 µL tips
+    tipCapacity_.insert(19, 350.0);   // S;19 -> 350 µL tips
+}
+
+void WorklistSimulator::setLabware(const QString &label, const Labware &labware)
+{
+    labware_.insert(label, labware);
+}
+
+QString WorklistSimulator::physicalLabel(const QString &relativePath, const QString &label)
+{
+    if (label.startsWith(QLatin1String("Matrix[")))
+        return QStringLiteral("Matrix:") + QFileInfo(relativePath).completeBaseName();
+    return label;
+}
+
+WorklistSimulator WorklistSimulator::fromExperiment(const QJsonObject &exp)
+{
+    WorklistSimulator sim;
+
+    Labware unlimited;
+    unlimited.unlimited = true;
+    sim.setLabware(QStringLiteral("100ml_Higher"), unlimited);
+    sim.setLabware(QStringLiteral("Standard_Matrix"), unlimited);
+
+    // Daughter and assay plates share the daughter format (96/384/1536)
+    const QJsonArray plates = exp.value("daughter_plates").toArray();
+    if (!plates.isEmpty()) {
+        const auto fmt = DaughterLayoutEngine::formatOfPlate(plates.first().toObject());
+        Labware plate;
+        plate.rows  = fmt.rows;
+        plate.wells = fmt.rows * fmt.columns;
+        plate.capacityUL = DaughterLayoutEngine::wellCapacityUL(fmt);
+        sim.setDefaultLabware(plate);
+    }
+
+    // Matrix racks: tubes start with their listed volume; racks with a
+    // non-volume unit (mg…) or no volume cannot be checked and are treated
+    // as unlimited.
+    QHash<QString, Labware> racks;
+    for (const QJsonValue &v : exp.value("compounds").toArray()) {
+        const QJsonObject o  = v.toObject();
+        const QString bc     = o.value("container_id").toString().trimmed();
+        const int     pos    = wellToPos96(o.value("well_id").toString());
+        if (bc.isEmpty() || pos < 1) continue;
+
+        Labware &rack = racks[bc];
+        rack.capacityUL = 1000.0;
+        const double vol = readNumber(o.value("weight"));
+        if (!isMicroLitre(o.value("weight_unit").toString()) || vol <= 0.0)
+            rack.unlimited = true;
+        else
+            rack.initialByPos.insert(pos, vol);
+    }
+    for (auto it = racks.cbegin(); it != racks.cend(); ++it)
+        sim.setLabware(QStringLiteral("Matrix:") + it.key(), it.value());
+
+    return sim;
+}
+
+WorklistSimulator::Report
+WorklistSimulator::run(const QVector<GWLGenerator::FileOut> &outs) const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    Report rep;
+
+    struct State {
+        Labware         lw;
+        QVector<double> vol;     // index = position
+    };
+    QHash<QString, int> stateIdx;
+    QVector<State>      states;
+
+    auto stateFor = [&](const QString &key) -> State & {
+        auto it = stateIdx.constFind(key);
+        if (it != stateIdx.cend()) return states[it.value()];
+
+        State st;
+        if (labware_.contains(key))
+            st.lw = labware_.value(key);
+        else if (key.startsWith(QLatin1String("Matrix:")))
+            st.lw.unlimited = true;      // rack not described by the experiment
+        else
+            st.lw = defaultLabware_;
+
+        st.vol.fill(st.lw.initialUL, st.lw.wells + 1);
+        for (auto p = st.lw.initialByPos.cbegin(); p != st.lw.initialByPos.cend(); ++p)
+            if (p.key() >= 1 && p.key() <= st.lw.wells) st.vol[p.key()] = p.value();
+
+        stateIdx.insert(key, states.size());
+        states.push_back(std::move(st));
+        return states.last();
+    };
+
+    QMap<QPair<QString,int>, SourceTotal> totals;
+
+    for (const auto &fo : outs) {
+        if (fo.isAux || !fo.relativePath.endsWith(QLatin1String(".gwl"), Qt::CaseInsensitive))
+            continue;
+
+        double tips[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        double tipCap  = 0.0;             // 0 = unknown tip type, no check
+
+        auto flag = [&](int lineNo, const QString &msg) {
+            rep.violations.push_back(Violation{ fo.relativePath, lineNo, msg });
+        };
+
+        GwlRecord rec;
+        for (int li = 0; li < fo.lines.size(); ++li) {
+            if (!GwlRecord::parse(fo.lines.at(li), rec)) continue;
+            ++rep.records;
+            const int lineNo = li + 1;
+
+            switch (rec.kind) {
+            case GwlRecord::TipType:
+                tipCap = tipCapacity_.value(rec.tipType, 0.0);
+                continue;
+            case GwlRecord::Wash:
+                std::fill(std::begin(tips), std::end(tips), 0.0);
+                continue;
+            case GwlRecord::Aspirate:
+            case GwlRecord::Dispense:
+                break;
+            default:
+                continue;
+            }
+
+            const QString key = physicalLabel(fo.relativePath, rec.label);
+            State &st = stateFor(key);
+
+            // wells touched by this record: one for the LiHa; for the MCA the
+            // head rows x the head columns in its tip mask, every stride-th
+            // row and column from the position on a plate denser than the head
+            QVector<int> touched;
+            bool outside = (rec.position < 1);
+            if (!rec.isMca()) {
+                touched << rec.position;
+                outside = outside || rec.position > st.lw.wells;
+            } else {
+                const int rows   = qMax(1, st.lw.rows);
+                const int cols   = qMax(1, st.lw.wells / rows);
+                const int stride = qMax(1, rows / rec.mcaRows());
+                const int r0 = (rec.position - 1) % rows;
+                const int c0 = (rec.position - 1) / rows;
+                const int nr = qMin(rec.mcaRows(), rows);
+                const int nc = rec.mcaColumns();
+                for (int j = 0; j < nc; ++j)
+                    for (int i = 0; i < nr; ++i) {
+                        const int r = r0 + i * stride, c = c0 + j * stride;
+                        if (r >= rows || c >= cols) outside = true;
+                        touched << c * rows + r + 1;
+                    }
+            }
+
+            if (!st.lw.unlimited && outside) {
+                flag(lineNo, QObject::tr("Position %1 outside %2 (%3 wells)")
+                                 .arg(rec.position).arg(key).arg(st.lw.wells));
+                continue;
+            }
+
+            // tips used by this record (MCA: all tips behave like tip 1)
+            const double cap = rec.isMca() ? mcaTipCapacity_ : tipCap;
+            const int mask   = (!rec.isMca() && rec.tipMask > 0) ? rec.tipMask : 1;
+
+            if (rec.kind == GwlRecord::Aspirate) {
+                for (int ch = 0; ch < 8; ++ch) {
+                    if (!(mask & (1 << ch))) continue;
+                    tips[ch] += rec.volumeUL;
+                    if (cap > 0.0 && tips[ch] > cap + kEps)
+                        flag(lineNo, QObject::tr("Tip %1 loaded with %2 uL, capacity %3 uL")
+                                         .arg(ch + 1).arg(tips[ch], 0, 'f', 1).arg(cap, 0, 'f', 1));
+                }
+
+                if (st.lw.unlimited) {
+                    SourceTotal &t = totals[qMakePair(key, rec.position)];
+                    t.labware = key; t.position = rec.position;
+                    t.aspiratedUL += rec.volumeUL * touched.size();
+                    ++t.aspirates;
+                    continue;
+                }
+                for (int p : std::as_const(touched)) {
+                    const double before = st.vol[p];
+                    st.vol[p] -= rec.volumeUL;
+                    if (st.vol[p] < -kEps)
+                        flag(lineNo, QObject::tr("Aspirate %1 uL from %2 pos %3 holding %4 uL")
+                                         .arg(rec.volumeUL, 0, 'f', 1).arg(key).arg(p)
+                                         .arg(before, 0, 'f', 1));
+                    SourceTotal &t = totals[qMakePair(key, p)];
+                    t.labware = key; t.position = p;
+                    t.aspiratedUL += rec.volumeUL;
+                    ++t.aspirates;
+                }
+            } else {
+                for (int ch = 0; ch < 8; ++ch) {
+                    if (!(mask & (1 << ch))) continue;
+                    if (tips[ch] + kEps < rec.volumeUL)
+                        flag(lineNo, QObject::tr("Tip %1 dispenses %2 uL but holds %3 uL")
+                                         .arg(ch + 1).arg(rec.volumeUL, 0, 'f', 1)
+                                         .arg(tips[ch], 0, 'f', 1));
+                    tips[ch] = std::max(0.0, tips[ch] - rec.volumeUL);
+                }
+
+                if (st.lw.unlimited) continue;
+                for (int p : std::as_const(touched)) {
+                    st.vol[p] += rec.volumeUL;
+                    if (st.vol[p] > st.lw.capacityUL + kEps)
+                        flag(lineNo, QObject::tr("%1 pos %2 overfilled: %3 uL, capacity %4 uL")
+                                         .arg(key).arg(p).arg(st.vol[p], 0, 'f', 1)
+                                         .arg(st.lw.capacityUL, 0, 'f', 1));
+                }
+            }
+        }
+    }
+
+    rep.sources.reserve(totals.size());
+    for (auto it = totals.cbegin(); it != totals.cend(); ++it)
+        rep.sources.push_back(it.value());
+
+    rep.elapsedMs = timer.nsecsElapsed() / 1.0e6;
+    return rep;
+}
+
+QString WorklistSimulator::Report::summary(int maxLines) const
+{
+    QString s = QObject::tr("%1 records replayed in %2 ms; %3 issue(s).")
+                    .arg(records).arg(elapsedMs, 0, 'f', 2).arg(violations.size());
+    for (int i = 0; i < violations.size() && i < maxLines; ++i) {
+        const auto &v = violations.at(i);
+        s += QString("\n- %1:%2  %3").arg(v.file).arg(v.line).arg(v.message);
+    }
+    if (violations.size() > maxLines)
+        s += QObject::tr("\n… and %1 more").arg(violations.size() - maxLines);
+    return s;
+}
+
+QStringList WorklistSimulator::Report::toCsv() const
+{
+    QStringList L;
+    L << "Type,File_or_Labware,Line_or_Position,Volume_uL,Detail";
+    for (const auto &v : violations)
+        L << QString("violation,%1,%2,,%3").arg(v.file).arg(v.line).arg(QString(v.message).replace(',', ';'));
+    for (const auto &s : sources)
+        L << QString("source,%1,%2,%3,%4 aspirate(s)")
+                 .arg(s.labware).arg(s.position)
+                 .arg(QString::number(s.aspiratedUL, 'f', 1)).arg(s.aspirates);
+    return L;
+}
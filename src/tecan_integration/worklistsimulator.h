@@ -0,0 +1,84 @@
+#ifndef WORKLISTSIMULATOR_H
+#define WORKLISTSIMULATOR_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "gwlgenerator.h"
+
+/**
+ * Replays generated worklists (A;/D;/W; records) against a deck model and
+ * tracks the volume of every well, tube and tip.
+ *
+ * Flags dispenses into overfilled wells, aspirates from under-filled wells
+ * or tubes, tip loads above the tip capacity and dispenses that exceed what
+ * the tip holds. Files are replayed in the order of the output vector, which
+ * is the order the robot runs them (auxiliary files are skipped). MCA
+ * records (head named in the tip type field) touch the head footprint; on a
+ * plate denser than the head that is every 2nd or 4th row and column from
+ * the record position.
+ */
+class WorklistSimulator
+{
+public:
+    struct Labware {
+        int    wells      = 96;
+        int    rows       = 8;            // column-major positions per column
+        double capacityUL = 300.0;        // per well
+        double initialUL  = 0.0;          // per well unless overridden
+        bool   unlimited  = false;        // troughs, unknown sources
+        QHash<int,double> initialByPos;   // position -> start volume
+    };
+
+    struct Violation {
+        QString file;
+        int     line = 0;                 // 1-based
+        QString message;
+    };
+
+    struct SourceTotal {
+        QString labware;
+        int     position   = 0;
+        double  aspiratedUL = 0.0;
+        int     aspirates  = 0;
+    };
+
+    struct Report {
+        QVector<Violation>   violations;
+        QVector<SourceTotal> sources;     // sorted by labware, position
+        int    records   = 0;
+        double elapsedMs = 0.0;
+
+        bool ok() const { return violations.isEmpty(); }
+        QString summary(int maxLines = 10) const;
+        QStringList toCsv() const;
+    };
+
+    WorklistSimulator();
+
+    /** Deck model for one experiment: matrix tubes start with their listed
+        volume, daughter/assay plates empty and in the daughter format, the
+        DMSO trough unlimited. */
+    static WorklistSimulator fromExperiment(const QJsonObject &experimentJson);
+
+    void setLabware(const QString &label, const Labware &labware);
+    void setDefaultLabware(const Labware &labware) { defaultLabware_ = labware; }
+    void setTipCapacity(int tipType, double capacityUL) { tipCapacity_[tipType] = capacityUL; }
+    void setMcaTipCapacity(double capacityUL) { mcaTipCapacity_ = capacityUL; }
+
+    Report run(const QVector<GWLGenerator::FileOut> &outs) const;
+
+    /** Labware key for a record label: matrix racks are resolved through the
+        worklist file name (dght_N/<barcode>.gwl), everything else by label. */
+    static QString physicalLabel(const QString &relativePath, const QString &label);
+
+private:
+    QHash<QString, Labware> labware_;
+    Labware                 defaultLabware_;
+    QHash<int, double>      tipCapacity_;
+    double                  mcaTipCapacity_ = 125.0;
+};
+
+#endif // WORKLISTSIMULATOR_H
@@ -1,36 +1,56 @@
 #include "loadexperimentdialog.h"
 #include "ui_loadexperimentdialog.h"
-#include <QSqlQuery>
-#include <QSqlError>
+#include <QDate>
 #include <QMessageBox>
+#include <QScrollBar>
+#include <QStandardItemModel>
+#include <QTimer>
 
 LoadExperimentDialog::LoadExperimentDialog(QWidget *parent) :
     QDialog(parent),
     ui(new Ui::LoadExperimentDialog),
-    experimentModel(new QSqlQueryModel(this))
+    experimentModel(new QStandardItemModel(this)),
+    debounceTimer(new QTimer(this))
 {
     ui->setupUi(this);
     setWindowTitle("Load Experiment");
 
-    // Load experiment list
-    experimentModel->setQuery(R"(
-        SELECT experiment_id, experiment_code, project_code, date_created, user
-        FROM experiments
-        ORDER BY date_created DESC
-    )");
-
-    if (experimentModel->lastError().isValid()) {
-        QMessageBox::critical(this, "Error", "Failed to load experiments:\n" + experimentModel->lastError().text());
-        return;
-    }
+    experimentModel->setHorizontalHeaderLabels(
+        { "experiment_id", "experiment_code", "project_code", "created_by", "date_created" });
 
     ui->experimentTableView->setModel(experimentModel);
+    ui->experimentTableView->setEditTriggers(QAbstractItemView::NoEditTriggers);
     ui->experimentTableView->setSelectionBehavior(QAbstractItemView::SelectRows);
     ui->experimentTableView->setSelectionMode(QAbstractItemView::SingleSelection);
-    ui->experimentTableView->resizeColumnsToContents();
 
     connect(ui->experimentTableView->selectionModel(), &QItemSelectionModel::selectionChanged,
             this, &LoadExperimentDialog::onSelectionChanged);
+    connect(ui->experimentTableView->verticalScrollBar(), &QScrollBar::valueChanged,
+            this, &LoadExperimentDialog::onScrolled);
+    connect(ui->experimentTableView->verticalScrollBar(), &QScrollBar::rangeChanged,
+            this, &LoadExperimentDialog::onScrolled);
+
+    // Filters: re-query 300 ms after the last edit
+    debounceTimer->setSingleShot(true);
+    debounceTimer->setInterval(300);
+    connect(debounceTimer, &QTimer::timeout, this, &LoadExperimentDialog::refresh);
+
+    const QDate today = QDate::currentDate();
+    ui->fromDateEdit->setDate(today.addMonths(-1));
+    ui->toDateEdit->setDate(today);
+
+    for (QLineEdit *e : { ui->codeFilterEdit, ui->projectFilterEdit, ui->userFilterEdit,
+                          ui->compoundFilterEdit })
+        connect(e, &QLineEdit::textChanged, this, &LoadExperimentDialog::scheduleRefresh);
+    connect(ui->fromDateEdit, &QDateEdit::dateChanged, this, &LoadExperimentDialog::scheduleRefresh);
+    connect(ui->toDateEdit,   &QDateEdit::dateChanged, this, &LoadExperimentDialog::scheduleRefresh);
+    connect(ui->dateFilterCheckBox, &QCheckBox::toggled, this, [this](bool on) {
+        ui->fromDateEdit->setEnabled(on);
+        ui->toDateEdit->setEnabled(on);
+        scheduleRefresh();
+    });
+
+    refresh();
 }
 
 LoadExperimentDialog::~LoadExperimentDialog()
@@ -38,6 +58,108 @@ LoadExperimentDialog::~LoadExperimentDialog()
     delete ui;
 }
 
+ExperimentStore::Filter LoadExperimentDialog::currentFilter() const
+{
+    ExperimentStore::Filter f;
+    f.code     = ui->codeFilterEdit->text();
+    f.project  = ui->projectFilterEdit->text();
+    f.user     = ui->userFilterEdit->text();
+    f.compound = ui->compoundFilterEdit->text();
+    if (ui->dateFilterCheckBox->isChecked()) {
+        f.from = ui->fromDateEdit->date();
+        f.to   = ui->toDateEdit->date();
+    }
+    return f;
+}
+
+void LoadExperimentDialog::scheduleRefresh()
+{
+    debounceTimer->start();
+}
+
+void LoadExperimentDialog::refresh()
+{
+    debounceTimer->stop();
+    ++generation_;                          // drops any pending prefetch
+
+    filter_          = currentFilter();
+    cursor_          = ExperimentStore::Cursor();
+    prefetchedReady_ = false;
+    prefetched_.clear();
+    experimentModel->removeRows(0, experimentModel->rowCount());
+    selectedId = -1;
+
+    QVector<ExperimentStore::Summary> page;
+    QString err;
+    if (!ExperimentStore::listPage(filter_, cursor_, kPageSize, page, &hasMore_, &err)) {
+        QMessageBox::critical(this, "Error", "Failed to load experiments:\n" + err);
+        hasMore_ = false;
+        updateStatus();
+        return;
+    }
+
+    appendRows(page);
+    ui->experimentTableView->resizeColumnsToContents();
+    prefetchNext();
+}
+
+void LoadExperimentDialog::appendRows(const QVector<ExperimentStore::Summary> &rows)
+{
+    for (const auto &s : rows) {
+        QList<QStandardItem*> row;
+        row << new QStandardItem(QString::number(s.experimentId))
+            << new QStandardItem(s.experimentCode)
+            << new QStandardItem(s.projectCode)
+            << new QStandardItem(s.createdBy)
+            << new QStandardItem(s.dateCreated.toString("yyyy-MM-dd HH:mm"));
+        experimentModel->appendRow(row);
+    }
+    if (!rows.isEmpty()) cursor_ = ExperimentStore::Cursor::after(rows.last());
+    updateStatus();
+}
+
+void LoadExperimentDialog::prefetchNext()
+{
+    if (!hasMore_) return;
+
+    // fetch the next page once the current one has been painted. The query
+    // still runs on the GUI thread (the default connection belongs to it):
+    // it only moves the wait from the scroll to just after the paint.
+    const int gen = generation_;
+    QTimer::singleShot(0, this, [this, gen] {
+        if (gen != generation_ || prefetchedReady_ || !hasMore_) return;
+        QString err;
+        if (!ExperimentStore::listPage(filter_, cursor_, kPageSize,
+                                       prefetched_, &prefetchedMore_, &err))
+            return;                         // retried on the next scroll
+        prefetchedReady_ = true;
+        onScrolled();                       // the list may already be at its end
+    });
+}
+
+void LoadExperimentDialog::onScrolled()
+{
+    const QScrollBar *bar = ui->experimentTableView->verticalScrollBar();
+    const bool atEnd = bar->maximum() == 0 || bar->value() >= bar->maximum() - bar->pageStep() / 2;
+    if (!atEnd || !hasMore_) return;
+
+    if (!prefetchedReady_) { prefetchNext(); return; }
+
+    const QVector<ExperimentStore::Summary> page = std::move(prefetched_);
+    prefetched_.clear();
+    prefetchedReady_ = false;
+    hasMore_ = prefetchedMore_;
+    appendRows(page);
+    prefetchNext();
+}
+
+void LoadExperimentDialog::updateStatus()
+{
+    ui->statusLabel->setText(hasMore_
+        ? QString("%1 experiments shown — scroll for more").arg(experimentModel->rowCount())
+        : QString("%1 experiments").arg(experimentModel->rowCount()));
+}
+
 void LoadExperimentDialog::onSelectionChanged()
 {
     QModelIndex index = ui->experimentTableView->currentIndex();
@@ -54,4 +176,21 @@ int LoadExperimentDialog::selectedExperimentId() const
 bool LoadExperimentDialog::isReadOnly() const
 {
     return ui->readOnlyCheckBox->isChecked();
-}
\ No newline at end of file
+}
+
+void LoadExperimentDialog::setMultiSelection(bool on)
+{
+    ui->experimentTableView->setSelectionMode(on ? QAbstractItemView::ExtendedSelection
+                                                 : QAbstractItemView::SingleSelection);
+    ui->readOnlyCheckBox->setVisible(!on);
+    setWindowTitle(on ? "Select Experiments" : "Load Experiment");
+}
+
+QList<int> LoadExperimentDialog::selectedExperimentIds() const
+{
+    QList<int> ids;
+    const auto rows = ui->experimentTableView->selectionModel()->selectedRows(0); // column 0 = experiment_id
+    for (const QModelIndex &idx : rows)
+        ids << experimentModel->data(idx).toInt();
+    return ids;
+}
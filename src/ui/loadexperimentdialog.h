@@ -2,12 +2,25 @@
 #define LOADEXPERIMENTDIALOG_H
 
 #include <QDialog>
-#include <QSqlQueryModel>
+#include <QVector>
+
+#include "tecan_integration/experimentstore.h"
+
+class QStandardItemModel;
+class QTimer;
 
 namespace Ui {
 class LoadExperimentDialog;
 }
 
+/**
+ * Experiment picker. Rows are loaded one page at a time (keyset on
+ * date_created / experiment_id, newest first) with the filters (code,
+ * project, user, compound, dates) applied by the server. The next page is
+ * queried right after a page is shown, synchronously on the GUI thread,
+ * and appended when the list is scrolled to the end. Filter edits are
+ * debounced.
+ */
 class LoadExperimentDialog : public QDialog
 {
     Q_OBJECT
@@ -19,13 +32,37 @@ public:
     int selectedExperimentId() const;
     bool isReadOnly() const;
 
+    /** Allow several rows to be picked (batch generation); hides read-only. */
+    void setMultiSelection(bool on);
+    QList<int> selectedExperimentIds() const;
+
 private slots:
     void onSelectionChanged();
+    void scheduleRefresh();
+    void refresh();
+    void onScrolled();
 
 private:
+    ExperimentStore::Filter currentFilter() const;
+    void appendRows(const QVector<ExperimentStore::Summary> &rows);
+    void prefetchNext();
+    void updateStatus();
+
+    static constexpr int kPageSize = 100;
+
     Ui::LoadExperimentDialog *ui;
-    QSqlQueryModel *experimentModel;
+    QStandardItemModel *experimentModel;
+    QTimer *debounceTimer;
     int selectedId = -1;
+
+    /* paging state */
+    ExperimentStore::Filter filter_;
+    ExperimentStore::Cursor cursor_;          // after the last appended row
+    bool hasMore_ = false;
+    QVector<ExperimentStore::Summary> prefetched_;
+    bool prefetchedReady_ = false;
+    bool prefetchedMore_  = false;
+    int  generation_      = 0;                // bumps on every refresh
 };
 
-#endif // LOADEXPERIMENTDIALOG_H
\ No newline at end of file
+#endif // LOADEXPERIMENTDIALOG_H